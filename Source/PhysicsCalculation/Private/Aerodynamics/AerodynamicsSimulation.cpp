@@ -3,6 +3,7 @@
 #include "Aerodynamics/AerodynamicsSimulation.h"
 #include "Aerodynamics/SideforceGenerator.h"
 #include "Common/PhysRigidBodyParams.h"
+#include "Common/PhysSimParams.h"
 #include "Common/PhysTransform.h"
 #include "Components/CustomPhysicsComponent.h"
 #include "Libs/PhysicsSimulation.h"
@@ -27,6 +28,14 @@ void UAerodynamicsSimulation::CalculateAerodynamicImpact(FPSI_Data& Data, FVecto
     }
 }
 
+void UAerodynamicsSimulation::CalculateExtraForcesImpact(FPSI_Data& Data, FVector& OutAngularVelocity, FVector& locationOffset)
+{
+    if(!Data.HasExtraForces()) return;
+    
+    const auto T = Data.GetTransform();
+    CalculateSideForceImpact(Data.GetDeltaTime(), Data.GetSkipTime(), Data.Obj->PhysicsParams.Aerodynamics, T, OutAngularVelocity, locationOffset);
+}
+
 FVector UAerodynamicsSimulation::CalculateAerodynamicForce(const FPhysRigidBodyParams& RbParams, const FVector& LinearVelocity, const FVector& AngularVelocity)
 {
     FVector AerodynamicForce = FVector::ZeroVector;
@@ -44,11 +53,10 @@ FVector UAerodynamicsSimulation::CalculateAerodynamicForce(const FPhysRigidBodyP
     const float CrossSectionArea = RbParams.GetSphericalCrossSectionArea();
     
     const float AirDensity = ADParams->AirDrag.GetAirDensityKgCm3();
-    const float DragCoefficient = ADParams->AirDrag.GetAirDragCoefficient(VelocityMagnitude);
-    const float LiftCoefficient = ADParams->AirDrag.GetLiftCoefficient(VelocityMagnitude);
+    const FVector Coefficients = ADParams->AirDrag.GetAirDragVector(VelocityMagnitude);
 
-    const float DragMul = ADParams->AirDragImpact.Value * DragCoefficient;
-    const float MagnusMul = ADParams->MagnusImpact.Value * LiftCoefficient;
+    const float DragMul = ADParams->AirDragImpact.Value * Coefficients.X;
+    const float MagnusMul = ADParams->MagnusImpact.Value * Coefficients.Y;
         
     if(bDrag)
     {
@@ -65,6 +73,32 @@ FVector UAerodynamicsSimulation::CalculateAerodynamicForce(const FPhysRigidBodyP
     return AerodynamicForce;
 }
 
+FVector UAerodynamicsSimulation::CalculateAerodynamicForce(const FPhysSimParams& SimParams, const FVector& LinearVelocity, const FVector& AngularVelocity)
+{
+    FVector AerodynamicForce = FVector::ZeroVector;
+    if(!SimParams.HasAerodynamics()) return AerodynamicForce;
+
+    // same as RbParams version with constant parts taken from SimParams
+    const float VelocityMagnitude = LinearVelocity.Size();
+    const FVector Coefficients = SimParams.AirDrag.GetAirDragVector(VelocityMagnitude);
+    
+    if(SimParams.bDrag && !FMath::IsNearlyZero(VelocityMagnitude, 0.1f))
+    {
+        AerodynamicForce -= (SimParams.DragFactor * Coefficients.X * VelocityMagnitude) * LinearVelocity;
+    }
+
+    if(SimParams.bMagnus)
+    {
+        const FVector Cross = LinearVelocity ^ AngularVelocity;
+        if(!FMath::IsNearlyZero(Cross.Size(), 0.1f))
+        {
+            AerodynamicForce += (SimParams.LiftFactor * Coefficients.Y) * Cross;
+        }
+    }
+
+    return AerodynamicForce;
+}
+
 FVector UAerodynamicsSimulation::ComputeSphereAirDragForce(float CrossSectionArea, float AirDensity, FVector LinearVelocity)
 {
     const float Vm = LinearVelocity.Size();
@@ -90,9 +124,14 @@ FVector UAerodynamicsSimulation::ComputeSphereLiftForceIdeal(float Radius, float
     const FVector Cross = LinearVelocity ^ AngularVelocity;
     if(FMath::IsNearlyZero(Cross.Size(), 0.1f)) return  FVector::ZeroVector;
     
+    return  GetSphereLiftFactor(Radius, AirDensity) * Cross;
+}
+
+float UAerodynamicsSimulation::GetSphereLiftFactor(float Radius, float AirDensity)
+{
     constexpr float ConstCf = 16.0f * Pi * Pi * RadToTurn / 3.0f;
     const float VarCf = AirDensity * Radius * Radius * Radius;
-    return  ConstCf * VarCf * Cross;
+    return ConstCf * VarCf;
 }
 
 FVector UAerodynamicsSimulation::GetOffsetToApplyWithTimeSkip(FSideforceBaseGenerator& S, FVector ForwardVector, FVector RightVector, FVector UpVector,
@@ -0,0 +1,150 @@
+﻿#include "Collision/CollisionBroadphase.h"
+#include "Components/CustomPhysicsBaseComponent.h"
+
+void FCollisionBroadphase::Reset()
+{
+    Objects.Reset();
+    Boxes.Reset();
+    OversizedObjects.Reset();
+    Cells.Reset();
+}
+
+void FCollisionBroadphase::Update(const TArray<UCustomPhysicsBaseComponent*>& SimplifiedObjects, float InCellSize)
+{
+    // compared with stored value, so cell sizes below the limit do not rebuild grid every update
+    const float NewCellSize = FMath::Max(InCellSize, 1.0f);
+    const bool bRebuild = Objects != SimplifiedObjects || !FMath::IsNearlyEqual(CellSize, NewCellSize);
+    if(bRebuild)
+    {
+        Reset();
+        NumRebuilds++;
+        CellSize = NewCellSize;
+        Objects = SimplifiedObjects;
+        Boxes.Reserve(Objects.Num());
+        for (int i = 0; i < Objects.Num(); ++i)
+        {
+            Boxes.Add(GetObjectBox(Objects[i]));
+            Insert(i);
+        }
+        return;
+    }
+
+    for (int i = 0; i < Objects.Num(); ++i)
+    {
+        const FBox Box = GetObjectBox(Objects[i]);
+        if(Box.Equals(Boxes[i])) continue;
+
+        Remove(i);
+        Boxes[i] = Box;
+        Insert(i);
+    }
+}
+
+void FCollisionBroadphase::Query(const FBox& Box, TArray<int>& OutIndices) const
+{
+    OutIndices.Reset();
+    
+    for (const int Index : OversizedObjects)
+    {
+        if(Boxes[Index].Intersect(Box)) OutIndices.Add(Index);
+    }
+
+    FIntVector Min, Max;
+    GetCellRange(Box, Min, Max);
+    
+    for (int x = Min.X; x <= Max.X; ++x)
+    {
+        for (int y = Min.Y; y <= Max.Y; ++y)
+        {
+            for (int z = Min.Z; z <= Max.Z; ++z)
+            {
+                const auto Cell = Cells.Find(FIntVector(x, y, z));
+                if(!Cell) continue;
+                
+                for (const int Index : *Cell)
+                {
+                    if(Boxes[Index].Intersect(Box)) OutIndices.Add(Index);
+                }
+            }
+        }
+    }
+
+    // keep narrow phase order the same as in brute force test
+    OutIndices.Sort();
+    for (int i = OutIndices.Num() - 1; i > 0; --i)
+    {
+        if(OutIndices[i] == OutIndices[i - 1]) OutIndices.RemoveAt(i, 1, false);
+    }
+}
+
+FBox FCollisionBroadphase::GetObjectBox(const UCustomPhysicsBaseComponent* Obj)
+{
+    const auto P = Obj ? Obj->GetPrimitiveComponent() : nullptr;
+    return P ? P->Bounds.GetBox() : FBox(ForceInit);
+}
+
+void FCollisionBroadphase::GetCellRange(const FBox& Box, FIntVector& OutMin, FIntVector& OutMax) const
+{
+    const float CellSizeInv = 1.0f / CellSize;
+    OutMin = FIntVector(FMath::FloorToInt(Box.Min.X * CellSizeInv), FMath::FloorToInt(Box.Min.Y * CellSizeInv), FMath::FloorToInt(Box.Min.Z * CellSizeInv));
+    OutMax = FIntVector(FMath::FloorToInt(Box.Max.X * CellSizeInv), FMath::FloorToInt(Box.Max.Y * CellSizeInv), FMath::FloorToInt(Box.Max.Z * CellSizeInv));
+}
+
+int FCollisionBroadphase::GetNumCells(const FIntVector& Min, const FIntVector& Max)
+{
+    const int64 Num = static_cast<int64>(Max.X - Min.X + 1) * (Max.Y - Min.Y + 1) * (Max.Z - Min.Z + 1);
+    return static_cast<int>(FMath::Min<int64>(Num, MAX_int32));
+}
+
+void FCollisionBroadphase::Insert(int Index)
+{
+    const FBox& Box = Boxes[Index];
+    if(!Box.IsValid) return;
+    
+    FIntVector Min, Max;
+    GetCellRange(Box, Min, Max);
+    
+    if(GetNumCells(Min, Max) > MaxCellsPerObject)
+    {
+        OversizedObjects.Add(Index);
+        return;
+    }
+    
+    for (int x = Min.X; x <= Max.X; ++x)
+    {
+        for (int y = Min.Y; y <= Max.Y; ++y)
+        {
+            for (int z = Min.Z; z <= Max.Z; ++z)
+            {
+                Cells.FindOrAdd(FIntVector(x, y, z)).Add(Index);
+            }
+        }
+    }
+}
+
+void FCollisionBroadphase::Remove(int Index)
+{
+    const FBox& Box = Boxes[Index];
+    if(!Box.IsValid) return;
+    
+    if(OversizedObjects.Remove(Index) > 0) return;
+    
+    FIntVector Min, Max;
+    GetCellRange(Box, Min, Max);
+    
+    for (int x = Min.X; x <= Max.X; ++x)
+    {
+        for (int y = Min.Y; y <= Max.Y; ++y)
+        {
+            for (int z = Min.Z; z <= Max.Z; ++z)
+            {
+                const FIntVector Key(x, y, z);
+                auto Cell = Cells.Find(Key);
+                if(!Cell) continue;
+                
+                Cell->RemoveSingleSwap(Index, false);
+                if(Cell->Num() == 0) Cells.Remove(Key);
+            }
+        }
+    }
+}
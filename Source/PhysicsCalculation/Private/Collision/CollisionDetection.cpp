@@ -2,6 +2,7 @@
 
 #include "Collision/CollisionDetection.h"
 
+#include "Collision/CollisionBroadphase.h"
 #include "Collision/CollisionPair.h"
 #include "constants.h"
 #include "Components/CustomPhysicsComponent.h"
@@ -21,17 +22,31 @@ bool UCollisionDetection::DetectCollisionAgainstSphere(UPrimitiveComponent* PC,
     return  false;
 }
 
+bool UCollisionDetection::DetectCollisionAgainstSphere(const UCustomPhysicsBaseComponent* Obj, const FVector& SLocation, float SRadius,
+                                                       FVector& CollisionPointPC, float& Penetration)
+{
+    if(!Obj) return false;
+    
+    const auto& Snapshot = Obj->GetCollisionSnapshot();
+    if(Snapshot.IsValid())
+    {
+        const float CollisionDistance = Snapshot.GetClosestPoint(SLocation, CollisionPointPC);
+        if(CollisionDistance < 0.0f) return false;
+        Penetration = SRadius - CollisionDistance;
+        return Penetration > 0;
+    }
+    return DetectCollisionAgainstSphere(Obj->GetPrimitiveComponent(), SLocation, SRadius, CollisionPointPC, Penetration);
+}
+
 bool UCollisionDetection::TestCustomCollisionAgainstSphere(UCustomPhysicsBaseComponent* ObjA, UCustomPhysicsComponent* ObjB,
     FCollisionPair& CollisionPair)
 {
     if(!ObjA || !ObjB) return false;
     
-    const auto PA = ObjA->GetPrimitiveComponent();
-
     const FVector SphereLocation = ObjB->GetCurrentLocation();
     const float SphereRadius = ObjB->GetRadius();
 	
-    if(DetectCollisionAgainstSphere(PA, SphereLocation, SphereRadius, CollisionPair.CollisionPoint, CollisionPair.Penetration))
+    if(DetectCollisionAgainstSphere(ObjA, SphereLocation, SphereRadius, CollisionPair.CollisionPoint, CollisionPair.Penetration))
     {
         CollisionPair.ObjA = ObjA;
         CollisionPair.ObjB = ObjB;
@@ -67,6 +82,39 @@ bool UCollisionDetection::FindCollisionsAgainstSphereArray(const TArray<UCustomP
     return  CollisionPairs.Num() > 0;
 }
 
+bool UCollisionDetection::FindCollisionsAgainstSphereArray(const TArray<UCustomPhysicsComponent*>& FullObjects, const FCollisionBroadphase& Broadphase,
+                                                           TArray<FCollisionPair>& CollisionPairs)
+{
+    TArray<int> Candidates;
+    return FindCollisionsAgainstSphereArray(FullObjects, Broadphase, CollisionPairs, Candidates);
+}
+
+bool UCollisionDetection::FindCollisionsAgainstSphereArray(const TArray<UCustomPhysicsComponent*>& FullObjects, const FCollisionBroadphase& Broadphase,
+                                                           TArray<FCollisionPair>& CollisionPairs, TArray<int>& Candidates)
+{
+    for (const auto FullObj : FullObjects)
+    {
+        if(!FullObj) continue;
+
+        const FVector SphereLocation = FullObj->GetCurrentLocation();
+        const FBox SphereBox = FBox::BuildAABB(SphereLocation, FVector(FullObj->GetRadius()));
+        Broadphase.Query(SphereBox, Candidates);
+        
+        for (const int Index : Candidates)
+        {
+            const auto SimpleObj = Broadphase.GetObject(Index);
+            if(!SimpleObj) continue;
+
+            FCollisionPair CollisionPair;
+            if(TestCustomCollisionAgainstSphere(SimpleObj, FullObj, CollisionPair))
+            {
+                CollisionPairs.Add(CollisionPair);
+            }
+        }
+    }
+    return  CollisionPairs.Num() > 0;
+}
+
 bool UCollisionDetection::FindCollisionAgainstSpherePredictMode(FVector SphereLocation, UCustomPhysicsComponent* Obj,
                                                                 const TArray<UCustomPhysicsBaseComponent*>& StaticObjects,
                                                                 TArray<FCollisionPair>& CollisionPairs)
@@ -79,11 +127,9 @@ bool UCollisionDetection::FindCollisionAgainstSpherePredictMode(FVector SphereLo
     {
         if(!StaticObj) continue;
 
-        const auto P = StaticObj->GetPrimitiveComponent();
-        
         FCollisionPair CollisionPair;
 
-        if(DetectCollisionAgainstSphere(P, SphereLocation, Radius, CollisionPair.CollisionPoint, CollisionPair.Penetration))
+        if(DetectCollisionAgainstSphere(StaticObj, SphereLocation, Radius, CollisionPair.CollisionPoint, CollisionPair.Penetration))
         {
             CollisionPair.ObjA = StaticObj;
             CollisionPair.ObjB = Obj;
@@ -100,40 +146,122 @@ bool UCollisionDetection::FindFirstCollisionAgainstSphere(FVector StartLocation,
     Alpha = 1.0f;
 
     const float Radius = Obj->GetRadius();
-    const float Offset = TunnelingDetectionSphereRadiusMul * Radius; 
-
     const FVector DeltaLocation = EndLocation - StartLocation;
-    const FVector Dir = DeltaLocation.GetSafeNormal();
-    const float Distance = DeltaLocation.Size();
 
-    int NumSteps = 0;
-    const float LeftOver = UHM::SplitFloatsIntWithLeftOver(Distance, NumSteps, Offset);
+    bool bFound = false;
+    
+    for (const auto StaticObj : StaticObjects)
+    {
+        if(!StaticObj) continue;
+
+        float HitAlpha;
+        FVector Normal;
+        
+        const auto& Snapshot = StaticObj->GetCollisionSnapshot();
+        const bool bHit = Snapshot.IsValid()
+                              ? Snapshot.SweepSphere(StartLocation, DeltaLocation, Radius, HitAlpha, Normal)
+                              : FindFirstCollisionAgainstSphereStepped(StartLocation, EndLocation, Radius, StaticObj, HitAlpha, Normal);
+        // swept contact has no penetration, so it is validated here by its normal
+        if(!bHit || Normal.IsNearlyZero() || (bFound && HitAlpha >= Alpha)) continue;
+
+        bFound = true;
+        Alpha = HitAlpha;
+        SphereLocation = StartLocation + DeltaLocation * Alpha;
+        
+        Collision.ObjA = StaticObj;
+        Collision.ObjB = Obj;
+        Collision.CollisionNormal = Normal;
+        Collision.CollisionPoint = SphereLocation - Normal * Radius;
+        Collision.Penetration = 0.0f;
+    }
+
+    return bFound;
+}
 
-    TArray<FCollisionPair> CollisionPairs;
+bool UCollisionDetection::FindFirstCollisionAgainstSphereStepped(const FVector& StartLocation, const FVector& EndLocation, float Radius,
+    const UCustomPhysicsBaseComponent* StaticObj, float& Alpha, FVector& Normal)
+{
+    // no analytic shapes - sphere is sampled along the way with overlapping steps
     
-    for (int i = 0; i < NumSteps; ++i)
+    const float Offset = TunnelingDetectionSphereRadiusMul * Radius;
+    const FVector DeltaLocation = EndLocation - StartLocation;
+    const int NumSteps = FMath::Max(1, FMath::CeilToInt(DeltaLocation.Size() / Offset));
+
+    for (int i = 1; i <= NumSteps; ++i)
     {
-        const float AddDistance = i * Offset;
-        SphereLocation = StartLocation + AddDistance * Dir;
-        if(FindCollisionAgainstSpherePredictMode(SphereLocation, Obj, StaticObjects, CollisionPairs))
+        const float StepAlpha = static_cast<float>(i) / NumSteps;
+        const FVector SphereLocation = StartLocation + DeltaLocation * StepAlpha;
+        
+        FVector CollisionPoint;
+        float Penetration;
+        if(DetectCollisionAgainstSphere(StaticObj, SphereLocation, Radius, CollisionPoint, Penetration))
         {
-            Alpha = AddDistance / Distance;
-            Collision = CollisionPairs[0];
+            Alpha = StepAlpha;
+            Normal = (SphereLocation - CollisionPoint).GetSafeNormal();
             return true;
         }
     }
+    return false;
+}
+
+bool UCollisionDetection::SweepSpherePredictMode(const FPSI_Data& Data, const FPhysTransform& T, const FPhysTransform& TNext,
+    const TArray<UCustomPhysicsBaseComponent*>& StaticObjects, FPhysTransform& OutT)
+{
+    const auto Obj = Data.Obj;
+    OutT = TNext;
+    
+    // slow sphere can not pass through anything between two discrete checks
+    const float MaxStep = TunnelingDetectionSphereRadiusMul * Obj->GetRadius();
+    FPhysTransform TStart = T;
+    FPSI_Data Rest = Data;
+    bool bHit = false;
 
-    if (LeftOver > 0)
+    for (int i = 0; i < MaxSweepContactsPerStep; ++i)
     {
-        if(FindCollisionAgainstSpherePredictMode(EndLocation, Obj, StaticObjects, CollisionPairs))
-        {
-            SphereLocation = EndLocation;
-            Collision = CollisionPairs[0];
-            return true;
-        }
+        if(FVector::DistSquared(TStart.Location, OutT.Location) <= MaxStep * MaxStep) break;
+        
+        FCollisionPair Collision;
+        FVector SphereLocation;
+        float Alpha;
+        if(!FindFirstCollisionAgainstSphere(TStart.Location, OutT.Location, Obj, StaticObjects, Collision, SphereLocation, Alpha)) break;
+
+        // resolve collision at contact instant
+        FPhysTransform TContact = UPhysicsUtils::TLerp(TStart, OutT, Alpha);
+        TContact.Location = SphereLocation;
+        FPhysTransform TResolved;
+        ResolveContactAgainstSpherePredictMode(TContact, Collision, TResolved);
+        bHit = true;
+
+        // and move for the rest of the step; rest after the last contact is dropped
+        OutT = TResolved;
+        if(i + 1 == MaxSweepContactsPerStep) break;
+        
+        Rest.SetTransform(TResolved);
+        Rest.SetDeltaTime(Rest.GetDeltaTime() * (1.0f - Alpha));
+        if(Rest.GetDeltaTime() <= KINDA_SMALL_NUMBER) break;
+        UPhysicsSimulation::PhysicsSimulateDelta(Rest, OutT);
+        TStart = TResolved;
     }
+    return bHit;
+}
 
-    return false;
+bool UCollisionDetection::SweepSpherePredictMode(const FPSI_Data& Data, const FPhysTransform& T, const FPhysTransform& TNext, const FCollisionBroadphase& Broadphase,
+    TArray<int>& Candidates, TArray<UCustomPhysicsBaseComponent*>& StaticObjects, FPhysTransform& OutT)
+{
+    OutT = TNext;
+    StaticObjects.Reset();
+    
+    const float Radius = Data.Obj->GetRadius();
+    const float Distance = FVector::Dist(T.Location, TNext.Location);
+    if(Distance <= TunnelingDetectionSphereRadiusMul * Radius) return false;
+
+    // rest of the step after contact is not longer than the step itself, whatever direction it takes
+    Broadphase.Query(FBox::BuildAABB(T.Location, FVector(Distance + Radius)), Candidates);
+    for (const int Index : Candidates)
+    {
+        StaticObjects.Add(Broadphase.GetObject(Index));
+    }
+    return SweepSpherePredictMode(Data, T, TNext, StaticObjects, OutT);
 }
 
 void UCollisionDetection::ResolveCustomCollisionAgainstSphere(const FCollisionPair& CollisionPair)
@@ -177,7 +305,11 @@ void UCollisionDetection::ResolveCustomCollisionAgainstSphere(const FCollisionPa
 void UCollisionDetection::ResolveCustomCollisionAgainstSpherePredictMode(const FPhysTransform& T, const FCollisionPair& CollisionPair, FPhysTransform& OutT)
 {
     if(!CollisionPair.IsValid()) return;
+    ResolveContactAgainstSpherePredictMode(T, CollisionPair, OutT);
+}
 
+void UCollisionDetection::ResolveContactAgainstSpherePredictMode(const FPhysTransform& T, const FCollisionPair& CollisionPair, FPhysTransform& OutT)
+{
     OutT = T;
 
     const auto ObjA = CollisionPair.ObjA;
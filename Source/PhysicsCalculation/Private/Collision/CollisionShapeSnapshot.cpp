@@ -0,0 +1,242 @@
+﻿#include "Collision/CollisionShapeSnapshot.h"
+#include "Components/PrimitiveComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+
+void FCollisionShapeSnapshot::Update(const UPrimitiveComponent* P)
+{
+    if(!P)
+    {
+        Reset();
+        return;
+    }
+    
+    const FTransform& T = P->GetComponentTransform();
+    if(Source == P && SourceTransform.Equals(T)) return;
+
+    Source = P;
+    SourceTransform = T;
+    bValid = Build(P);
+}
+
+bool FCollisionShapeSnapshot::Build(const UPrimitiveComponent* P)
+{
+    Shapes.Reset();
+    
+    // no shapes - nothing to collide with
+    if(P->GetCollisionEnabled() == ECollisionEnabled::NoCollision) return true;
+    
+    const auto BodySetup = P->GetBodySetup();
+    if(!BodySetup) return false;
+
+    const auto& Geom = BodySetup->AggGeom;
+    const bool bHasOtherElements = Geom.ConvexElems.Num() > 0 || Geom.TaperedCapsuleElems.Num() > 0;
+    if(bHasOtherElements) return false;
+
+    const FTransform& T = SourceTransform;
+    const FVector Scale = T.GetScale3D().GetAbs();
+    const float MinScale = Scale.GetMin();
+    
+    for (const auto& Elem : Geom.SphereElems)
+    {
+        FAnalyticCollisionShape S;
+        S.Type = EAnalyticShapeType::Sphere;
+        S.Center = T.TransformPosition(Elem.Center);
+        S.Radius = Elem.Radius * MinScale;
+        Shapes.Add(S);
+    }
+
+    for (const auto& Elem : Geom.BoxElems)
+    {
+        FAnalyticCollisionShape S;
+        S.Type = EAnalyticShapeType::Box;
+        S.Center = T.TransformPosition(Elem.Center);
+        S.Rotation = T.GetRotation() * Elem.Rotation.Quaternion();
+        S.Extent = 0.5f * FVector(Elem.X, Elem.Y, Elem.Z) * Scale;
+        Shapes.Add(S);
+    }
+
+    for (const auto& Elem : Geom.SphylElems)
+    {
+        FAnalyticCollisionShape S;
+        S.Type = EAnalyticShapeType::Capsule;
+        S.Center = T.TransformPosition(Elem.Center);
+        S.Rotation = T.GetRotation() * Elem.Rotation.Quaternion();
+        S.Radius = Elem.Radius * FMath::Min(Scale.X, Scale.Y);
+        S.HalfLength = 0.5f * Elem.Length * Scale.Z;
+        Shapes.Add(S);
+    }
+    
+    return Shapes.Num() > 0;
+}
+
+bool FAnalyticCollisionShape::SweepSphere(const FVector& Start, const FVector& Delta, float SphereRadius, float& OutAlpha, FVector& OutNormal) const
+{
+    FVector Closest;
+    if(GetClosestPoint(Start, Closest) <= SphereRadius) return false;
+
+    bool bHit;
+    switch (Type)
+    {
+    case EAnalyticShapeType::Box:
+        bHit = SweepSphereBox(Start, Delta, SphereRadius, OutAlpha, OutNormal);
+        break;
+    case EAnalyticShapeType::Capsule:
+        {
+            const FVector Segment = Rotation.GetAxisZ() * HalfLength;
+            bHit = SweepPointCapsule(Start, Delta, Center - Segment, Center + Segment, Radius + SphereRadius, OutAlpha, OutNormal);
+            break;
+        }
+    default:
+        bHit = SweepPointSphere(Start, Delta, Center, Radius + SphereRadius, OutAlpha, OutNormal);
+    }
+
+    // tangent contact does not change motion
+    return bHit && (Delta | OutNormal) < 0.0f;
+}
+
+bool FAnalyticCollisionShape::SweepPointSphere(const FVector& Start, const FVector& Delta, const FVector& SphereCenter, float SphereRadius,
+                                               float& OutT, FVector& OutNormal)
+{
+    const float A = Delta | Delta;
+    if(A <= SMALL_NUMBER) return false;
+
+    const FVector M = Start - SphereCenter;
+    const float B = M | Delta;
+    const float C = (M | M) - SphereRadius * SphereRadius;
+    const float Discriminant = B * B - A * C;
+    if(Discriminant < 0.0f) return false;
+
+    const float T = (-B - FMath::Sqrt(Discriminant)) / A;
+    if(T < 0.0f || T > 1.0f) return false;
+
+    OutT = T;
+    OutNormal = (M + Delta * T).GetSafeNormal();
+    return true;
+}
+
+bool FAnalyticCollisionShape::SweepPointCapsule(const FVector& Start, const FVector& Delta, const FVector& A, const FVector& B, float CapsuleRadius,
+                                                float& OutT, FVector& OutNormal)
+{
+    bool bHit = false;
+
+    // cylinder side
+    const FVector Segment = B - A;
+    const float Length = Segment.Size();
+    if(Length > KINDA_SMALL_NUMBER)
+    {
+        const FVector Axis = Segment / Length;
+        const FVector M = Start - A;
+        const FVector MPerp = M - Axis * (M | Axis);
+        const FVector DPerp = Delta - Axis * (Delta | Axis);
+
+        const float QA = DPerp | DPerp;
+        const float QB = MPerp | DPerp;
+        const float QC = (MPerp | MPerp) - CapsuleRadius * CapsuleRadius;
+        const float Discriminant = QB * QB - QA * QC;
+        if(QA > SMALL_NUMBER && Discriminant >= 0.0f)
+        {
+            const float T = (-QB - FMath::Sqrt(Discriminant)) / QA;
+            const float S = (M + Delta * T) | Axis;
+            if(T >= 0.0f && T <= 1.0f && S >= 0.0f && S <= Length)
+            {
+                bHit = true;
+                OutT = T;
+                OutNormal = (MPerp + DPerp * T).GetSafeNormal();
+            }
+        }
+    }
+
+    // caps; hit inside of cylinder is always later than cylinder hit
+    for (const FVector& CapCenter : {A, B})
+    {
+        float T;
+        FVector Normal;
+        if(SweepPointSphere(Start, Delta, CapCenter, CapsuleRadius, T, Normal) && (!bHit || T < OutT))
+        {
+            bHit = true;
+            OutT = T;
+            OutNormal = Normal;
+        }
+    }
+    return bHit;
+}
+
+bool FAnalyticCollisionShape::SweepSphereBox(const FVector& Start, const FVector& Delta, float SphereRadius, float& OutT, FVector& OutNormal) const
+{
+    const FVector LocalStart = Rotation.UnrotateVector(Start - Center);
+    const FVector LocalDelta = Rotation.UnrotateVector(Delta);
+    const FVector Inflated = Extent + FVector(SphereRadius);
+
+    // slab test against box inflated by sphere radius; rounded box lies inside of it
+    float TEnter = 0.0f;
+    float TExit = 1.0f;
+    int EnterAxis = INDEX_NONE;
+    for (int i = 0; i < 3; ++i)
+    {
+        if(FMath::Abs(LocalDelta[i]) < SMALL_NUMBER)
+        {
+            if(FMath::Abs(LocalStart[i]) > Inflated[i]) return false;
+            continue;
+        }
+        float T0 = (-Inflated[i] - LocalStart[i]) / LocalDelta[i];
+        float T1 = (Inflated[i] - LocalStart[i]) / LocalDelta[i];
+        if(T0 > T1) Swap(T0, T1);
+        if(T0 > TEnter)
+        {
+            TEnter = T0;
+            EnterAxis = i;
+        }
+        TExit = FMath::Min(TExit, T1);
+        if(TEnter > TExit) return false;
+    }
+
+    FVector LocalNormal = FVector::ZeroVector;
+    bool bHit = false;
+
+    // face hit if entry point projects onto face
+    if(EnterAxis != INDEX_NONE)
+    {
+        const FVector P = LocalStart + LocalDelta * TEnter;
+        const int J = (EnterAxis + 1) % 3;
+        const int K = (EnterAxis + 2) % 3;
+        if(FMath::Abs(P[J]) <= Extent[J] && FMath::Abs(P[K]) <= Extent[K])
+        {
+            bHit = true;
+            OutT = TEnter;
+            LocalNormal[EnterAxis] = FMath::Sign(P[EnterAxis]);
+        }
+    }
+
+    // otherwise first contact is on edge or corner
+    if(!bHit)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            const int J = (i + 1) % 3;
+            const int K = (i + 2) % 3;
+            for (const float SignJ : {-1.0f, 1.0f})
+            {
+                for (const float SignK : {-1.0f, 1.0f})
+                {
+                    FVector EdgeA, EdgeB;
+                    EdgeA[i] = -Extent[i];
+                    EdgeB[i] = Extent[i];
+                    EdgeA[J] = EdgeB[J] = SignJ * Extent[J];
+                    EdgeA[K] = EdgeB[K] = SignK * Extent[K];
+
+                    float T;
+                    FVector Normal;
+                    if(SweepPointCapsule(LocalStart, LocalDelta, EdgeA, EdgeB, SphereRadius, T, Normal) && (!bHit || T < OutT))
+                    {
+                        bHit = true;
+                        OutT = T;
+                        LocalNormal = Normal;
+                    }
+                }
+            }
+        }
+    }
+
+    if(bHit) OutNormal = Rotation.RotateVector(LocalNormal);
+    return bHit;
+}
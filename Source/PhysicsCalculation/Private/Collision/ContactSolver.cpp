@@ -0,0 +1,214 @@
+﻿#include "Collision/ContactSolver.h"
+#include "constants.h"
+#include "Collision/CollisionPair.h"
+#include "Libs/PhysicsSimulation.h"
+#include "Libs/PhysicsUtils.h"
+
+void FContactSolverBody::ApplyImpulse(const FVector& Impulse, const FVector& P)
+{
+    const FVector AngularImpulseAdd = (P - Location) ^ Impulse;
+    
+    LinearVelocity += Impulse * MassInv;
+    AngularVelocity += InertiaInv.MultiplyByVector(AngularImpulseAdd);
+    LinearImpulse += Impulse;
+    AngularImpulse += AngularImpulseAdd;
+}
+
+void FContactSolver::Solve(const TArray<FCollisionPair>& Pairs)
+{
+    Reset();
+    for (const auto& Pair : Pairs)
+    {
+        AddContact(Pair);
+    }
+    if(Contacts.Num() == 0)
+    {
+        Cache.Reset();
+        return;
+    }
+    
+    SolveContacts();
+
+    constexpr bool bRecomputePredict = false;
+    
+    for (const auto& Body : Bodies)
+    {
+        if(!Body.SeparationOffset.IsNearlyZero()) Body.Obj->AddWorldLocation(Body.SeparationOffset, bRecomputePredict);
+        if(!Body.LinearImpulse.IsNearlyZero()) Body.Obj->AddLinearImpulse(Body.LinearImpulse, bRecomputePredict);
+        if(!Body.AngularImpulse.IsNearlyZero()) Body.Obj->AddAngularImpulse(Body.AngularImpulse, bRecomputePredict);
+    }
+}
+
+void FContactSolver::Reset()
+{
+    Bodies.Reset();
+    Contacts.Reset();
+}
+
+int FContactSolver::FindOrAddBody(UCustomPhysicsBaseComponent* Obj)
+{
+    const int Index = Bodies.IndexOfByPredicate([Obj](const FContactSolverBody& Body){return Body.Obj == Obj;});
+    if(Index != INDEX_NONE) return Index;
+
+    FContactSolverBody Body;
+    Body.Obj = Obj;
+    Body.Location = Obj->GetCurrentLocation();
+    Body.LinearVelocity = Obj->GetCurrentLinearVelocity();
+    Body.AngularVelocity = Obj->GetCurrentAngularVelocityRadians();
+    Body.MassInv = Obj->GetMassInv();
+    Body.InertiaInv = Obj->GetInertiaTensorInverted();
+    return AddBody(Body);
+}
+
+void FContactSolver::AddContact(const FCollisionPair& Pair)
+{
+    if(!Pair.IsValid()) return;
+
+    const auto ObjA = Pair.ObjA;
+    const auto ObjB = Pair.ObjB;
+    const float Friction = UPhysicsUtils::GetFrictionFromBodies(ObjA, ObjB, ObjB->GetFrictionCombineMode());
+    const float Restitution = UPhysicsUtils::GetRestitutionFromBodies(ObjA, ObjB);
+    
+    AddContact(FindOrAddBody(ObjA), FindOrAddBody(ObjB), Pair.CollisionPoint, Pair.CollisionNormal, Pair.Penetration, Friction, Restitution);
+}
+
+void FContactSolver::AddContact(int BodyA, int BodyB, const FVector& Point, const FVector& Normal, float Penetration, float Friction, float Restitution)
+{
+    FContactSolverContact C;
+    C.BodyA = BodyA;
+    C.BodyB = BodyB;
+    C.Point = Point;
+    C.Normal = Normal;
+    C.Penetration = Penetration;
+    C.Friction = Friction;
+    Normal.FindBestAxisVectors(C.TangentU, C.TangentV);
+
+    const float MassN = GetEffectiveMass(C, C.Normal);
+    const float MassU = GetEffectiveMass(C, C.TangentU);
+    const float MassV = GetEffectiveMass(C, C.TangentV);
+    C.NormalMass = FMath::IsNearlyZero(MassN) ? 0.0f : 1.0f / MassN;
+    C.TangentMassU = FMath::IsNearlyZero(MassU) ? 0.0f : 1.0f / MassU;
+    C.TangentMassV = FMath::IsNearlyZero(MassV) ? 0.0f : 1.0f / MassV;
+
+    // target is taken before any impulse of this substep is applied
+    const float NormalVelocity = GetRelativeVelocity(C, C.Normal);
+    C.TargetVelocity = NormalVelocity < -RestitutionVelocityThreshold ? -Restitution * NormalVelocity : 0.0f;
+    
+    Contacts.Add(C);
+}
+
+void FContactSolver::SolveContacts()
+{
+    if(bWarmStart) WarmStart();
+    SolveVelocities();
+    if(bWarmStart) StoreImpulses();
+    else Cache.Reset();
+    SeparateBodies();
+}
+
+void FContactSolver::WarmStart()
+{
+    for (auto& C : Contacts)
+    {
+        const auto ObjA = Bodies[C.BodyA].Obj;
+        const auto ObjB = Bodies[C.BodyB].Obj;
+        
+        const auto Cached = Cache.FindByPredicate([&](const FContactSolverCachedImpulse& Item)
+        {
+            return Item.ObjA == ObjA && Item.ObjB == ObjB && (Item.Normal | C.Normal) >= WarmStartMinNormalDot &&
+                   FVector::DistSquared(Item.Point, C.Point) <= WarmStartMaxPointShift * WarmStartMaxPointShift;
+        });
+        if(!Cached) continue;
+
+        C.NormalImpulse = Cached->NormalImpulse;
+        C.TangentImpulse = FVector2D(Cached->TangentImpulse | C.TangentU, Cached->TangentImpulse | C.TangentV);
+        C.TangentImpulse = C.TangentImpulse.GetSafeNormal() * FMath::Min(C.TangentImpulse.Size(), C.Friction * C.NormalImpulse);
+
+        ApplyContactImpulse(C, C.Normal * C.NormalImpulse + C.TangentU * C.TangentImpulse.X + C.TangentV * C.TangentImpulse.Y);
+    }
+}
+
+void FContactSolver::SolveVelocities()
+{
+    for (int Iteration = 0; Iteration < NumIterations; ++Iteration)
+    {
+        for (auto& C : Contacts)
+        {
+            // friction inside of cone given by current normal impulse
+            const FVector2D TangentVelocity = FVector2D(GetRelativeVelocity(C, C.TangentU), GetRelativeVelocity(C, C.TangentV));
+            const FVector2D OldTangentImpulse = C.TangentImpulse;
+            C.TangentImpulse += FVector2D(-TangentVelocity.X * C.TangentMassU, -TangentVelocity.Y * C.TangentMassV);
+            
+            const float MaxTangentImpulse = C.Friction * C.NormalImpulse;
+            if(C.TangentImpulse.SizeSquared() > MaxTangentImpulse * MaxTangentImpulse)
+            {
+                C.TangentImpulse = C.TangentImpulse.GetSafeNormal() * MaxTangentImpulse;
+            }
+            const FVector2D DeltaTangentImpulse = C.TangentImpulse - OldTangentImpulse;
+            ApplyContactImpulse(C, C.TangentU * DeltaTangentImpulse.X + C.TangentV * DeltaTangentImpulse.Y);
+
+            // accumulated normal impulse may only push
+            const float NormalVelocity = GetRelativeVelocity(C, C.Normal);
+            const float OldNormalImpulse = C.NormalImpulse;
+            C.NormalImpulse = FMath::Max(0.0f, OldNormalImpulse - (NormalVelocity - C.TargetVelocity) * C.NormalMass);
+            ApplyContactImpulse(C, C.Normal * (C.NormalImpulse - OldNormalImpulse));
+        }
+    }
+}
+
+void FContactSolver::StoreImpulses()
+{
+    Cache.Reset();
+    for (const auto& C : Contacts)
+    {
+        FContactSolverCachedImpulse Item;
+        Item.ObjA = Bodies[C.BodyA].Obj;
+        Item.ObjB = Bodies[C.BodyB].Obj;
+        Item.Point = C.Point;
+        Item.Normal = C.Normal;
+        Item.NormalImpulse = C.NormalImpulse;
+        Item.TangentImpulse = C.TangentU * C.TangentImpulse.X + C.TangentV * C.TangentImpulse.Y;
+        Cache.Add(Item);
+    }
+}
+
+void FContactSolver::SeparateBodies()
+{
+    // contact pushes only by penetration left after offsets from previous contacts, so overlapping normals are not summed
+    for (const auto& C : Contacts)
+    {
+        auto& A = Bodies[C.BodyA];
+        auto& B = Bodies[C.BodyB];
+        
+        const float TotalMassInv = A.MassInv + B.MassInv;
+        if(FMath::IsNearlyZero(TotalMassInv)) continue;
+        
+        const float Left = C.Penetration * SeparationSphereMultiplier - ((B.SeparationOffset - A.SeparationOffset) | C.Normal);
+        if(Left <= 0.0f) continue;
+
+        const FVector Portion = C.Normal * Left / TotalMassInv;
+        A.SeparationOffset -= Portion * A.MassInv;
+        B.SeparationOffset += Portion * B.MassInv;
+    }
+}
+
+float FContactSolver::GetEffectiveMass(const FContactSolverContact& C, const FVector& Direction) const
+{
+    const auto& A = Bodies[C.BodyA];
+    const auto& B = Bodies[C.BodyB];
+    
+    const FVector InertiaA = UPhysicsSimulation::CalcInertiaEffect(A.InertiaInv, C.Point - A.Location, Direction);
+    const FVector InertiaB = UPhysicsSimulation::CalcInertiaEffect(B.InertiaInv, C.Point - B.Location, Direction);
+    return A.MassInv + B.MassInv + ((InertiaA + InertiaB) | Direction);
+}
+
+float FContactSolver::GetRelativeVelocity(const FContactSolverContact& C, const FVector& Direction) const
+{
+    return (Bodies[C.BodyB].GetVelocityAtPoint(C.Point) - Bodies[C.BodyA].GetVelocityAtPoint(C.Point)) | Direction;
+}
+
+void FContactSolver::ApplyContactImpulse(const FContactSolverContact& C, const FVector& Impulse)
+{
+    Bodies[C.BodyA].ApplyImpulse(-Impulse, C.Point);
+    Bodies[C.BodyB].ApplyImpulse(Impulse, C.Point);
+}
@@ -0,0 +1,78 @@
+﻿#include "Collision/GroundPlaneContact.h"
+#include "Components/CustomPhysicsComponent.h"
+#include "Components/CustomPhysicsProcessor.h"
+
+bool FGroundPlaneContact::Make(UCustomPhysicsComponent* Obj, const TArray<UCustomPhysicsBaseComponent*>& StaticBodies, const FPhysTransform& T, float DeltaTime,
+                               FContactSolver& SequenceSolver, FGroundPlaneContact& Out)
+{
+    constexpr float MinGroundNormalZ = 0.9999f;
+    
+    Out = FGroundPlaneContact();
+    Out.Ball.SetFromObject(Obj);
+    if(Out.Ball.MassInv <= 0.0f) return false;
+
+    UCustomPhysicsBaseComponent* GroundBody = nullptr;
+    for (const auto Body : StaticBodies)
+    {
+        const auto Primitive = Body ? Body->GetPrimitiveComponent() : nullptr;
+        if(!Primitive) continue;
+        
+        Body->UpdateCollisionSnapshot();
+        const auto& Snapshot = Body->GetCollisionSnapshot();
+        const bool bResting = Body->GetCurrentLinearVelocity().IsNearlyZero() && Body->GetCurrentAngularVelocityRadians().IsNearlyZero();
+        if(!GroundBody && bResting && Snapshot.IsValid() && Snapshot.Shapes.Num() == 1)
+        {
+            const auto& Shape = Snapshot.Shapes[0];
+            const bool bFlatBox = Shape.Type == EAnalyticShapeType::Box && Shape.Rotation.GetAxisZ().Z >= MinGroundNormalZ;
+            const float Top = Shape.Center.Z + Shape.Extent.Z;
+            const float Radius = Out.Ball.Radius;
+            const float Height = T.Location.Z - Radius - Top;
+            
+            if(bFlatBox && Height >= -Radius && Height <= Radius && IsOverBox(Shape, T.Location))
+            {
+                GroundBody = Body;
+                Out.Ground = Shape;
+                Out.GroundZ = Top;
+                continue;
+            }
+        }
+        Out.Obstacles.Add(Primitive->Bounds.GetBox());
+    }
+
+    if(!GroundBody) return false;
+    
+    Out.GroundColliders.AddDefaulted_GetRef().SetFromObject(GroundBody);
+    if(const auto Processor = Obj->PhysicsProcessor)
+    {
+        Out.Ball.ContactSolverIterations = Processor->ContactSolverIterations;
+        Out.Ball.bContactSolverWarmStart = Processor->bContactSolverWarmStart;
+    }
+    Out.Solver = &SequenceSolver;
+    return Out.CanContinue(T, DeltaTime);
+}
+
+bool FGroundPlaneContact::CanContinue(const FPhysTransform& T, float DeltaTime) const
+{
+    if(!IsOverGround(T.Location)) return false;
+    
+    // linear sweep over next step; curvature within step is covered by radius margin
+    const FBox Swept = FBox(T.Location, T.Location + T.LinearVelocity * DeltaTime).ExpandBy(2.0f * Ball.Radius);
+    for (const auto& Box : Obstacles)
+    {
+        if(Box.Intersect(Swept)) return false;
+    }
+    return true;
+}
+
+bool FGroundPlaneContact::IsOverBox(const FAnalyticCollisionShape& Box, const FVector& Location)
+{
+    const FVector Local = Box.Rotation.UnrotateVector(Location - Box.Center);
+    return FMath::Abs(Local.X) <= Box.Extent.X && FMath::Abs(Local.Y) <= Box.Extent.Y;
+}
+
+void FGroundPlaneContact::Resolve(FPhysTransform& InOutT)
+{
+    // ball over ground top touches nothing else, so contacts are the ones general collision would find
+    const FPhysTransform T = InOutT;
+    FPredictionStep::ResolveContacts(Ball, GroundColliders, T, *Solver, InOutT);
+}
@@ -0,0 +1,27 @@
+﻿#include "Collision/PredictionContacts.h"
+
+void FPhysPredictionContacts::Reset(const TArray<FContactSolverCachedImpulse>& LiveCache)
+{
+    Reset();
+    Solver.Cache = LiveCache;
+}
+
+void FPhysPredictionContacts::Reset()
+{
+    Colliders.Reset();
+    Solver.Reset();
+    Solver.Cache.Reset();
+}
+
+void FPhysPredictionContacts::UpdateColliders(const TArray<UCustomPhysicsBaseComponent*>& StaticBodies)
+{
+    int Num = 0;
+    for (const auto Obj : StaticBodies)
+    {
+        if(!Obj) continue;
+        
+        if(Num == Colliders.Num()) Colliders.AddDefaulted();
+        Colliders[Num++].SetFromObject(Obj);
+    }
+    Colliders.SetNum(Num, false);
+}
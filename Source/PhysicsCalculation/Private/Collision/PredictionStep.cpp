@@ -0,0 +1,245 @@
+﻿#include "Collision/PredictionStep.h"
+#include "constants.h"
+#include "Collision/CollisionDetection.h"
+#include "Components/CustomPhysicsComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Libs/PhysicsSimulation.h"
+#include "Libs/PhysicsUtils.h"
+
+void FPredictionBody::SetFromObject(UCustomPhysicsComponent* InObj)
+{
+    Obj = InObj;
+    bLockX = InObj->IsLockLocationX();
+    bLockY = InObj->IsLockLocationY();
+    bLockZ = InObj->IsLockLocationZ();
+    
+    Radius = InObj->GetRadius();
+    MassInv = InObj->GetMassInv();
+    InertiaInv = InObj->GetInertiaTensorInverted();
+    Friction = InObj->GetFriction();
+    Restitution = InObj->GetRestitution();
+    FrictionCombineMode = InObj->GetFrictionCombineMode();
+    RestitutionCombineMode = InObj->GetRestitutionCombineMode();
+}
+
+void FPredictionCollider::SetFromObject(UCustomPhysicsBaseComponent* InObj)
+{
+    Obj = InObj;
+    Shape = InObj->GetCollisionSnapshot();
+    Location = InObj->GetCurrentLocation();
+    LinearVelocity = InObj->GetCurrentLinearVelocity();
+    AngularVelocity = InObj->GetCurrentAngularVelocityRadians();
+    InertiaInv = InObj->GetInertiaTensorInverted();
+    MassInv = InObj->GetMassInv();
+    Friction = InObj->GetFriction();
+    Restitution = InObj->GetRestitution();
+    RestitutionCombineMode = InObj->GetRestitutionCombineMode();
+    GroundRoll.Reset();
+}
+
+float FPredictionCollider::GetClosestPoint(const FVector& Point, FVector& OutPoint) const
+{
+    if(Shape.IsValid()) return Shape.GetClosestPoint(Point, OutPoint);
+    
+    const auto Primitive = Obj ? Obj->GetPrimitiveComponent() : nullptr;
+    return Primitive ? Primitive->GetClosestPointOnCollision(Point, OutPoint) : -1.0f;
+}
+
+bool FPredictionCollider::SweepSphere(const FVector& Start, const FVector& End, float SphereRadius, float& OutAlpha, FVector& OutNormal) const
+{
+    const bool bHit = Shape.IsValid()
+                          ? Shape.SweepSphere(Start, End - Start, SphereRadius, OutAlpha, OutNormal)
+                          : Obj && UCollisionDetection::FindFirstCollisionAgainstSphereStepped(Start, End, SphereRadius, Obj, OutAlpha, OutNormal);
+    // swept contact has no penetration, so it is validated by its normal
+    return bHit && !OutNormal.IsNearlyZero();
+}
+
+void FPredictionStep::Simulate(const FPredictionBody& Body, const FPhysSimParams& SimParams, const TArray<FPredictionCollider>& Colliders, float DeltaTime,
+                               const FPhysTransform& T, FContactSolver& Solver, FPhysTransform& OutT)
+{
+    const auto Integrate = [&SimParams](float StepTime, FPhysTransform& InOutT)
+    {
+        UPhysicsSimulation::PhysicsSimulateDelta(SimParams, StepTime, InOutT);
+    };
+    Simulate(Body, Colliders, DeltaTime, Integrate, T, Solver, OutT);
+}
+
+void FPredictionStep::Simulate(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, float DeltaTime, FIntegrate Integrate,
+                               const FPhysTransform& T, FContactSolver& Solver, FPhysTransform& OutT)
+{
+    FPhysTransform TCollisionResolve = T;
+    if(Body.bCheckCollisions) ResolveContacts(Body, Colliders, T, Solver, TCollisionResolve);
+
+    OutT = TCollisionResolve;
+    Integrate(DeltaTime, OutT);
+    UPhysicsSimulation::UpdateTransformLock(OutT, T.Location, T.Orientation, Body.bLockX, Body.bLockY, Body.bLockZ);
+
+    if(Body.bCheckCollisions && SweepStep(Body, Colliders, DeltaTime, Integrate, TCollisionResolve, OutT))
+    {
+        UPhysicsSimulation::UpdateTransformLock(OutT, T.Location, T.Orientation, Body.bLockX, Body.bLockY, Body.bLockZ);
+    }
+}
+
+bool FPredictionStep::HasContact(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, const FVector& Location, int IgnoredCollider)
+{
+    if(!Body.bCheckCollisions) return false;
+    
+    for (int i = 0; i < Colliders.Num(); ++i)
+    {
+        if(i == IgnoredCollider) continue;
+        
+        FVector CP;
+        const float Distance = Colliders[i].GetClosestPoint(Location, CP);
+        if(Distance >= 0.0f && Body.Radius - Distance > 0.0f) return true;
+    }
+    return false;
+}
+
+void FPredictionStep::ResolveContacts(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, const FPhysTransform& T,
+                                      FContactSolver& Solver, FPhysTransform& OutT)
+{
+    OutT = T;
+    
+    const bool bSolver = Body.ContactSolverIterations > 0;
+    if(bSolver)
+    {
+        Solver.NumIterations = Body.ContactSolverIterations;
+        Solver.bWarmStart = Body.bContactSolverWarmStart;
+        Solver.Reset();
+    }
+
+    int BallIndex = INDEX_NONE;
+    for (const auto& C : Colliders)
+    {
+        FVector CP;
+        const float Distance = C.GetClosestPoint(T.Location, CP);
+        const float Penetration = Body.Radius - Distance;
+        if(Distance < 0.0f || Penetration <= 0.0f) continue;
+
+        const FVector N = (T.Location - CP).GetSafeNormal();
+        if((N * Penetration).IsNearlyZero()) continue;
+
+        if(!bSolver)
+        {
+            // as one by one resolve of live objects: every pair starts from T, the last one wins
+            ResolveCollision(Body, C, T, CP, N, Penetration, OutT);
+            continue;
+        }
+
+        // predicted sphere goes first; colliders are not changed by prediction
+        if(BallIndex == INDEX_NONE)
+        {
+            FContactSolverBody Ball;
+            Ball.Obj = Body.Obj;
+            Ball.Location = T.Location;
+            Ball.LinearVelocity = T.LinearVelocity;
+            Ball.AngularVelocity = T.AngularVelocity;
+            Ball.MassInv = Body.MassInv;
+            Ball.InertiaInv = Body.InertiaInv;
+            BallIndex = Solver.AddBody(Ball);
+        }
+
+        FContactSolverBody Collider;
+        Collider.Obj = C.Obj;
+        Collider.Location = C.Location;
+        Collider.LinearVelocity = C.LinearVelocity;
+        Collider.AngularVelocity = C.AngularVelocity;
+        Collider.MassInv = C.MassInv;
+        Collider.InertiaInv = C.InertiaInv;
+
+        const float Friction = UPhysicsUtils::CombinePhysValue(C.Friction, Body.Friction, Body.FrictionCombineMode);
+        const EPhysicsCombineMode RestitutionMode = UPhysicsUtils::SelectPhysCombineMode(C.RestitutionCombineMode, Body.RestitutionCombineMode);
+        const float Restitution = UPhysicsUtils::CombinePhysValue(C.Restitution, Body.Restitution, RestitutionMode);
+        Solver.AddContact(Solver.AddBody(Collider), BallIndex, CP, N, Penetration, Friction, Restitution);
+    }
+    if(!bSolver) return;
+
+    // solved even without contacts, so warm start cache is dropped once they are gone
+    Solver.SolveContacts();
+    if(BallIndex == INDEX_NONE) return;
+
+    const auto& Ball = Solver.Bodies[BallIndex];
+    OutT.Location += Ball.SeparationOffset;
+    OutT.LinearVelocity = Ball.LinearVelocity;
+    OutT.AngularVelocity = Ball.AngularVelocity;
+}
+
+bool FPredictionStep::SweepStep(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, float DeltaTime, FIntegrate Integrate,
+                                const FPhysTransform& T, FPhysTransform& InOutTNext)
+{
+    // slow sphere can not pass through anything between two discrete checks
+    const float MaxStep = TunnelingDetectionSphereRadiusMul * Body.Radius;
+    FPhysTransform TStart = T;
+    float TimeLeft = DeltaTime;
+    bool bHit = false;
+
+    for (int i = 0; i < MaxSweepContactsPerStep; ++i)
+    {
+        if(FVector::DistSquared(TStart.Location, InOutTNext.Location) <= MaxStep * MaxStep) break;
+
+        float Alpha;
+        FVector Normal;
+        const int Index = FindFirstSweepHit(Body, Colliders, TStart.Location, InOutTNext.Location, Alpha, Normal);
+        if(Index == INDEX_NONE) break;
+
+        // resolve collision at contact instant
+        FPhysTransform TContact = UPhysicsUtils::TLerp(TStart, InOutTNext, Alpha);
+        TContact.Location = TStart.Location + (InOutTNext.Location - TStart.Location) * Alpha;
+        FPhysTransform TResolved;
+        ResolveCollision(Body, Colliders[Index], TContact, TContact.Location - Normal * Body.Radius, Normal, 0.0f, TResolved);
+        bHit = true;
+
+        // and move for the rest of the step; rest after the last contact is dropped
+        InOutTNext = TResolved;
+        TimeLeft *= 1.0f - Alpha;
+        if(i + 1 == MaxSweepContactsPerStep || TimeLeft <= KINDA_SMALL_NUMBER) break;
+        
+        Integrate(TimeLeft, InOutTNext);
+        TStart = TResolved;
+    }
+    return bHit;
+}
+
+int FPredictionStep::FindFirstSweepHit(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, const FVector& Start, const FVector& End,
+                                       float& OutAlpha, FVector& OutNormal)
+{
+    int Index = INDEX_NONE;
+    OutAlpha = 1.0f;
+    
+    for (int i = 0; i < Colliders.Num(); ++i)
+    {
+        float Alpha;
+        FVector Normal;
+        if(!Colliders[i].SweepSphere(Start, End, Body.Radius, Alpha, Normal)) continue;
+        if(Index != INDEX_NONE && Alpha >= OutAlpha) continue;
+
+        Index = i;
+        OutAlpha = Alpha;
+        OutNormal = Normal;
+    }
+    return Index;
+}
+
+void FPredictionStep::ResolveCollision(const FPredictionBody& Body, const FPredictionCollider& C, const FPhysTransform& T,
+                                       const FVector& CP, const FVector& N, float Penetration, FPhysTransform& OutT)
+{
+    OutT = T;
+    
+    FVector OffsetA, OffsetB;
+    UCollisionDetection::CalcSeparationOffsets(C.MassInv, Body.MassInv, N * Penetration, OffsetA, OffsetB);
+    OutT.Location += OffsetB;
+
+    const float TotalMassInv = C.MassInv + Body.MassInv;
+    const float FrictionB = UPhysicsUtils::CombinePhysValue(C.Friction, Body.Friction, Body.FrictionCombineMode);
+    const EPhysicsCombineMode RestitutionMode = UPhysicsUtils::SelectPhysCombineMode(C.RestitutionCombineMode, Body.RestitutionCombineMode);
+    const float Restitution = UPhysicsUtils::CombinePhysValue(C.Restitution, Body.Restitution, RestitutionMode);
+
+    const FVector CPVelocityA = C.GetFullVelocityAtPoint(CP);
+    const FVector CPVelocityB = UPhysicsSimulation::PTransformGetLinearVelocityAtPoint(OutT, CP);
+
+    const FVector FullImpulse = UCollisionDetection::CalcCollisionFullImpulse(C.Location, OutT.Location, C.InertiaInv, Body.InertiaInv, CPVelocityA, CPVelocityB,
+                                                                              TotalMassInv, Restitution, CP, N);
+
+    UCollisionDetection::ApplyCollisionImpulse(OutT, FullImpulse, CP, Body.InertiaInv, Body.MassInv);
+    UPhysicsSimulation::ApplyFriction(OutT, CP, CPVelocityB, FullImpulse, Body.InertiaInv, Body.MassInv, FrictionB);
+}
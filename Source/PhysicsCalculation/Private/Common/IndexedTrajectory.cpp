@@ -0,0 +1,251 @@
+﻿#include "Common/IndexedTrajectory.h"
+
+void FTrajectoryChannelIndex::Reset(int32 Slack)
+{
+    Values.Reset(Slack);
+    Segments.Reset();
+}
+
+void FTrajectoryChannelIndex::Add(float V)
+{
+    const int32 Key = Values.Add(V);
+    if(Key == 0) return;
+
+    const float Prev = Values[Key - 1];
+    const bool bIncreasing = V >= Prev;
+    if(Segments.Num() == 0)
+    {
+        Segments.Emplace(0, Key, bIncreasing);
+        return;
+    }
+
+    auto& Last = Segments.Last();
+    if(V == Prev || Last.bIncreasing == bIncreasing)
+    {
+        Last.Last = Key;
+        return;
+    }
+    Segments.Emplace(Key - 1, Key, bIncreasing);
+}
+
+bool FTrajectoryChannelIndex::SegmentContains(const FTrajectoryMonotoneSegment& S, float V) const
+{
+    const float A = Values[S.First];
+    const float B = Values[S.Last];
+    return S.bIncreasing ? A <= V && V <= B : B <= V && V <= A;
+}
+
+float FTrajectoryChannelIndex::FindInSegment(const FTrajectoryMonotoneSegment& S, float V) const
+{
+    // Lo stays before the value, Hi reaches it
+    int32 Lo = S.First;
+    int32 Hi = S.Last;
+    if(Values[Lo] == V) return Lo;
+    
+    while (Hi - Lo > 1)
+    {
+        const int32 Mid = (Lo + Hi) / 2;
+        const bool bReached = S.bIncreasing ? Values[Mid] >= V : Values[Mid] <= V;
+        if(bReached) Hi = Mid;
+        else Lo = Mid;
+    }
+
+    const float A = Values[Lo];
+    const float B = Values[Hi];
+    const float Alpha = FMath::IsNearlyEqual(A, B) ? 0.0f : (V - A) / (B - A);
+    return Lo + FMath::Clamp(Alpha, 0.0f, 1.0f);
+}
+
+bool FTrajectoryChannelIndex::FindPositions(float V, TArray<float>& OutPositions) const
+{
+    OutPositions.Reset();
+    for (const auto& S : Segments)
+    {
+        if(!SegmentContains(S, V)) continue;
+        
+        const float Position = FindInSegment(S, V);
+        // neighbour segments share boundary key
+        const bool bDuplicate = OutPositions.Num() > 0 && Position - OutPositions.Last() < KINDA_SMALL_NUMBER;
+        if(!bDuplicate) OutPositions.Add(Position);
+    }
+    return OutPositions.Num() > 0;
+}
+
+bool FTrajectoryChannelIndex::FindFirstPosition(float V, float& OutPosition) const
+{
+    for (const auto& S : Segments)
+    {
+        if(SegmentContains(S, V))
+        {
+            OutPosition = FindInSegment(S, V);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FTrajectoryChannelIndex::FindLastPosition(float V, float& OutPosition) const
+{
+    for (int i = Segments.Num() - 1; i >= 0; --i)
+    {
+        if(SegmentContains(Segments[i], V))
+        {
+            OutPosition = FindInSegment(Segments[i], V);
+            return true;
+        }
+    }
+    return false;
+}
+
+FIndexedTrajectory::FIndexedTrajectory(const TArray<FVector>& InLocations, float InTimeStep)
+{
+    Reset(InTimeStep, InLocations.Num());
+    for (const auto& L : InLocations)
+    {
+        Add(L);
+    }
+}
+
+void FIndexedTrajectory::Reset(float InTimeStep, int32 Slack)
+{
+    TimeStep = InTimeStep;
+    Locations.Reset(Slack);
+    DistanceXY.Reset(Slack);
+    Z.Reset(Slack);
+    MaxZKey = 0;
+}
+
+void FIndexedTrajectory::Add(const FVector& Location)
+{
+    const int32 Key = Locations.Add(Location);
+    DistanceXY.Add((Location - Locations[0]).Size2D());
+    Z.Add(Location.Z);
+    if(Location.Z > Locations[MaxZKey].Z) MaxZKey = Key;
+}
+
+void FIndexedTrajectory::RotateByQuat(const FQuat& Q)
+{
+    if(IsEmpty()) return;
+    
+    const FVector Start = GetStartLocation();
+    TArray<FVector> Source = MoveTemp(Locations);
+    Reset(TimeStep, Source.Num());
+    for (const auto& L : Source)
+    {
+        Add(Start + Q.RotateVector(L - Start));
+    }
+}
+
+FVector FIndexedTrajectory::GetLocationAtPosition(float Position) const
+{
+    check(!IsEmpty())
+    
+    const int32 LastKey = Num() - 1;
+    const float P = FMath::Clamp(Position, 0.0f, static_cast<float>(LastKey));
+    const int32 Key = FMath::Min(FMath::FloorToInt(P), LastKey);
+    if(Key == LastKey) return Locations[LastKey];
+    return FMath::Lerp(Locations[Key], Locations[Key + 1], P - Key);
+}
+
+FVector FIndexedTrajectory::GetLocationAtTime(float Time) const
+{
+    if(IsEmpty()) return FVector::ZeroVector;
+    const float Position = TimeStep > 0.0f ? Time / TimeStep : 0.0f;
+    return GetLocationAtPosition(Position);
+}
+
+bool FIndexedTrajectory::GetTimeAtDistanceXY(float Distance, float& OutTime) const
+{
+    float Position;
+    if(!DistanceXY.FindFirstPosition(Distance, Position)) return false;
+    OutTime = Position * TimeStep;
+    return true;
+}
+
+bool FIndexedTrajectory::GetTimesAtZ(float Value, TArray<float>& OutTimes) const
+{
+    if(!Z.FindPositions(Value, OutTimes)) return false;
+    for (auto& T : OutTimes)
+    {
+        T *= TimeStep;
+    }
+    return true;
+}
+
+bool FIndexedTrajectory::GetLastTimeAtZ(float Value, float& OutTime) const
+{
+    float Position;
+    if(!Z.FindLastPosition(Value, Position)) return false;
+    OutTime = Position * TimeStep;
+    return true;
+}
+
+int32 FIndexedTrajectory::DescendToClosestKey(const FVector& Target, int32 Key) const
+{
+    const int32 LastKey = Num() - 1;
+    float Distance = FVector::DistSquared(Locations[Key], Target);
+    
+    for (;;)
+    {
+        const float DistancePrev = Key > 0 ? FVector::DistSquared(Locations[Key - 1], Target) : MAX_flt;
+        const float DistanceNext = Key < LastKey ? FVector::DistSquared(Locations[Key + 1], Target) : MAX_flt;
+        if(Distance <= DistancePrev && Distance <= DistanceNext) return Key;
+
+        const bool bPrev = DistancePrev < DistanceNext;
+        Key += bPrev ? -1 : 1;
+        Distance = bPrev ? DistancePrev : DistanceNext;
+    }
+}
+
+float FIndexedTrajectory::GetClosestPositionNearKey(const FVector& Target, int32 Key) const
+{
+    float BestPosition = Key;
+    float BestDistance = FVector::DistSquared(Locations[Key], Target);
+
+    // closest point may lie on either of adjacent chords
+    for (int32 First = Key - 1; First <= Key; ++First)
+    {
+        if(First < 0 || First + 1 >= Num()) continue;
+        
+        const FVector A = Locations[First];
+        const FVector AB = Locations[First + 1] - A;
+        const float LengthSquared = AB.SizeSquared();
+        if(LengthSquared < SMALL_NUMBER) continue;
+
+        const float Alpha = FMath::Clamp(FVector::DotProduct(Target - A, AB) / LengthSquared, 0.0f, 1.0f);
+        const float Distance = FVector::DistSquared(A + AB * Alpha, Target);
+        if(Distance < BestDistance)
+        {
+            BestDistance = Distance;
+            BestPosition = First + Alpha;
+        }
+    }
+    return BestPosition;
+}
+
+float FIndexedTrajectory::GetClosestTime(const FVector& Target) const
+{
+    if(IsEmpty()) return 0.0f;
+
+    TArray<float> Starts;
+    DistanceXY.FindPositions((Target - GetStartLocation()).Size2D(), Starts);
+    Starts.Add(0.0f);
+    for (const auto& S : DistanceXY.Segments)
+    {
+        Starts.Add(S.Last);
+    }
+
+    int32 BestKey = 0;
+    float BestDistance = MAX_flt;
+    for (const float Start : Starts)
+    {
+        const int32 Key = DescendToClosestKey(Target, FMath::Clamp(FMath::RoundToInt(Start), 0, Num() - 1));
+        const float Distance = FVector::DistSquared(Locations[Key], Target);
+        if(Distance < BestDistance)
+        {
+            BestDistance = Distance;
+            BestKey = Key;
+        }
+    }
+    return GetClosestPositionNearKey(Target, BestKey) * TimeStep;
+}
@@ -0,0 +1,32 @@
+﻿#include "Common/PhysSimParams.h"
+#include "Aerodynamics/AerodynamicsSimulation.h"
+#include "Common/PhysRigidBodyParams.h"
+
+void FPhysSimParams::Build(const FPhysRigidBodyParams& P)
+{
+    Gravity = P.bGravityEnabled ? P.GetGravity() : FVector::ZeroVector;
+    Mass = P.GetMass();
+    MassInv = P.GetMassInv();
+    Radius = P.Radius;
+    CrossSectionArea = P.GetSphericalCrossSectionArea();
+    InertiaInv = P.GetInertiaTensorInverted();
+
+    const auto& AD = P.Aerodynamics;
+    const float AirDensity = AD.AirDrag.GetAirDensityKgCm3();
+    AirDrag = AD.AirDrag;
+    bDrag = AD.AirDragImpact.bEnabled;
+    bMagnus = AD.MagnusImpact.bEnabled;
+    DragFactor = AD.AirDragImpact.Value * 0.5f * AirDensity * CrossSectionArea;
+    LiftFactor = AD.MagnusImpact.Value * UAerodynamicsSimulation::GetSphereLiftFactor(Radius, AirDensity);
+
+    bLinearDamping = P.LinearDamping.bEnabled;
+    bAngularDamping = P.AngularDamping.bEnabled;
+    LinearDamping = P.LinearDamping.Value;
+    AngularDamping = P.AngularDamping.Value;
+
+    Constrains = P.Constrains;
+    MaxRenderAngularVelocity = P.Rendering.MaxAngularVelocity;
+    
+    Integrator = P.Integrator;
+    bExponentialMapRotation = P.bExponentialMapRotation;
+}
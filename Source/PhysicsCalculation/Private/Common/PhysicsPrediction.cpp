@@ -78,12 +78,13 @@ void UPhysicsPrediction::AddStepsToPrecisePrediction(int StepsToAdd)
    if(Comp)
    {
       const float StepTime =  GetSimulationDeltaTime();
+      FPhysPredictionContacts Contacts;
       for (int i = 0; i < StepsToAdd; ++i)
       {
          const int NumExistingKeys = PrecisePredictionCurve.GetNumKeys();
          const float SkipTime = NumExistingKeys * StepTime;
          auto LastKnownTransform = GetLastPrecisePredictedTransformPtrOrObjCurrentTransform();
-         auto NewTransform = Comp->CalculateNextPreciseTransform(LastKnownTransform, SkipTime, true);
+         auto NewTransform = Comp->CalculateNextPreciseTransform(LastKnownTransform, SkipTime, Contacts, true);
          PrecisePredictionCurve.InsertKeyToEnd(SkipTime, NewTransform);
       }
    }
@@ -93,12 +94,13 @@ void UPhysicsPrediction::AddStepsToRoughPrediction(int StepsToAdd)
 {
    if(Comp)
    {
+      FPhysPredictionContacts Contacts;
       for (int i = 0; i < StepsToAdd; ++i)
       {
          constexpr float SkipTime = 0;
          const float SimStep = GetRoughSimulationTimeStep();
          auto LastKnownTransform = GetLastRoughPredictedTransformPtrOrLastPreciseTransform();
-         auto NewTransform = Comp->CalculateNextRoughTransform(LastKnownTransform, SimStep, SkipTime, true);
+         auto NewTransform = Comp->CalculateNextRoughTransform(LastKnownTransform, SimStep, SkipTime, Contacts, true);
          RoughPredictionCurve.InsertKeyToEnd(SkipTime, NewTransform);
       }
    }
@@ -0,0 +1,162 @@
+﻿#include "Common/RoughPredictionJob.h"
+#include "constants.h"
+#include "Libs/AdaptiveIntegrationLib.h"
+#include "Libs/PhysicsSimulation.h"
+#include "Libs/PhysicsUtils.h"
+
+void FRoughPredictionJob::Run()
+{
+    if(Input.AdaptiveStep.bEnabled)
+    {
+        RunAdaptive();
+        return;
+    }
+    
+    Result.Reset(Input.NumSteps);
+    
+    // derived once per run
+    const FPhysSimParams SimParams(Input.RbParams);
+    FPhysTransform T = Input.StartTransform;
+    while (Result.Num() < Input.NumSteps)
+    {
+        if(AddGroundRollSamples(Input, Input.NumSteps - Result.Num(), T, Result) > 0) continue;
+        
+        FPhysTransform NewT;
+        SimulateStep(Input, SimParams, T, Solver, NewT);
+        Result.Add(NewT);
+        T = NewT;
+    }
+    bCompleted = true;
+}
+
+void FRoughPredictionJob::RunAdaptive()
+{
+    Result.Reset(Input.NumSteps);
+
+    const FPhysSimParams SimParams(Input.RbParams);
+    FPhysTransform T = Input.StartTransform;
+    FVector Acceleration = UAdaptiveIntegrationLib::GetAcceleration(SimParams, T.LinearVelocity, T.AngularVelocity);
+    float Step = FMath::Max(Input.AdaptiveStep.InitialStep, Input.SimStep);
+    
+    while(Result.Num() < Input.NumSteps)
+    {
+        if(FPredictionStep::HasContact(Input, Input.Colliders, T.Location))
+        {
+            if(AddGroundRollSamples(Input, Input.NumSteps - Result.Num(), T, Result) == 0)
+            {
+                FPhysTransform NewT;
+                SimulateStep(Input, SimParams, T, Solver, NewT);
+                Result.Add(NewT);
+                T = NewT;
+            }
+            Acceleration = UAdaptiveIntegrationLib::GetAcceleration(SimParams, T.LinearVelocity, T.AngularVelocity);
+            continue;
+        }
+
+        FAdaptiveFlightSegment Segment;
+        const int NumQuanta = UAdaptiveIntegrationLib::AdvanceSegment(SimParams, Input.AdaptiveStep, T, Acceleration, Input.SimStep,
+                                                                       Input.NumSteps - Result.Num(), Step, Segment);
+        const FVector LockLocation = T.Location;
+        const float MaxStep = TunnelingDetectionSphereRadiusMul * Input.Radius;
+        FPhysTransform Prev = T;
+        for (int i = 1; i <= NumQuanta; ++i)
+        {
+            FPhysTransform Sample = Segment.Sample(i * Input.SimStep);
+            UPhysicsSimulation::UpdateTransformLock(Sample, LockLocation, T.Orientation, Input.bLockX, Input.bLockY, Input.bLockZ);
+
+            // thin collider between samples is not seen by their contact checks, so that quantum is stepped with sweep instead
+            float SweepAlpha;
+            FVector SweepNormal;
+            const bool bFast = Input.bCheckCollisions && FVector::DistSquared(Prev.Location, Sample.Location) > MaxStep * MaxStep;
+            if(bFast && FPredictionStep::FindFirstSweepHit(Input, Input.Colliders, Prev.Location, Sample.Location, SweepAlpha, SweepNormal) != INDEX_NONE)
+            {
+                SimulateStep(Input, SimParams, Prev, Solver, Sample);
+                Result.Add(Sample);
+                T = Sample;
+                Acceleration = UAdaptiveIntegrationLib::GetAcceleration(SimParams, T.LinearVelocity, T.AngularVelocity);
+                break;
+            }
+            Result.Add(Sample);
+            Prev = Sample;
+
+            // collision is resolved from the first sample that touches, as fixed stepping does
+            const bool bLast = i == NumQuanta;
+            if(bLast || FPredictionStep::HasContact(Input, Input.Colliders, Sample.Location))
+            {
+                T = Sample;
+                Acceleration = bLast ? Segment.EndAcceleration : UAdaptiveIntegrationLib::GetAcceleration(SimParams, T.LinearVelocity, T.AngularVelocity);
+                break;
+            }
+        }
+    }
+    bCompleted = true;
+}
+
+int FRoughPredictionJob::AddGroundRollSamples(const FRoughPredictionInput& In, int MaxSamples, FPhysTransform& InOutT, FPhysTransformRingBuffer& Out)
+{
+    int GroundIndex;
+    float GroundZ;
+    if(MaxSamples < 1 || !FindRollingGround(In, InOutT, GroundIndex, GroundZ)) return 0;
+
+    const auto& Ground = In.Colliders[GroundIndex];
+    const auto& GroundRoll = *Ground.GroundRoll;
+    const float Friction = UPhysicsUtils::CombinePhysValue(Ground.Friction, In.Friction, In.FrictionCombineMode);
+    
+    // every sample is taken from start, so lookup error does not accumulate
+    FPhysTransform Start = InOutT;
+    Start.Location.Z = GroundZ + In.Radius;
+    for (int i = 1; i <= MaxSamples; ++i)
+    {
+        FPhysTransform Sample;
+        GroundRoll.AdvanceOnGround(Start, i * In.SimStep, Friction, Sample);
+        Out.Add(Sample);
+        InOutT = Sample;
+
+        FVector CP;
+        const float Distance = Ground.GetClosestPoint(Sample.Location, CP);
+        const bool bOnGround = Distance >= 0.0f && FVector::DistSquared2D(Sample.Location, CP) <= 0.01f;
+        if(!bOnGround || FPredictionStep::HasContact(In, In.Colliders, Sample.Location, GroundIndex)) return i;
+    }
+    return MaxSamples;
+}
+
+bool FRoughPredictionJob::FindRollingGround(const FRoughPredictionInput& In, const FPhysTransform& T, int& OutGroundIndex, float& OutGroundZ)
+{
+    constexpr float MinGroundNormalZ = 0.999f;
+    // body separated by collision resolve is still rolling
+    constexpr float ContactTolerance = 1.0f;
+    
+    OutGroundIndex = INDEX_NONE;
+    OutGroundZ = 0.0f;
+    if(!In.bCheckCollisions) return false;
+    if(In.bLockX || In.bLockY || In.bLockZ) return false;
+    if(FMath::Abs(T.LinearVelocity.Z) > In.GroundRollMaxVerticalSpeed) return false;
+
+    for (int i = 0; i < In.Colliders.Num(); ++i)
+    {
+        const auto& C = In.Colliders[i];
+        FVector CP;
+        const float Distance = C.GetClosestPoint(T.Location, CP);
+        if(Distance < 0.0f || Distance >= In.Radius + ContactTolerance) continue;
+
+        const FVector N = (T.Location - CP).GetSafeNormal();
+        if(OutGroundIndex != INDEX_NONE || !C.IsResting() || N.Z < MinGroundNormalZ) return false;
+        if(!C.GroundRoll.IsValid() || !C.GroundRoll->IsValid()) return false;
+        
+        OutGroundIndex = i;
+        OutGroundZ = CP.Z;
+    }
+    return OutGroundIndex != INDEX_NONE;
+}
+
+void FGroundRollBuildJob::Run()
+{
+    Result = MakeShared<FBallGroundMovementData, ESPMode::ThreadSafe>();
+    Result->GroundFriction = Friction;
+    Result->GroundRestitution = Restitution;
+    Result->ContactSolverIterations = ContactSolverIterations;
+    Result->bContactSolverWarmStart = bContactSolverWarmStart;
+    Result->Signature = Signature;
+    Result->Simulate(RbParams, SimStep);
+    bCompleted = true;
+}
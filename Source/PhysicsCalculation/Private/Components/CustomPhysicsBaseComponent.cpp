@@ -25,6 +25,12 @@ void UCustomPhysicsBaseComponent::BeginPlay()
 	Initialize();
 }
 
+void UCustomPhysicsBaseComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UUtilsLib::UnsubscribeFromPhysicsProcessor(this);
+	Super::EndPlay(EndPlayReason);
+}
+
 void UCustomPhysicsBaseComponent::SetDefaultPrimitiveComponent()
 {
 	const auto P = Cast<UPrimitiveComponent>(Owner->GetComponentByClass(UStaticMeshComponent::StaticClass()));
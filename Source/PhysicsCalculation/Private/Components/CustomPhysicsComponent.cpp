@@ -2,6 +2,7 @@
 
 #include "PhysicsCalculation/Public/Components/CustomPhysicsComponent.h"
 #include "CommonUtilsLib.h"
+#include "Collision/GroundPlaneContact.h"
 #include "Components/CustomPhysicsProcessor.h"
 #include "Libs/PhysicsSimulation.h"
 #include "DataAssets/CustomPhysicsParamsDataAsset.h"
@@ -20,6 +21,7 @@ void UCustomPhysicsComponent::Validate() const
 UCustomPhysicsComponent::UCustomPhysicsComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
+	UpdateSimParams();
 }
 
 void UCustomPhysicsComponent::CompletePhysRigidBodyParams()
@@ -42,6 +44,7 @@ void UCustomPhysicsComponent::CompletePhysRigidBodyParams()
 	if(PhysicsPredictSettings) PhysicsPredictSettings->FillParamStruct(PhysicsPredict);
 
 	PhysicsParams.Aerodynamics.Init();
+	UpdateSimParams();
 }
 
 void UCustomPhysicsComponent::RebuildPhysicsRepresentation()
@@ -68,6 +71,7 @@ void UCustomPhysicsComponent::SetSimulatePhysics(const bool bSimulate)
 {
 	const bool Prev = bSimulatePhysics;
 	bSimulatePhysics = bSimulate;
+	if(PhysicsProcessor && Prev != bSimulatePhysics) PhysicsProcessor->MarkPhysObjArraysDirty();
 
 	RecomputePrediction(!Prev && bSimulatePhysics);
 }
@@ -100,6 +104,7 @@ FSimpleMatrix3 UCustomPhysicsComponent::GetInertiaTensorInverted()
 void UCustomPhysicsComponent::SetMagnusMultiplierBP(float V)
 {
 	PhysicsParams.Aerodynamics.MagnusImpact.Value = V;
+	UpdateSimParams();
 	RecomputePrediction(true);
 }
 
@@ -119,6 +124,24 @@ float UCustomPhysicsComponent::GetCurrentSideForceVelocityAlpha() const
 	return 0.0f;
 }
 
+int32 UCustomPhysicsComponent::MakeNextKickSeed()
+{
+	NumKicks++;
+	return static_cast<int32>(HashCombine(GetTypeHash(GetFName()), GetTypeHash(NumKicks)));
+}
+
+void UCustomPhysicsComponent::StartSideforceSequence(int32 Seed, bool bRecomputePredict)
+{
+	PhysicsParams.Aerodynamics.Sideforce.Init(Seed);
+	RecomputePrediction(bRecomputePredict);
+}
+
+void UCustomPhysicsComponent::ApplyKick(const FImpulseReconstructed& Kick, bool bRecomputePredict)
+{
+	StartSideforceSequence(Kick.SideforceSeed, false);
+	AddImpulseAtLocation(Kick.Impulse, Kick.ApplyLocation, bRecomputePredict);
+}
+
 void UCustomPhysicsComponent::ApplyCurrentTransformToOwner() const
 {
 	if(Owner)
@@ -167,6 +190,7 @@ FPhysTransform UCustomPhysicsComponent::SimulateDeltaMovementPredictMode(float T
 	FPhysTransform T = CurrentTransform;
 	if(IsPredictionEnabled())
 	{
+		FlushPredictionRecompute();
 		UMovementPredictionLib::PredictGetNextPreciseTransformAndUpdateStruct(T, PhysicsPredict, Time, SimulationDeltaTime);
 	}
 	return T;
@@ -174,16 +198,19 @@ FPhysTransform UCustomPhysicsComponent::SimulateDeltaMovementPredictMode(float T
 
 FPhysTransform UCustomPhysicsComponent::GetPrecisePredictedTransform(float Time)
 {
+	FlushPredictionRecompute();
 	return UMovementPredictionLib::GetPrecisePredictedTransform(CurrentTransform, PhysicsPredict,  Time, PhysicsProcessor->GetSimDT());
 }
 
 FPhysTransform UCustomPhysicsComponent::GetPrecisePredictedTransform(const FPhysTransform& TInitial, float Time)
 {
+	FlushPredictionRecompute();
 	return UMovementPredictionLib::GetPrecisePredictedTransform(TInitial, PhysicsPredict,  Time, PhysicsProcessor->GetSimDT());
 }
 
 FPhysTransform UCustomPhysicsComponent::GetAnyPredictedTransform(float Time)
 {
+	FlushPredictionRecompute();
 	const float PreciseTime = PhysicsPredict.Settings.PrecisePredictTimeSec;
 	if(Time <= PreciseTime) return GetPrecisePredictedTransform( Time);
 	Time -= PreciseTime;
@@ -249,7 +276,7 @@ void UCustomPhysicsComponent::AddAngularImpulseAsApplied(const FVector Force, fl
 	AddAngularImpulse(Force, bRecomputePredict);
 }
 
-FPhysTransform UCustomPhysicsComponent::CalculateNextPreciseTransform(const FPhysTransform &CurrentT, float SkipTime,bool bCheckCollisions)
+FPhysTransform UCustomPhysicsComponent::CalculateNextPreciseTransform(const FPhysTransform &CurrentT, float SkipTime, FPhysPredictionContacts& Contacts, bool bCheckCollisions)
 {
 	FPhysTransform OutT = CurrentT;
 	if(IsCustomPhysicsEnabled() && PhysicsProcessor)
@@ -260,12 +287,13 @@ FPhysTransform UCustomPhysicsComponent::CalculateNextPreciseTransform(const FPhy
 		Data.ToggleCollisions(bCheckCollisions);
 		Data.SetSkipTime(SkipTime);
 		
-		PhysicsProcessor->PredictTransformAnyTime(Data, OutT);
+		PhysicsProcessor->PredictTransformAnyTime(Data, Contacts, OutT);
 	}
 	return OutT;
 }
 
-FPhysTransform UCustomPhysicsComponent::CalculateNextRoughTransform(const FPhysTransform& CurrentT, float SimStep, float SkipTime, bool bCheckCollisions)
+FPhysTransform UCustomPhysicsComponent::CalculateNextRoughTransform(const FPhysTransform& CurrentT, float SimStep, float SkipTime, FPhysPredictionContacts& Contacts,
+                                                                    bool bCheckCollisions)
 {
 	FPhysTransform OutT = CurrentT;
 	if(IsCustomPhysicsEnabled() && PhysicsProcessor)
@@ -277,7 +305,7 @@ FPhysTransform UCustomPhysicsComponent::CalculateNextRoughTransform(const FPhysT
 		Data.DisableExtraForces();
 		Data.ToggleCollisions(bCheckCollisions);
 
-		PhysicsProcessor->PredictTransformAnyTime(Data, OutT);
+		PhysicsProcessor->PredictTransformAnyTime(Data, Contacts, OutT);
 	}
 	return OutT;
 }
@@ -333,7 +361,18 @@ void UCustomPhysicsComponent::RecomputePrediction(bool bRecompute)
 {
 	if (PhysicsPredict.IsEnabled() && bRecompute)
 	{
-		PhysicsPredict.RecomputePrediction();
+		PhysicsPredict.RequestRecompute();
+
+		// without processor there is no tick to flush deferred request
+		const bool bDefer = PhysicsPredict.Settings.bDeferredRecompute && PhysicsProcessor;
+		if(!bDefer) FlushPredictionRecompute();
+	}
+}
+
+void UCustomPhysicsComponent::FlushPredictionRecompute()
+{
+	if(PhysicsPredict.FlushRecompute())
+	{
 		OnPredictionRecomputed.Broadcast();
 	}
 }
@@ -380,11 +419,38 @@ FVector UCustomPhysicsComponent::GetCurrentAngularVelocityRadians() const
 void UCustomPhysicsComponent::SetPhysParams(FPhysRigidBodyParams P)
 {
 	PhysicsParams = P;
+	PhysicsParams.Aerodynamics.AirDrag.UpdateCoefficientTable();
+	UpdateSimParams();
+	RecomputePrediction();
+}
+
+void UCustomPhysicsComponent::UpdateAerodynamicsTables()
+{
+	if(!PhysicsParams.Aerodynamics.AirDrag.UpdateCoefficientTable()) return;
+	// sim params hold their own copy of air drag
+	UpdateSimParams();
 	RecomputePrediction();
 }
 
+void UCustomPhysicsComponent::SetAirDragCurve(UCurveVector* Curve, bool bRecomputePredict)
+{
+	PhysicsParams.Aerodynamics.AirDrag.SetAirDragCurve(Curve);
+	UpdateSimParams();
+	if(bRecomputePredict) RecomputePrediction();
+}
+
+#if WITH_EDITOR
+void UCustomPhysicsComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	PhysicsParams.Aerodynamics.AirDrag.UpdateCoefficientTable();
+	UpdateSimParams();
+}
+#endif
+
 TArray<FVector> UCustomPhysicsComponent::GetPredictedLocations(int SkipStep)
 {
+	FlushPredictionRecompute();
 	TArray<FVector> Data = PhysicsPredict.GetPredictedLocations();
 	if(SkipStep == 0) return Data;
 
@@ -423,9 +489,37 @@ TArray<FPhysTransform> UCustomPhysicsComponent::PredictMovementFromTransformAnyT
                                                                                         bool bCheckCollisions, bool bLimitZ, float LimitZ)
 {
 	TArray<FPhysTransform> OutArray = {T};
+	const bool bGroundPlaneBounce = bCheckCollisions && PhysicsPredict.Settings.bGroundPlaneBounce && PhysicsProcessor;
+	FGroundPlaneContact Ground;
+	bool bOnGroundPlane = false;
+
+	// query is sequence of its own; live contact impulses are reused only by contacts which barely moved since
+	FPhysPredictionContacts Contacts;
+	if(bCheckCollisions && PhysicsProcessor) Contacts.Reset(PhysicsProcessor->GetLiveContactCache());
+	
 	for (int i = 1; i < NumSteps; ++i)
 	{
-		auto NextT = CalculateNextRoughTransform(OutArray.Last(), TimeStep, 0.0f, bCheckCollisions);
+		const auto PrevT = OutArray.Last();
+		FPhysTransform NextT;
+		
+		bOnGroundPlane = bOnGroundPlane && Ground.CanContinue(PrevT, TimeStep);
+		if(bOnGroundPlane)
+		{
+			NextT = PrevT;
+			Ground.Resolve(NextT);
+			NextT = CalculateNextRoughTransform(NextT, TimeStep, 0.0f, Contacts, false);
+		}
+		else
+		{
+			NextT = CalculateNextRoughTransform(PrevT, TimeStep, 0.0f, Contacts, bCheckCollisions);
+			
+			// vertical velocity turned upward: ball has bounced, possibly on flat ground
+			const bool bBounced = PrevT.LinearVelocity.Z < 0.0f && NextT.LinearVelocity.Z > 0.0f;
+			if(bGroundPlaneBounce && bBounced)
+			{
+				bOnGroundPlane = FGroundPlaneContact::Make(this, PhysicsProcessor->SimpleObjects, NextT, TimeStep, Contacts.Solver, Ground);
+			}
+		}
 		OutArray.Add(NextT);
 
 		if(bLimitZ && NextT.Location.Z <= LimitZ) break;
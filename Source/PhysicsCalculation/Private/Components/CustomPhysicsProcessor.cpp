@@ -1,8 +1,10 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Components/CustomPhysicsProcessor.h"
+#include "Async/Async.h"
 #include "Components/AdvancedPhysicsComponent.h"
 #include "DataAssets/PhysicsCache_DataAsset.h"
+#include "DataAssets/SpinMovementParams_DataAsset.h"
 #include "ImpulseDistribution/ImpulseDistributionLib.h"
 #include "Libs/PhysicsCacheLib_old.h"
 #include "Libs/SpinMovementLib.h"
@@ -21,6 +23,25 @@ void UCustomPhysicsProcessor::OnSecondTick()
     }
 }
 
+void UCustomPhysicsProcessor::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    PollSpinMovementCacheBuild();
+}
+
+void UCustomPhysicsProcessor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // workers read target component and progress of this processor
+    if(SpinCacheBuildJob.IsValid())
+    {
+        SpinCacheBuildProgress.Cancel();
+        SpinCacheBuildJob->Wait();
+        SpinCacheBuildJob.Reset();
+        SpinCacheBuildProgress.ClearCancel();
+    }
+    Super::EndPlay(EndPlayReason);
+}
+
 void UCustomPhysicsProcessor::RecalculatePhysicsCache(UAdvancedPhysicsComponent* T)
 {
     if(T->bCalculateTrajectoryCache) CalculatePhysicsCacheTrajectories(T);
@@ -73,9 +94,44 @@ void UCustomPhysicsProcessor::RecalculateImpulseDistributionCache(UAdvancedPhysi
 
 void UCustomPhysicsProcessor::RecalculateSpinMovementCache(UAdvancedPhysicsComponent* Target)
 {
+    if(SpinCacheBuildJob.IsValid()) return;
+    
+    const auto Job = MakeShared<FBallLaunchCacheBuildJob, ESPMode::ThreadSafe>();
+    Job->Init(Target, &SpinCacheBuildProgress);
+    
+    SpinCacheBuildJob = Job;
+    Async(EAsyncExecution::ThreadPool, [Job]()
+    {
+        Job->Run();
+    });
+}
+
+void UCustomPhysicsProcessor::PollSpinMovementCacheBuild()
+{
+    if(!SpinCacheBuildJob.IsValid() || !SpinCacheBuildJob->IsCompleted()) return;
+
+    const auto Job = SpinCacheBuildJob;
+    SpinCacheBuildJob.Reset();
+    
+    const bool bCancelled = SpinCacheBuildProgress.IsCancelled();
+    SpinCacheBuildProgress.ClearCancel();
+    if(bCancelled) return;
+
+    const auto Target = Job->Target;
     const auto Cache = Target->PhysicsCache;
-    Cache->BallLaunchCache_Data = USpinMovementLib::CalculateBallLaunchCache(Target);
+    auto& Data = Job->Data;
+
+    // binary file keeps the asset small; asset copy is used only when no file is configured or saving failed
+    if(Cache->SaveBallLaunchCacheFile(Data, Target->SpinMovementParams->Data))
+    {
+        Cache->BallLaunchCache_Data = FBallLaunchCache_Data();
+    }
+    else
+    {
+        Cache->BallLaunchCache_Data = MoveTemp(Data);
+    }
     Cache->Save();
+    Cache->Refresh();
 }
 
 FPhysCachedTrajectoryFull UCustomPhysicsProcessor::CalculateCachedTrajectory(UAdvancedPhysicsComponent* Target, const FDetailedVector& LinearVelocity,
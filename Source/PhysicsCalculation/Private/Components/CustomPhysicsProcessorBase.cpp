@@ -42,24 +42,53 @@ void UCustomPhysicsProcessorBase::TickComponent(float DeltaTime, ELevelTick Tick
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 	TrackSecondTick();
 	
-	// this part may be refactored if arrays will be made constant (any changes on objects are synchronized with this component)
-	TArray<UCustomPhysicsComponent*> FullObjects;
-	TArray<UCustomPhysicsBaseComponent*> SimplifiedObjects;
-	GetPhysObjArrays(FullObjects, SimplifiedObjects);
+	UpdatePhysObjArrays();
+	Broadphase.Update(ActiveSimplifiedObjects, BroadphaseCellSize);
+	for (const auto Obj : ActiveSimplifiedObjects)
+	{
+		Obj->UpdateCollisionSnapshot();
+	}
+
+	// requests made by gameplay code since previous tick
+	FlushPredictionRecomputes();
+	UpdateCustomPhysics(DeltaTime, ActiveFullObjects, ActiveSimplifiedObjects);
+	// requests made by collisions within substeps
+	FlushPredictionRecomputes();
+}
 
-	UpdateCustomPhysics(DeltaTime, FullObjects, SimplifiedObjects);
+void UCustomPhysicsProcessorBase::FlushPredictionRecomputes() const
+{
+	for (const auto Obj : Objects)
+	{
+		Obj->FlushPredictionRecompute();
+	}
 }
 
-void UCustomPhysicsProcessorBase::GetPhysObjArrays(TArray<UCustomPhysicsComponent*> &FullObjects, TArray<UCustomPhysicsBaseComponent*> &SimplifiedObjects)
+FPredictionRecomputeStats UCustomPhysicsProcessorBase::GetPredictionRecomputeStats() const
 {
-	SimplifiedObjects.Append(SimpleObjects);
+	FPredictionRecomputeStats Stats;
+	for (const auto Obj : Objects)
+	{
+		Stats.Append(Obj->GetPredictionRecomputeStats());
+	}
+	return Stats;
+}
+
+void UCustomPhysicsProcessorBase::UpdatePhysObjArrays()
+{
+	if(!bPhysObjArraysDirty) return;
+	bPhysObjArraysDirty = false;
+
+	ActiveFullObjects.Reset();
+	ActiveSimplifiedObjects.Reset();
+	ActiveSimplifiedObjects.Append(SimpleObjects);
 	for (auto Obj : Objects)
 	{
-		Obj->IsCustomPhysicsEnabled() ? FullObjects.Add(Obj) : SimplifiedObjects.Add(Obj);
+		Obj->IsCustomPhysicsEnabled() ? ActiveFullObjects.Add(Obj) : ActiveSimplifiedObjects.Add(Obj);
 	}
 }
 
-void UCustomPhysicsProcessorBase::UpdateCustomPhysics(float DeltaTime, const TArray<UCustomPhysicsComponent*> &FullObjects, const TArray<UCustomPhysicsBaseComponent*> &SimplifiedObjects) const
+void UCustomPhysicsProcessorBase::UpdateCustomPhysics(float DeltaTime, const TArray<UCustomPhysicsComponent*> &FullObjects, const TArray<UCustomPhysicsBaseComponent*> &SimplifiedObjects)
 {
 	int NumSubsteps = 0;
 	const float Fraction = SplitTimeToSubstepsAndFraction(DeltaTime, NumSubsteps);
@@ -106,20 +135,28 @@ FPSI_Data UCustomPhysicsProcessorBase::MakeDefaultDataForPhysicsIteration(UCusto
 }
 
 void UCustomPhysicsProcessorBase::ProcessPhysicsIteration(const TArray<UCustomPhysicsComponent*>& FullObjects,
-                                                          const TArray<UCustomPhysicsBaseComponent*>& SimplifiedObjects, float DeltaTime) const
+                                                          const TArray<UCustomPhysicsBaseComponent*>& SimplifiedObjects, float DeltaTime)
 {
-	TArray<FPhysTransform> PrevTransforms = {};
-	TArray<FPhysTransform> PredictionTransforms = {};
+	const SIZE_T ScratchSize = Scratch.GetAllocatedSize() + ContactSolver.GetAllocatedSize();
+	auto& PredictionTransforms = Scratch.PredictionTransforms;
+	auto& CollisionPairs = Scratch.CollisionPairs;
+	PredictionTransforms.Reset();
+	CollisionPairs.Reset();
 	
 	for (const auto Obj : FullObjects)
 	{
-		auto TPredict = Obj->SimulateDeltaMovementPredictMode(DeltaTime);
-		PrevTransforms.Add(Obj->CurrentTransform);
-		PredictionTransforms.Add(TPredict);
+		PredictionTransforms.Add(Obj->SimulateDeltaMovementPredictMode(DeltaTime));
 	}
 
-	TArray<FCollisionPair> CollisionPairs;
-	if(UCollisionDetection::FindCollisionsAgainstSphereArray(FullObjects, SimplifiedObjects, CollisionPairs))
+	UCollisionDetection::FindCollisionsAgainstSphereArray(FullObjects, Broadphase, CollisionPairs, Scratch.BroadphaseCandidates);
+	if(ContactSolverIterations > 0)
+	{
+		// solved even without contacts, so warm start cache is dropped once they are gone
+		ContactSolver.NumIterations = ContactSolverIterations;
+		ContactSolver.bWarmStart = bContactSolverWarmStart;
+		ContactSolver.Solve(CollisionPairs);
+	}
+	else
 	{
 		for (auto CollisionPair : CollisionPairs)
 		{
@@ -145,44 +182,46 @@ void UCustomPhysicsProcessorBase::ProcessPhysicsIteration(const TArray<UCustomPh
 		}
 		else
 		{
+			// fast body bounces off first contact within the step instead of passing through thin objects
+			FPhysTransform TSwept;
+			if(UCollisionDetection::SweepSpherePredictMode(Data, Obj->CurrentTransform, TPhys, Broadphase, Scratch.BroadphaseCandidates, Scratch.SweepObjects, TSwept))
+			{
+				TPhys = TSwept;
+				UpdateTransformLock(Obj, TPhys, PredictionTransforms[i].Location, PredictionTransforms[i].Orientation);
+			}
 			Obj->SetCurrentTransform(TPhys, false);
 		}
 
 		Obj->PhysicsParams.Aerodynamics.Sideforce.Update(DeltaTime);
 	}
+
+	if(Scratch.GetAllocatedSize() + ContactSolver.GetAllocatedSize() != ScratchSize) NumScratchReallocations++;
 }
 
-void UCustomPhysicsProcessorBase::PredictTransform(const TArray<UCustomPhysicsBaseComponent*>& StaticBodies, FPSI_Data& Data, FPhysTransform& OutT) const
+void UCustomPhysicsProcessorBase::PredictTransform(const TArray<UCustomPhysicsBaseComponent*>& StaticBodies, FPSI_Data& Data, FPhysPredictionContacts& Contacts,
+                                                   FPhysTransform& OutT) const
 {
-	const auto Obj = Data.Obj;
-	const auto InT = Data.GetTransform();
-	const bool bCheckCollisions = Data.HasCollisions();
-	const FVector InitialLocation = InT.Location;
-	const FQuat InitialOrientation = InT.Orientation;
+	FPredictionBody Body;
+	Body.SetFromObject(Data.Obj);
+	Body.bCheckCollisions = Data.HasCollisions();
+	Body.ContactSolverIterations = ContactSolverIterations;
+	Body.bContactSolverWarmStart = bContactSolverWarmStart;
+	if(Body.bCheckCollisions) Contacts.UpdateColliders(StaticBodies);
 
-	FPhysTransform TCollisionResolve = InT;
-
-	if(bCheckCollisions)
+	// extra forces of object are not part of its sim params, so they are integrated through Data
+	const auto Integrate = [&Data](float DeltaTime, FPhysTransform& InOutT)
 	{
-		TArray<FCollisionPair> CollisionPairs;
-		if(UCollisionDetection::FindCollisionAgainstSpherePredictMode(InitialLocation, Obj, StaticBodies, CollisionPairs))
-		{
-			for (auto CollisionPair : CollisionPairs)
-			{
-				UCollisionDetection::ResolveCustomCollisionAgainstSpherePredictMode(InT, CollisionPair, TCollisionResolve);
-			}
-		}
-	}
-
-	Data.SetTransform(TCollisionResolve);
-	OutT = CalculateNextTransformTimeBased(Data);
-
-	UpdateTransformLock(Obj, OutT, InitialLocation, InitialOrientation);
+		FPSI_Data Step = Data;
+		Step.SetTransform(InOutT);
+		Step.SetDeltaTime(DeltaTime);
+		UPhysicsSimulation::PhysicsSimulateDelta(Step, InOutT);
+	};
+	FPredictionStep::Simulate(Body, Contacts.Colliders, Data.GetDeltaTime(), Integrate, Data.GetTransform(), Contacts.Solver, OutT);
 }
 
-void UCustomPhysicsProcessorBase::PredictTransformAnyTime(FPSI_Data& Data, FPhysTransform& OutT) const
+void UCustomPhysicsProcessorBase::PredictTransformAnyTime(FPSI_Data& Data, FPhysPredictionContacts& Contacts, FPhysTransform& OutT) const
 {
-	PredictTransform(SimpleObjects, Data, OutT);
+	PredictTransform(SimpleObjects, Data, Contacts, OutT);
 }
 
 FPhysTransform UCustomPhysicsProcessorBase::CalculateNextTransformTimeBased(FPSI_Data& Data)
@@ -214,5 +253,12 @@ void UCustomPhysicsProcessorBase::SubscribeNewObject(UCustomPhysicsBaseComponent
 	{
 		if(!SimpleObjects.Contains(Obj)) SimpleObjects.Add(Obj);
 	}
+	MarkPhysObjArraysDirty();
+}
+
+void UCustomPhysicsProcessorBase::UnsubscribeObject(UCustomPhysicsBaseComponent* Obj)
+{
+	const int NumRemoved = Objects.Remove(Cast<UCustomPhysicsComponent>(Obj)) + SimpleObjects.Remove(Obj);
+	if(NumRemoved > 0) MarkPhysObjArraysDirty();
 }
 
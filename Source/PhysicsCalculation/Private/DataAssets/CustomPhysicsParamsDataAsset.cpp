@@ -11,6 +11,8 @@ void UCustomPhysicsParamsDataAsset::FillParamsStruct(FPhysRigidBodyParams& P) co
     P.Aerodynamics = Aerodynamics;
     P.Constrains = Constrains;
     P.Rendering = Rendering;
+    P.Integrator = Integrator;
+    P.bExponentialMapRotation = bExponentialMapRotation;
 
     if(DefaultOverride.bOverride)
     {
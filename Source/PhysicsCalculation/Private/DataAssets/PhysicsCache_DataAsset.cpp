@@ -1,6 +1,8 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "DataAssets/PhysicsCache_DataAsset.h"
+#include "PhysicsCache/BallLaunchCacheBinary.h"
+#include "Misc/Paths.h"
 
 void UPhysicsCache_DataAsset::Refresh()
 {
@@ -18,9 +20,29 @@ void UPhysicsCache_DataAsset::MakeParabolicMotionCacheObj()
 void UPhysicsCache_DataAsset::MakeSpinMovementCacheObj()
 {
     BallLaunchCache = NewObject<UBallLaunchCache>();
+    if(HasBallLaunchCacheFile())
+    {
+        const FString Path = GetBallLaunchCacheFilePath();
+        const int64 MemoryBudget = static_cast<int64>(BallLaunchCacheMemoryBudgetMB) * 1024 * 1024;
+        if(bStreamBallLaunchCache && BallLaunchCache->OpenChunkedFile(Path, MemoryBudget)) return;
+        if(FBallLaunchCacheBinary::LoadFromFile(Path, BallLaunchCache->Data)) return;
+    }
+    
+    BallLaunchCache_Data.ConvertLegacyStorage();
     BallLaunchCache->Data = BallLaunchCache_Data;
 }
 
+FString UPhysicsCache_DataAsset::GetBallLaunchCacheFilePath() const
+{
+    if(FPaths::IsRelative(BallLaunchCacheFile)) return FPaths::Combine(FPaths::ProjectContentDir(), BallLaunchCacheFile);
+    return BallLaunchCacheFile;
+}
+
+bool UPhysicsCache_DataAsset::SaveBallLaunchCacheFile(const FBallLaunchCache_Data& Data, const FSpinMovementParams& Params) const
+{
+    return HasBallLaunchCacheFile() && FBallLaunchCacheBinary::SaveToFile(GetBallLaunchCacheFilePath(), Data, Params, BallLaunchCacheSpeedsPerChunk);
+}
+
 void UPhysicsCache_DataAsset::MakeImpulseDistributionCacheObj()
 {
     ImpulseDistributionCache = NewObject<UImpulseDistributionCache>();
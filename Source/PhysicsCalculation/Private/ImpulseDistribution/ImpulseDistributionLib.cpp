@@ -122,8 +122,17 @@ FImpulseReconstructed UImpulseDistributionLib::GetImpulseFromParabolicAndSpin(UA
     const FVector FrontSpinApplyLocation = COM + CenterToApply.RotateAngleAxis(-FrontSpin, FrontSpinRight);
     const FVector FrontSpinImpulse = QNoSpin.GetForwardVector() * ParabolicImpulsePower;
 
-    const auto TImpact = PC->CalculateImpulseImpactAtLocationOtherCOM(FrontSpinImpulse, FrontSpinApplyLocation, COM,
-        FVector::ZeroVector, bRemoveVelocity,bRemoveVelocity);
+    // impact on ball at rest depends on its params only; live transform is not read, so launch cache workers may call it
+    FPhysTransform TImpact = FPhysTransform(COM, FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+    if(bRemoveVelocity)
+    {
+        UPhysicsSimulation::SimulateAddImpulseAtLocationForSphere2(TImpact.LinearVelocity, TImpact.AngularVelocity, FrontSpinImpulse, PC->PhysicsParams.GetMass(),
+                                                                   FrontSpinApplyLocation, COM, PC->PhysicsParams.GetInertiaTensorInverted());
+    }
+    else
+    {
+        TImpact = PC->CalculateImpulseImpactAtLocationOtherCOM(FrontSpinImpulse, FrontSpinApplyLocation, COM, FVector::ZeroVector, false, false);
+    }
     
     auto ImpulseAfterFrontSpin = ReconstructImpulseFromVelocities(PC, ParabolicVelocity, TImpact.AngularVelocity, COM);
 
@@ -164,6 +173,7 @@ FImpulseReconstructed UImpulseDistributionLib::RotateImpulseZAxis(const FImpulse
     FImpulseReconstructed OutImpulse;
     OutImpulse.Impulse = UHMV::RotateVectorZAxis(ImpulseData.Impulse, AngleDeg);
     OutImpulse.ApplyLocation = UHMV::RotateVectorZAxis(COMToContact, AngleDeg) + COM;
+    OutImpulse.SideforceSeed = ImpulseData.SideforceSeed;
     
     return OutImpulse;
 }
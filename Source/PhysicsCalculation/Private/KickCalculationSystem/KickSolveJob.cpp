@@ -0,0 +1,215 @@
+﻿#include "KickCalculationSystem/KickSolveJob.h"
+#include "Async/Async.h"
+#include "Components/PhysicsComponent.h"
+#include "DataAssets/PhysicsCache_DataAsset.h"
+#include "KickCalculationSystem/KickSystemLib.h"
+#include "Libs/BatchPredictionLib.h"
+
+void FKickTrajectoryBatchJob::Run()
+{
+    UBatchPredictionLib::CalculatePredictionCurvesWithMeta(RbParams, PredictionData, Impacts, Curves);
+    bCompleted = true;
+}
+
+FKickSolveJob::FKickSolveJob(UPhysicsComponent* InPC, const FKickCompData& InData, FOnResult InOnResult)
+    : PC(InPC), Data(InData), OnResult(MoveTemp(InOnResult))
+{
+    check(InPC)
+    LaunchAngle = Data.CacheIterCheckData.GetMinLaunchAngle();
+    
+    PredictionData.SetDeltaTime(InPC->GetRoughPredictSimStep());
+    PredictionData.SetMaxIterations(5000);
+    PredictionData.Limits = Data.PredictionLimits;
+    PredictionData.ExtraData = Data.PredictionExtraData;
+}
+
+bool FKickSolveJob::Step(float BudgetMicroseconds)
+{
+    if(IsDone()) return true;
+    if(!PC.IsValid())
+    {
+        Finish();
+        return true;
+    }
+
+    const int NumResults = Result.GetNum();
+    const double EndTime = FPlatformTime::Seconds() + BudgetMicroseconds * 1e-6;
+    do
+    {
+        switch (Stage)
+        {
+        case EKickSolveStage::LaunchParams:
+            StepLaunchParams();
+            break;
+        case EKickSolveStage::Impacts:
+            StepImpacts();
+            break;
+        case EKickSolveStage::Trajectories:
+            StepTrajectories();
+            break;
+        default:
+            break;
+        }
+    }
+    // nothing to do on this thread while background trajectories are integrated
+    while (!IsDone() && !TrajectoryJob.IsValid() && FPlatformTime::Seconds() < EndTime);
+
+    if(!IsDone() && OnResult && Result.GetNum() != NumResults) OnResult(Result, false);
+    return IsDone();
+}
+
+void FKickSolveJob::RunToCompletion()
+{
+    // job started by earlier steps is waited for; new one would only add thread switch
+    bAllowTrajectoryJob = false;
+    TrajectoryBatchSize = MAX_int32;
+    while (!Step(MAX_flt))
+    {
+        if(TrajectoryJob.IsValid()) FPlatformProcess::Sleep(0.0f);
+    }
+}
+
+void FKickSolveJob::Cancel()
+{
+    if(!IsDone()) Finish();
+}
+
+void FKickSolveJob::StepLaunchParams()
+{
+    UPhysicsComponent* Comp = PC.Get();
+    const auto& IterData = Data.CacheIterCheckData;
+    const int MaxLaunchSpeed_KMpH = IterData.GetMaxLaunchSpeed_KMpH();
+    
+    if(!bLaunchAngleStarted)
+    {
+        if(LaunchAngle > IterData.GetMaxLaunchAngle())
+        {
+            BeginStage(EKickSolveStage::Impacts);
+            return;
+        }
+        LaunchSpeed_KMpH = UKickSystemLib::GetMinLaunchSpeedForAngle_KMpH(Comp, IterData, LaunchAngle);
+        const auto SpinCache = Comp->PhysicsCache->BallLaunchCache;
+        SpinCache->PrefetchLaunchSpeedRange(UHM::FKmph2CMSec(LaunchSpeed_KMpH), UHM::FKmph2CMSec(MaxLaunchSpeed_KMpH));
+        bLaunchAngleStarted = true;
+    }
+
+    if(LaunchSpeed_KMpH > MaxLaunchSpeed_KMpH)
+    {
+        bLaunchAngleStarted = false;
+        LaunchAngle += IterData.GetLaunchAngleDelta();
+        return;
+    }
+    
+    UKickSystemLib::AppendLaunchParamsForSpeed(Comp, IterData, LaunchAngle, LaunchSpeed_KMpH, LaunchParamsSet, Stats);
+    LaunchSpeed_KMpH += IterData.GetLaunchSpeedDelta_KMpH();
+}
+
+void FKickSolveJob::StepImpacts()
+{
+    if(NextItem >= LaunchParamsSet.Num())
+    {
+        BeginStage(EKickSolveStage::Trajectories);
+        return;
+    }
+
+    const FVector VToTarget = Data.CacheIterCheckData.GetVectorToTarget();
+    UKickSystemLib::AppendApplicableImpact(PC.Get(), LaunchParamsSet.Items[NextItem++], VToTarget, ImpactSet, Stats);
+}
+
+void FKickSolveJob::StepTrajectories()
+{
+    if(TrajectoryJob.IsValid())
+    {
+        PollTrajectoryJob();
+        return;
+    }
+    const auto& ImpactArray = ImpactSet.Items;
+    if(NextItem >= ImpactArray.Num())
+    {
+        Finish();
+        return;
+    }
+
+    UPhysicsComponent* Comp = PC.Get();
+    const auto& ExtraData = Data.PredictionExtraData;
+    if(ExtraData.bApplyAllResults)
+    {
+        for (; NextItem < ImpactArray.Num(); ++NextItem)
+        {
+            Result.AddImpactTransform(ImpactArray[NextItem], FPhysicsPredictionCurveWithMeta());
+        }
+        return;
+    }
+    
+    if(!CanBatch())
+    {
+        const auto Impact = ImpactArray[NextItem++];
+        Stats.NumTrajectories++;
+        PredictionData.SetInitialTransform(Impact);
+        UKickSystemLib::CalculateSpecialPrediction(Comp, ExtraData, PredictionData, Impact, Result);
+        return;
+    }
+
+    if(Data.bAsyncTrajectories && bAllowTrajectoryJob)
+    {
+        StartTrajectoryJob();
+        return;
+    }
+
+    const int Num = FMath::Min(TrajectoryBatchSize, ImpactArray.Num() - NextItem);
+    const TArray<FPhysTransform> Batch(ImpactArray.GetData() + NextItem, Num);
+    NextItem += Num;
+    Stats.NumTrajectories += Num;
+    
+    const auto BatchResult = UKickSystemLib::GetKickComputedTrajectoriesFromImpactArrayBatched(Comp, Data.PredictionLimits, ExtraData, Batch,
+                                                                                              Data.BatchValidationTolerance);
+    Result.ImpactTransformArray.Append(BatchResult.ImpactTransformArray);
+    Result.CurveMetaArray.Append(BatchResult.CurveMetaArray);
+}
+
+void FKickSolveJob::StartTrajectoryJob()
+{
+    const auto Job = MakeShared<FKickTrajectoryBatchJob, ESPMode::ThreadSafe>();
+    Job->RbParams = PC->PhysicsParams;
+    Job->PredictionData = PredictionData;
+    const auto& ImpactArray = ImpactSet.Items;
+    Job->Impacts.Append(ImpactArray.GetData() + NextItem, ImpactArray.Num() - NextItem);
+    NextItem = ImpactArray.Num();
+    Stats.NumTrajectories += Job->Impacts.Num();
+
+    TrajectoryJob = Job;
+    Async(EAsyncExecution::ThreadPool, [Job]()
+    {
+        Job->Run();
+    });
+}
+
+void FKickSolveJob::PollTrajectoryJob()
+{
+    if(!TrajectoryJob->IsCompleted()) return;
+
+    const auto Job = TrajectoryJob;
+    TrajectoryJob.Reset();
+    UKickSystemLib::AddApplicableCurves(Data.PredictionExtraData, Job->Impacts, Job->Curves, Result);
+}
+
+void FKickSolveJob::BeginStage(EKickSolveStage NewStage)
+{
+    Stage = NewStage;
+    NextItem = 0;
+}
+
+void FKickSolveJob::Finish()
+{
+    // running trajectory job holds its own input; its result is dropped
+    Stage = EKickSolveStage::Done;
+    TrajectoryJob.Reset();
+    Stats.NumSolutions = Result.GetNum();
+    if(OnResult) OnResult(Result, true);
+}
+
+bool FKickSolveJob::CanBatch() const
+{
+    // batch lanes mirror semi-implicit Euler only
+    return Data.bBatchPrediction && PC->PhysicsParams.Integrator == SemiImplicitEuler;
+}
@@ -1,9 +1,11 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "KickCalculationSystem/KickSystemLib.h"
+#include "KickCalculationSystem/KickSolveJob.h"
 #include "ImpulseDistribution/ImpulseDistributionLib.h"
 #include "DataAssets/PhysicsCache_DataAsset.h"
 #include "HMStructs/FloatMinMax.h"
+#include "Libs/BatchPredictionLib.h"
 #include "Libs/PhysicsSimulation.h"
 #include "Libs/SpinMovementLib.h"
 #include "ColorsLib.h"
@@ -26,7 +28,8 @@ FImpulseReconstructed UKickSystemLib::CalculateKickImpulse(UPhysicsComponent* PC
         const FVector VToCachedLocation = Meta.GetCachedVector() - CurrentLocation;
         const FVector V_ToTarget = Data.GetVectorToTarget();
         const float Angle = UHMV::SignedAngleBetweenVectorsDegXY(VToCachedLocation, V_ToTarget);
-        const auto ImpRotated = UImpulseDistributionLib::RotateImpulseZAxis(ImpReconstructed, CurrentLocation, Angle);
+        auto ImpRotated = UImpulseDistributionLib::RotateImpulseZAxis(ImpReconstructed, CurrentLocation, Angle);
+        ImpRotated.SideforceSeed = PC->MakeNextKickSeed();
         return ImpRotated;        
     }
     return {};
@@ -71,11 +74,10 @@ FKickCompResultTmp UKickSystemLib::KickComputeParabolicWithSpin_prev(UPhysicsCom
 
 FKickCompResultTmp UKickSystemLib::KickComputePossibleImpact(UPhysicsComponent* PC, const FKickCompData& Data)
 {
-    const FSpinCacheIterCheckData IterData = Data.CacheIterCheckData;
-    const auto LaunchParamsArray = MakeLaunchParamsArray(PC, IterData);
-    const FVector VToTarget = IterData.GetVectorToTarget();
-    const auto ImpactArray = CalculateApplicableImpactDataCacheBased(PC, LaunchParamsArray, VToTarget);
-    const auto Result = GetKickComputedTrajectoriesFromImpactArray(PC, Data.PredictionLimits, Data.PredictionExtraData, ImpactArray);
+    // same pipeline as budgeted solve, without time limit; scalar prediction unless Data.bBatchPrediction is set
+    FKickSolveJob Job(PC, Data);
+    Job.RunToCompletion();
+    const auto& Result = Job.GetResult();
     DisplayComputedTrajectories(PC, Data, Result);
     return Result;
 }
@@ -209,6 +211,50 @@ FKickCompResultTmp UKickSystemLib::GetKickComputedTrajectoriesFromImpactArray(UP
     return Out;
 }
 
+FKickCompResultTmp UKickSystemLib::GetKickComputedTrajectoriesFromImpactArrayBatched(UPhysicsComponent* PC, const FSpecialPrediction_Limits& Limits,
+                                                                                     const FSpecialPrediction_ExtraData& ExtraData, const TArray<FPhysTransform>& ImpactArray, float ValidationTolerance)
+{
+    FKickCompResultTmp Out;
+
+    if(ExtraData.bApplyAllResults)
+    {
+        for (auto Impact : ImpactArray) Out.AddImpactTransform(Impact, FPhysicsPredictionCurveWithMeta());
+        return Out;
+    }
+    
+    FPhysCurveSpecialPrediction PredictionData;
+    PredictionData.SetDeltaTime(PC->GetRoughPredictSimStep());
+    PredictionData.SetMaxIterations(5000);
+    PredictionData.Limits = Limits;
+    PredictionData.ExtraData = ExtraData;
+
+    TArray<FPhysicsPredictionCurveWithMeta> Curves;
+    UBatchPredictionLib::CalculatePredictionCurvesWithMeta(PC, PredictionData, ImpactArray, Curves);
+
+    if(ValidationTolerance > 0.0f)
+    {
+        UBatchPredictionLib::ValidateAgainstScalar(PC, PredictionData, ImpactArray, Curves, ValidationTolerance);
+    }
+
+    AddApplicableCurves(ExtraData, ImpactArray, Curves, Out);
+    return Out;
+}
+
+void UKickSystemLib::AddApplicableCurves(const FSpecialPrediction_ExtraData& ExtraData, const TArray<FPhysTransform>& ImpactArray,
+                                         const TArray<FPhysicsPredictionCurveWithMeta>& Curves, FKickCompResultTmp& Out)
+{
+    const float Min = ExtraData.GetMinZ();
+    const float Max = ExtraData.GetMaxZ();
+    for (int i = 0; i < ImpactArray.Num(); ++i)
+    {
+        const auto& CompResult = Curves[i];
+        if(CompResult.IsVectorCached() && UHM::IsFloatInRange(CompResult.GetCachedVectorZ(), Min, Max))
+        {
+            Out.AddImpactTransform(ImpactArray[i], CompResult);
+        }
+    }
+}
+
 FKickCompResultTmp UKickSystemLib::RotateImpactTransformsToKickTarget(UPhysicsComponent* PC, const FKickCompResultTmp& Data, FVector KickTarget)
 {
     FKickCompResultTmp Out = Data;
@@ -235,20 +281,67 @@ FKickCompResultTmp UKickSystemLib::RotateImpactTransformsToKickTarget(UPhysicsCo
 
 TArray<FBallLaunchParams> UKickSystemLib::MakeLaunchParamsArray(UPhysicsComponent* PC, const FSpinCacheIterCheckData& Data)
 {
-    const auto ParabolicCache = PC->PhysicsCache->ParabolicMotionCache;
-    const auto SpinCache = PC->PhysicsCache->BallLaunchCache;
-    const auto SpinCacheParams = &PC->SpinMovementParams->Data;
+    FKickCandidateStats Stats;
+    return MakeLaunchParamsArray(PC, Data, Stats);
+}
 
-    const int MinParabolicCachedAngle = ParabolicCache->GetMinLaunchAngle();
-    
-    // passed
-    
-    const FVector VToTarget = Data.GetVectorToTarget();
+TArray<FBallLaunchParams> UKickSystemLib::MakeLaunchParamsArray(UPhysicsComponent* PC, const FSpinCacheIterCheckData& Data, FKickCandidateStats& OutStats)
+{
+    const auto SpinCache = PC->PhysicsCache->BallLaunchCache;
 
     const int MinLaunchAngle = Data.GetMinLaunchAngle();
     const int MaxLaunchAngle = Data.GetMaxLaunchAngle();
     const int LaunchAngleDelta = Data.GetLaunchAngleDelta();
 
+    const int MaxLaunchSpeed_KMpH = Data.GetMaxLaunchSpeed_KMpH();
+    const int LaunchSpeedDelta_KMpH = Data.GetLaunchSpeedDelta_KMpH();
+
+    FKickLaunchParamsSet Out;
+    
+    // todo: clamp values by max in each loop
+    
+    for (int launch_angle = MinLaunchAngle; launch_angle <= MaxLaunchAngle; launch_angle += LaunchAngleDelta)
+    {
+        const int MinLaunchSpeed_KMpH = GetMinLaunchSpeedForAngle_KMpH(PC, Data, launch_angle);
+
+        // chunked cache reads bands of this angle in background while lower speeds are checked
+        SpinCache->PrefetchLaunchSpeedRange(UHM::FKmph2CMSec(MinLaunchSpeed_KMpH), UHM::FKmph2CMSec(MaxLaunchSpeed_KMpH));
+        
+        for (int launch_speed_kmph = MinLaunchSpeed_KMpH; launch_speed_kmph <= MaxLaunchSpeed_KMpH; launch_speed_kmph += LaunchSpeedDelta_KMpH)
+        {
+            AppendLaunchParamsForSpeed(PC, Data, launch_angle, launch_speed_kmph, Out, OutStats);
+        }
+    }
+    
+    return MoveTemp(Out.Items);
+}
+
+int UKickSystemLib::GetMinLaunchSpeedForAngle_KMpH(UPhysicsComponent* PC, const FSpinCacheIterCheckData& Data, int LaunchAngle)
+{
+    const auto ParabolicCache = PC->PhysicsCache->ParabolicMotionCache;
+    const auto SpinCacheParams = &PC->SpinMovementParams->Data;
+    
+    int MinLaunchSpeed_KMpH = Data.GetMinLaunchSpeed_KMpH();
+    if(LaunchAngle >= ParabolicCache->GetMinLaunchAngle())
+    {
+        const float ParabolicSpeed = PC->GetRealRequiredParabolicSpeedForAngle(LaunchAngle, Data.GetVectorToTarget());
+        const float ParabolicSpeedKMpH = UHM::FCMSec2Kmph(ParabolicSpeed);
+        if(ParabolicSpeedKMpH > MinLaunchSpeed_KMpH)
+        {
+            MinLaunchSpeed_KMpH = SpinCacheParams->GetLaunchSpeedSnappedToGrid_KMpH(ParabolicSpeedKMpH);
+        }
+    }
+    return MinLaunchSpeed_KMpH;
+}
+
+void UKickSystemLib::AppendLaunchParamsForSpeed(UPhysicsComponent* PC, const FSpinCacheIterCheckData& Data, int LaunchAngle, int LaunchSpeed_KMpH,
+                                                FKickLaunchParamsSet& Out, FKickCandidateStats& Stats)
+{
+    const auto SpinCache = PC->PhysicsCache->BallLaunchCache;
+    const auto SpinCacheParams = &PC->SpinMovementParams->Data;
+    
+    const FVector VToTarget = Data.GetVectorToTarget();
+
     const int MinFrontSpinAngle = Data.GetMinFrontSpinAngle();
     const int MaxFrontSpinAngle = Data.GetMaxFrontSpinAngle();
     const int FrontSpinAngleDelta = Data.GetFrontSpinAngleDelta();
@@ -256,73 +349,74 @@ TArray<FBallLaunchParams> UKickSystemLib::MakeLaunchParamsArray(UPhysicsComponen
     const int MinSideSpinAngle = Data.GetMinSideSpinAngle();
     const int MaxSideSpinAngle = Data.GetMaxSideSpinAngle();
     const int SideSpinAngleDelta = Data.GetSideSpinAngleDelta();
-
-    const int MinLaunchSpeedPassed_KMpH = Data.GetMinLaunchSpeed_KMpH();
-    const int MaxLaunchSpeed_KMpH = Data.GetMaxLaunchSpeed_KMpH();
-    const int LaunchSpeedDelta_KMpH = Data.GetLaunchSpeedDelta_KMpH();
-    
-    //
     
     const float DistanceXY = VToTarget.Size2D() * 1.01f;
     const float DistanceZ = VToTarget.Z;
     constexpr float AbsDerivationZ = 0.0f;
     constexpr float MulDistanceXY = 1.01f;
-
-    TArray<FBallLaunchParams> Out = {};
     
-    // todo: clamp values by max in each loop
+    const auto NumAxisSteps = [](int Min, int Max, int Delta) {return Delta > 0 && Max >= Min ? (Max - Min) / Delta + 1 : 0;};
+    const int NumSideSpins = NumAxisSteps(MinSideSpinAngle, MaxSideSpinAngle, SideSpinAngleDelta);
+    const int NumSlabItems = NumAxisSteps(MinFrontSpinAngle, MaxFrontSpinAngle, FrontSpinAngleDelta) * NumSideSpins;
+    Stats.NumGenerated += NumSlabItems;
     
-    for (int launch_angle = MinLaunchAngle; launch_angle <= MaxLaunchAngle; launch_angle += LaunchAngleDelta)
+    const float launch_speed_cm_sec = UHM::FKmph2CMSec(LaunchSpeed_KMpH);
+    const auto SlabParams = FBallLaunchParams(launch_speed_cm_sec, LaunchAngle, 0.0f, 0.0f);
+    if(!SpinCache->CanSlabReachTarget(SlabParams, 2, DistanceXY, DistanceZ, AbsDerivationZ, MulDistanceXY))
+    {
+        Stats.NumPrunedBySlab += NumSlabItems;
+        return;
+    }
+    
+    for (int front_spin_angle = MinFrontSpinAngle; front_spin_angle <= MaxFrontSpinAngle; front_spin_angle += FrontSpinAngleDelta)
     {
-        int MinLaunchSpeed_KMpH = MinLaunchSpeedPassed_KMpH;
-        if(launch_angle >= MinParabolicCachedAngle)
+        const auto RowParams = FBallLaunchParams(launch_speed_cm_sec, LaunchAngle, front_spin_angle, 0.0f);
+        if(!SpinCache->CanSlabReachTarget(RowParams, 3, DistanceXY, DistanceZ, AbsDerivationZ, MulDistanceXY))
         {
-            const float ParabolicSpeed = PC->GetRealRequiredParabolicSpeedForAngle(launch_angle, VToTarget);
-            const float ParabolicSpeedKMpH = UHM::FCMSec2Kmph(ParabolicSpeed);
-            if(ParabolicSpeedKMpH > MinLaunchSpeed_KMpH)
-            {
-                MinLaunchSpeed_KMpH = SpinCacheParams->GetLaunchSpeedSnappedToGrid_KMpH(ParabolicSpeedKMpH);
-            }
+            Stats.NumPrunedByFrontSpin += NumSideSpins;
+            continue;
         }
         
-        for (int launch_speed_kmph = MinLaunchSpeed_KMpH; launch_speed_kmph <= MaxLaunchSpeed_KMpH; launch_speed_kmph += LaunchSpeedDelta_KMpH)
+        for (int side_spin_angle = MinSideSpinAngle; side_spin_angle <= MaxSideSpinAngle; side_spin_angle += SideSpinAngleDelta)
         {
-            for (int front_spin_angle = MinFrontSpinAngle; front_spin_angle <= MaxFrontSpinAngle; front_spin_angle += FrontSpinAngleDelta)
+            auto LaunchParams = FBallLaunchParams(launch_speed_cm_sec, LaunchAngle, front_spin_angle, side_spin_angle);
+
+            const bool CanUseLaunchParams = SpinCacheParams->CanUseLaunchParams(LaunchParams);
+            if(!CanUseLaunchParams)
             {
-                for (int side_spin_angle = MinSideSpinAngle; side_spin_angle <= MaxSideSpinAngle; side_spin_angle += SideSpinAngleDelta)
-                {
-                    const float launch_speed_cm_sec = UHM::FKmph2CMSec(launch_speed_kmph);
-                    auto LaunchParams = FBallLaunchParams(launch_speed_cm_sec, launch_angle, front_spin_angle, side_spin_angle);
-
-                    const bool CanUseLaunchParams = SpinCacheParams->CanUseLaunchParams(LaunchParams);
-                    if(!CanUseLaunchParams) continue;
-
-                    const bool bReaching = SpinCache->CanInputReachTarget(LaunchParams, DistanceXY, DistanceZ, AbsDerivationZ, MulDistanceXY);
-                    if(bReaching && !Out.Contains(LaunchParams))
-                    {
-                        Out.Add(LaunchParams);
-                    }
-                }
+                Stats.NumRejectedByParams++;
+                continue;
             }
+
+            Stats.NumEvaluated++;
+            const bool bReaching = SpinCache->CanInputReachTarget(LaunchParams, DistanceXY, DistanceZ, AbsDerivationZ, MulDistanceXY);
+            if(!bReaching) continue;
+            
+            if(Out.Add(LaunchParams)) Stats.NumLaunchParams++;
+            else Stats.NumDuplicateLaunchParams++;
         }
     }
-    
-    return Out;
 }
 
 TArray<FPhysTransform> UKickSystemLib::CalculateApplicableImpactDataCacheBased(UPhysicsComponent* PC, const TArray<FBallLaunchParams>& Data, FVector VToTarget)
 {
-    TArray<FPhysTransform> Out = {};
+    FKickImpactSet Out;
+    FKickCandidateStats Stats;
 
     for (auto LaunchParams : Data)
     {
-        constexpr bool bRemoveVelocities = true;
-        auto TImpact = BallLaunchParamsToImpact(PC, LaunchParams, VToTarget, bRemoveVelocities);
-        const bool HasSameImpact = Out.Contains(TImpact);
-        if(!HasSameImpact)  Out.Add(TImpact);
+        AppendApplicableImpact(PC, LaunchParams, VToTarget, Out, Stats);
     }
     
-    return Out;
+    return MoveTemp(Out.Items);
+}
+
+void UKickSystemLib::AppendApplicableImpact(UPhysicsComponent* PC, const FBallLaunchParams& LaunchParams, FVector VToTarget, FKickImpactSet& Out, FKickCandidateStats& Stats)
+{
+    constexpr bool bRemoveVelocities = true;
+    auto TImpact = BallLaunchParamsToImpact(PC, LaunchParams, VToTarget, bRemoveVelocities);
+    if(Out.Add(TImpact)) Stats.NumImpacts++;
+    else Stats.NumDuplicateImpacts++;
 }
 
 FPhysTransform UKickSystemLib::BallLaunchParamsToImpact(UPhysicsComponent* PC, const FBallLaunchParams& P, FVector VToTarget, bool bRemoveVelocities)
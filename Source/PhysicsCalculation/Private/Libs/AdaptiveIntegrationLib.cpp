@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Libs/AdaptiveIntegrationLib.h"
+#include "Common/PhysSimParams.h"
+#include "Libs/MathUtils.h"
+#include "Libs/PhysicsSimulation.h"
+
+namespace DormandPrince
+{
+    constexpr float A21 = 1.0f / 5.0f;
+    constexpr float A31 = 3.0f / 40.0f, A32 = 9.0f / 40.0f;
+    constexpr float A41 = 44.0f / 45.0f, A42 = -56.0f / 15.0f, A43 = 32.0f / 9.0f;
+    constexpr float A51 = 19372.0f / 6561.0f, A52 = -25360.0f / 2187.0f, A53 = 64448.0f / 6561.0f, A54 = -212.0f / 729.0f;
+    constexpr float A61 = 9017.0f / 3168.0f, A62 = -355.0f / 33.0f, A63 = 46732.0f / 5247.0f, A64 = 49.0f / 176.0f, A65 = -5103.0f / 18656.0f;
+    
+    // fifth order weights (also last stage coefficients - first same as last)
+    constexpr float B1 = 35.0f / 384.0f, B3 = 500.0f / 1113.0f, B4 = 125.0f / 192.0f, B5 = -2187.0f / 6784.0f, B6 = 11.0f / 84.0f;
+    
+    // difference between fifth and fourth order weights
+    constexpr float E1 = 71.0f / 57600.0f, E3 = -71.0f / 16695.0f, E4 = 71.0f / 1920.0f, E5 = -17253.0f / 339200.0f, E6 = 22.0f / 525.0f, E7 = -1.0f / 40.0f;
+}
+
+FPhysTransform FAdaptiveFlightSegment::Sample(float Time) const
+{
+    if(Time <= 0.0f || Duration <= 0.0f) return Start;
+    if(Time >= Duration) return End;
+
+    const float S = Time / Duration;
+    const float S2 = S * S;
+    const float S3 = S2 * S;
+    const float H00 = 2.0f * S3 - 3.0f * S2 + 1.0f;
+    const float H10 = (S3 - 2.0f * S2 + S) * Duration;
+    const float H01 = -2.0f * S3 + 3.0f * S2;
+    const float H11 = (S3 - S2) * Duration;
+
+    FPhysTransform Out = Start;
+    Out.Location = H00 * Start.Location + H10 * Start.LinearVelocity + H01 * End.Location + H11 * End.LinearVelocity;
+    Out.LinearVelocity = H00 * Start.LinearVelocity + H10 * StartAcceleration + H01 * End.LinearVelocity + H11 * EndAcceleration;
+    Out.AngularVelocity = FMath::Lerp(Start.AngularVelocity, End.AngularVelocity, S);
+    // slerp to end is wrong for fast spin (several turns per step)
+    UMathUtils::ApplyAngularVelocityToRotationExpMap(Start.AngularVelocity, Time, Out.Orientation);
+    return Out;
+}
+
+FVector UAdaptiveIntegrationLib::GetAcceleration(const FPhysSimParams& SimParams, const FVector& LinearVelocity, const FVector& AngularVelocity)
+{
+    FVector Out = UPhysicsSimulation::GetLinearAcceleration(SimParams, LinearVelocity, AngularVelocity);
+    if(SimParams.bLinearDamping)
+    {
+        Out -= SimParams.LinearDamping * LinearVelocity;
+    }
+    return Out;
+}
+
+float UAdaptiveIntegrationLib::StepDormandPrince(const FPhysSimParams& SimParams, const FPhysTransform& T, const FVector& Acceleration, float DeltaTime,
+                                                 FPhysTransform& OutT, FVector& OutAcceleration)
+{
+    using namespace DormandPrince;
+    
+    // forces do not depend on location, so location derivative of each stage is its velocity
+    const float H = DeltaTime;
+    const FVector W = T.AngularVelocity;
+    
+    const FVector V1 = T.LinearVelocity;
+    const FVector& K1 = Acceleration;
+    const FVector V2 = V1 + H * (A21 * K1);
+    const FVector K2 = GetAcceleration(SimParams, V2, W);
+    const FVector V3 = V1 + H * (A31 * K1 + A32 * K2);
+    const FVector K3 = GetAcceleration(SimParams, V3, W);
+    const FVector V4 = V1 + H * (A41 * K1 + A42 * K2 + A43 * K3);
+    const FVector K4 = GetAcceleration(SimParams, V4, W);
+    const FVector V5 = V1 + H * (A51 * K1 + A52 * K2 + A53 * K3 + A54 * K4);
+    const FVector K5 = GetAcceleration(SimParams, V5, W);
+    const FVector V6 = V1 + H * (A61 * K1 + A62 * K2 + A63 * K3 + A64 * K4 + A65 * K5);
+    const FVector K6 = GetAcceleration(SimParams, V6, W);
+    const FVector V7 = V1 + H * (B1 * K1 + B3 * K3 + B4 * K4 + B5 * K5 + B6 * K6);
+    const FVector K7 = GetAcceleration(SimParams, V7, W);
+
+    OutT = T;
+    OutT.Location += H * (B1 * V1 + B3 * V3 + B4 * V4 + B5 * V5 + B6 * V6);
+    OutT.LinearVelocity = V7;
+
+    const FVector LocationError = H * (E1 * V1 + E3 * V3 + E4 * V4 + E5 * V5 + E6 * V6 + E7 * V7);
+    const FVector VelocityError = H * (E1 * K1 + E3 * K3 + E4 * K4 + E5 * K5 + E6 * K6 + E7 * K7);
+
+    if(SimParams.bAngularDamping)
+    {
+        OutT.AngularVelocity *= FMath::Exp(-SimParams.AngularDamping * H);
+    }
+    UPhysicsSimulation::ApplyConstrains(SimParams.Constrains, OutT);
+    UPhysicsSimulation::UpdateTransformOrientation(SimParams, H, OutT);
+
+    const bool bVelocityChanged = OutT.LinearVelocity != V7 || OutT.AngularVelocity != W;
+    OutAcceleration = bVelocityChanged ? GetAcceleration(SimParams, OutT.LinearVelocity, OutT.AngularVelocity) : K7;
+    
+    // velocity error turns into location error during next step
+    return LocationError.Size() + VelocityError.Size() * H;
+}
+
+int UAdaptiveIntegrationLib::AdvanceSegment(const FPhysSimParams& SimParams, const FAdaptiveStepSettings& Settings, const FPhysTransform& T,
+                                            const FVector& Acceleration, float Quantum, int MaxQuanta, float& InOutStep, FAdaptiveFlightSegment& Out, FAdaptiveStepStats* Stats)
+{
+    check(Quantum > 0.0f)
+    
+    const float Tolerance = FMath::Max(Settings.Tolerance, KINDA_SMALL_NUMBER);
+    int LastQuanta = FMath::Max(1, MaxQuanta) + 1;
+
+    for(;;)
+    {
+        // every rejection strictly shortens the step, so loop ends at single quantum at most
+        const int NumQuanta = FMath::Clamp(FMath::FloorToInt(InOutStep / Quantum), 1, LastQuanta - 1);
+        const float H = NumQuanta * Quantum;
+        
+        FPhysTransform End;
+        FVector EndAcceleration;
+        const float Ratio = StepDormandPrince(SimParams, T, Acceleration, H, End, EndAcceleration) / Tolerance;
+
+        const float Factor = Ratio > KINDA_SMALL_NUMBER ? FMath::Clamp(0.9f * FMath::Pow(Ratio, -0.2f), 0.2f, 5.0f) : 5.0f;
+        InOutStep = FMath::Min(H * Factor, FMath::Max(Settings.MaxStep, Quantum));
+
+        if(Ratio <= 1.0f || NumQuanta == 1)
+        {
+            Out.Duration = H;
+            Out.Start = T;
+            Out.End = End;
+            Out.StartAcceleration = Acceleration;
+            Out.EndAcceleration = EndAcceleration;
+            if(Stats) Stats->NumAccepted++;
+            return NumQuanta;
+        }
+        
+        if(Stats) Stats->NumRejected++;
+        LastQuanta = NumQuanta;
+    }
+}
+
+TArray<FPhysTransform> UAdaptiveIntegrationLib::SimulateWithFixedOutput(const FPhysSimParams& SimParams, const FAdaptiveStepSettings& Settings, const FPhysTransform& T,
+                                                                       float OutputStep, int NumSteps, bool bLimitZ, float LimitZ, FAdaptiveStepStats* Stats)
+{
+    TArray<FPhysTransform> Out = {T};
+    if(NumSteps < 2 || OutputStep <= 0.0f) return Out;
+    Out.Reserve(NumSteps);
+
+    FPhysTransform Current = T;
+    FVector Acceleration = GetAcceleration(SimParams, Current.LinearVelocity, Current.AngularVelocity);
+    float Step = FMath::Max(Settings.InitialStep, OutputStep);
+
+    while(Out.Num() < NumSteps)
+    {
+        FAdaptiveFlightSegment Segment;
+        const int NumQuanta = AdvanceSegment(SimParams, Settings, Current, Acceleration, OutputStep, NumSteps - Out.Num(), Step, Segment, Stats);
+        
+        for (int i = 1; i <= NumQuanta; ++i)
+        {
+            const auto Sample = Segment.Sample(i * OutputStep);
+            Out.Add(Sample);
+            if(bLimitZ && Sample.Location.Z <= LimitZ) return Out;
+        }
+
+        Current = Segment.End;
+        Acceleration = Segment.EndAcceleration;
+    }
+    
+    return Out;
+}
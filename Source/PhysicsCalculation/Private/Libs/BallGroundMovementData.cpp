@@ -1,7 +1,10 @@
 ﻿#include "Libs/BallGroundMovementData.h"
 #include "HandyMathLibrary.h"
+#include "Aerodynamics/AeroCoefficientTable.h"
 #include "Libs/PhysicsSimulation.h"
+#include "Common/PhysSimParams.h"
 #include "Common/PhysTransform.h"
+#include "Common/RoughPredictionJob.h"
 
 float FBallGroundMovementData::GetInitialVelocityFromEndVelocity(float EndVelocity, float Time)
 {
@@ -29,9 +32,7 @@ float FBallGroundMovementData::GetInitialVelocityDistancePassedVelocity(float Di
 		int StartIndex;
 		if(UHM::FloatBinSearchSum(DistanceDeltaArr, DistanceToPass, Steps, AbsToleranceDistanceSel, StartIndex))
 		{
-			// compensate shifting
-			StartIndex -= 2;
-			if (StartIndex < 0) StartIndex = 0;
+			// delta of item starts at the same item of LinVelXY
 			return LinVelXY[StartIndex]; 
 		}
 	}
@@ -45,71 +46,283 @@ float FBallGroundMovementData::GetNumSteps(float Time) const
 
 void FBallGroundMovementData::Simulate(FPhysRigidBodyParams P, float Time_Step)
 {
-	return;
-	
 	TimeStep = Time_Step;
+	Radius = P.Radius;
+	Mass = P.GetMass();
+	Gravity = P.bGravityEnabled ? FMath::Abs(P.GravityZ) : 0.0f;
+	InertiaInv = P.GetInertiaTensorInverted();
+	
+	const FVector Arm = FVector(0, 0, -Radius);
+	const float AngularEffect = UPhysicsSimulation::CalcInertiaEffect(InertiaInv, Arm, FVector::ForwardVector) | FVector::ForwardVector;
+	SlipDecelerationMul = Mass * (P.GetMassInv() + AngularEffect);
 
-	// cm/sec
-
-	float MinVel = 10;
-	float StartVel = 50000;
-
-	FVector StartLocation = FVector(0, 0, P.Radius);
-	FVector StartVelocity = FVector(StartVel, 0, 0);
-	FPhysTransform TPrev = FPhysTransform(StartLocation, FQuat::Identity, StartVelocity, FVector::ZeroVector);
-
-	LinVelXY.Add(StartVel);
+	LinVelXY.Reset();
+	DistanceDeltaArr.Reset();
+	DistanceArr.Reset();
+	if(TimeStep <= 0.0f || Radius <= 0.0f) return;
 
-	bool DoComp = true;
-	int StepsPassed = 0;
+	FRoughPredictionInput In;
+	MakeGroundContactInput(P, GroundFriction, GroundRestitution, TimeStep, In);
+	In.ContactSolverIterations = ContactSolverIterations;
+	In.bContactSolverWarmStart = bContactSolverWarmStart;
+	const FPhysSimParams SimParams(In.RbParams);
+	FContactSolver Solver;
 
-	float DistanceSum = 0;
+	// cm/sec
+	
+	// table holds rolling only, so it starts without slip
+	FPhysTransform TPrev = FPhysTransform(FVector(0, 0, Radius), FQuat::Identity, FVector(StartVelocity, 0, 0), FVector(0, StartVelocity / Radius, 0));
+	LinVelXY.Add(StartVelocity);
+	DistanceArr.Add(0.0f);
 
-	while (DoComp)
+	// ball is moved back to origin every step, so location precision does not limit long rolls
+	double DistanceSum = 0.0;
+	const int NumSteps = FMath::Min(MaxCompSteps, FMath::CeilToInt(MaxTime / TimeStep));
+	for (int i = 0; i < NumSteps; ++i)
 	{
-		constexpr float SkipTime = 0;
-		constexpr bool bApplyExtraForces = false;
 		FPhysTransform TNew;
-		// UPhysicsSimulation::PhysicsSimulateDelta(TPrev, P, TimeStep, SkipTime, bApplyExtraForces, TNew);
+		FRoughPredictionJob::SimulateStep(In, SimParams, TPrev, Solver, TNew);
+		DistanceSum += TNew.Location.X;
+		TNew.Location.X = 0.0f;
 		TPrev = TNew;
 
 		// add velocity
 		
-		FVector VL = TPrev.LinearVelocity;
-		VelocityArr.Add(VL);
-		VL.Z = 0;		
-		
-		float V = VL.X;
-		LinVelXY.Add(V);
+		const float V = TPrev.LinearVelocity.X;
+		LinVelXY.Add(V > MinVelocity ? V : 0.0f);
 
 		// add location
-
-		const float DistanceFull = TPrev.Location.X;
-		float DistDelta = DistanceFull - DistanceSum;
-		if(DistanceSum > 0.0f)
-		{
-			DistanceDeltaArr.Add(DistDelta);
-		}
-		DistanceSum += DistDelta;
 		
+		DistanceDeltaArr.Add(static_cast<float>(DistanceSum) - DistanceArr.Last());
+		DistanceArr.Add(static_cast<float>(DistanceSum));
+
 		// check exit
 		
-		if (V <= MinVel)
-		{
-			DoComp = false;
-		}
-
-		StepsPassed++;
-		if (StepsPassed >= MaxCompSteps)
-		{
-			DoComp = false;
-		}
+		if (V <= MinVelocity) break;
 	}
-	
-	LinVelXY.Add(0);
 }
 
 void FBallGroundMovementData::Simulate(FPhysRigidBodyParams P)
 {
 	Simulate(P, TimeStep);
 }
+
+float FBallGroundMovementData::GetRollSpeedAfterTime(float StartSpeed, float Time) const
+{
+	if(!IsValid()) return 0.0f;
+	return GetSpeedAtIndex(GetIndexOfSpeed(StartSpeed) + Time / TimeStep);
+}
+
+float FBallGroundMovementData::GetRollDistanceAfterTime(float StartSpeed, float Time) const
+{
+	if(!IsValid()) return 0.0f;
+	const float StartIndex = GetIndexOfSpeed(StartSpeed);
+	return GetDistanceAtIndex(StartIndex + Time / TimeStep) - GetDistanceAtIndex(StartIndex);
+}
+
+float FBallGroundMovementData::GetRollTimeToDistance(float StartSpeed, float Distance) const
+{
+	if(!IsValid()) return -1.0f;
+	const float StartIndex = GetIndexOfSpeed(StartSpeed);
+	const float EndIndex = GetIndexOfDistance(GetDistanceAtIndex(StartIndex) + Distance);
+	return EndIndex < 0.0f ? -1.0f : (EndIndex - StartIndex) * TimeStep;
+}
+
+float FBallGroundMovementData::GetRollStopDistance(float StartSpeed) const
+{
+	if(!IsValid()) return 0.0f;
+	return DistanceArr.Last() - GetDistanceAtIndex(GetIndexOfSpeed(StartSpeed));
+}
+
+FVector FBallGroundMovementData::GetContactSlip(const FPhysTransform& T) const
+{
+	FVector Slip = T.LinearVelocity + (T.AngularVelocity ^ FVector(0, 0, -Radius));
+	Slip.Z = 0.0f;
+	return Slip;
+}
+
+float FBallGroundMovementData::GetSlideTime(float SlipSpeed, float Friction) const
+{
+	return UHM::SafeDivision(SlipSpeed, Friction * Gravity * SlipDecelerationMul);
+}
+
+void FBallGroundMovementData::AdvanceOnGround(const FPhysTransform& T, float Time, float Friction, FPhysTransform& OutT) const
+{
+	OutT = T;
+	OutT.LinearVelocity.Z = 0.0f;
+	if(Time <= 0.0f || !IsValid()) return;
+
+	const FVector Slip = GetContactSlip(T);
+	const float SlipSpeed = Slip.Size();
+	const float Deceleration = Friction * Gravity;
+	if(SlipSpeed > KINDA_SMALL_NUMBER && Deceleration <= 0.0f)
+	{
+		// nothing turns sliding into rolling
+		OutT.Location += OutT.LinearVelocity * Time;
+		return;
+	}
+	
+	float SlideTime = 0.0f;
+	if(SlipSpeed > KINDA_SMALL_NUMBER)
+	{
+		// friction opposes slip, which keeps its direction for body with equal principal moments
+		SlideTime = FMath::Min(GetSlideTime(SlipSpeed, Friction), Time);
+		const FVector SlipDir = Slip / SlipSpeed;
+		const FVector AngularAcceleration = InertiaInv.MultiplyByVector(FVector(0, 0, -Radius) ^ (-SlipDir * Mass * Deceleration));
+		const FVector StartAngularVelocity = OutT.AngularVelocity;
+		
+		OutT.Location += OutT.LinearVelocity * SlideTime - SlipDir * (0.5f * Deceleration * SlideTime * SlideTime);
+		OutT.LinearVelocity -= SlipDir * (Deceleration * SlideTime);
+		OutT.AngularVelocity += AngularAcceleration * SlideTime;
+		UMathUtils::ApplyAngularVelocityToRotationExpMap(0.5f * (StartAngularVelocity + OutT.AngularVelocity), SlideTime, OutT.Orientation);
+	}
+
+	if(SlideTime < Time) AdvanceRolling(Time - SlideTime, OutT);
+}
+
+void FBallGroundMovementData::AdvanceRolling(float Time, FPhysTransform& InOutT) const
+{
+	const float SpinZ = InOutT.AngularVelocity.Z;
+	const FVector Velocity = FVector(InOutT.LinearVelocity.X, InOutT.LinearVelocity.Y, 0.0f);
+	const float Speed = Velocity.Size();
+	if(Speed <= MinVelocity)
+	{
+		InOutT.LinearVelocity = FVector::ZeroVector;
+		InOutT.AngularVelocity = FVector(0, 0, SpinZ);
+		return;
+	}
+
+	const FVector Dir = Velocity / Speed;
+	const float StartIndex = GetIndexOfSpeed(Speed);
+	const float EndIndex = StartIndex + Time / TimeStep;
+	const float Distance = GetDistanceAtIndex(EndIndex) - GetDistanceAtIndex(StartIndex);
+	const float EndSpeed = GetSpeedAtIndex(EndIndex);
+
+	// no slip: contact point velocity V + W ^ (-R * Z) is zero
+	const FVector RollAxis = FVector::UpVector ^ Dir;
+	InOutT.Location += Dir * Distance;
+	InOutT.LinearVelocity = Dir * EndSpeed;
+	InOutT.AngularVelocity = RollAxis * (EndSpeed / Radius) + FVector(0, 0, SpinZ);
+	InOutT.Orientation = FQuat(RollAxis, Distance / Radius) * InOutT.Orientation;
+	InOutT.Orientation.Normalize();
+}
+
+uint32 FBallGroundMovementData::MakeParamsSignature(const FPhysRigidBodyParams& P, float DeltaTime, int ContactSolverIterations, bool bContactSolverWarmStart)
+{
+	const FPhysSimParams S(P);
+	const auto& AirDrag = P.Aerodynamics.AirDrag;
+	const float Values[] = {
+		DeltaTime, S.Gravity.Z, S.Mass, S.Radius,
+		S.InertiaInv.Row1.X, S.InertiaInv.Row2.Y, S.InertiaInv.Row3.Z,
+		S.bDrag ? S.DragFactor : 0.0f, S.bMagnus ? S.LiftFactor : 0.0f, AirDrag.AirDensity,
+		S.bLinearDamping ? S.LinearDamping : 0.0f, S.bAngularDamping ? S.AngularDamping : 0.0f,
+		S.Constrains.LinearVelocity.Min.bClamp ? S.Constrains.LinearVelocity.Min.Value : -1.0f,
+		S.Constrains.LinearVelocity.Max.bClamp ? S.Constrains.LinearVelocity.Max.Value : -1.0f,
+		S.Constrains.AngularVelocity.Min.bClamp ? S.Constrains.AngularVelocity.Min.Value : -1.0f,
+		S.Constrains.AngularVelocity.Max.bClamp ? S.Constrains.AngularVelocity.Max.Value : -1.0f,
+		static_cast<float>(S.Integrator), S.bExponentialMapRotation ? 1.0f : 0.0f,
+		static_cast<float>(ContactSolverIterations), ContactSolverIterations > 0 && bContactSolverWarmStart ? 1.0f : 0.0f
+	};
+	
+	uint32 Crc = FCrc::MemCrc32(Values, sizeof(Values));
+	if(S.HasAerodynamics()) Crc = HashCombine(Crc, FAeroCoefficientTable::MakeCurveSignature(AirDrag.AirDragCurve));
+	return Crc;
+}
+
+uint32 FBallGroundMovementData::MakeSignature(uint32 ParamsSignature, float Friction, float Restitution)
+{
+	const float Values[] = {Friction, Restitution};
+	return FCrc::MemCrc32(Values, sizeof(Values), ParamsSignature);
+}
+
+void FBallGroundMovementData::MakeGroundContactInput(const FPhysRigidBodyParams& P, float Friction, float Restitution, float DeltaTime, FRoughPredictionInput& Out)
+{
+	constexpr float GroundHalfSize = 1000000.0f;
+	constexpr float GroundHalfHeight = 1000.0f;
+	
+	Out = FRoughPredictionInput();
+	Out.RbParams = P;
+	Out.SimStep = DeltaTime;
+	Out.Radius = P.Radius;
+	Out.MassInv = P.GetMassInv();
+	Out.InertiaInv = P.GetInertiaTensorInverted();
+	Out.Friction = Friction;
+	Out.Restitution = Restitution;
+
+	FAnalyticCollisionShape Box;
+	Box.Type = EAnalyticShapeType::Box;
+	Box.Center = FVector(0, 0, -GroundHalfHeight);
+	Box.Extent = FVector(GroundHalfSize, GroundHalfSize, GroundHalfHeight);
+
+	FPredictionCollider Ground;
+	Ground.Shape.Shapes.Add(Box);
+	Ground.Shape.bValid = true;
+	Ground.Location = Box.Center;
+	Ground.Friction = Friction;
+	Ground.Restitution = Restitution;
+	Out.Colliders.Add(MoveTemp(Ground));
+}
+
+float FBallGroundMovementData::GetIndexOfSpeed(float Speed) const
+{
+	// speeds do not increase along table
+	const int Num = LinVelXY.Num();
+	if(Speed >= LinVelXY[0]) return 0.0f;
+	if(Speed <= LinVelXY.Last()) return Num - 1;
+
+	int Low = 1;
+	int High = Num - 1;
+	while (Low < High)
+	{
+		const int Mid = (Low + High) / 2;
+		if(LinVelXY[Mid] <= Speed) High = Mid;
+		else Low = Mid + 1;
+	}
+
+	const float Before = LinVelXY[Low - 1];
+	const float After = LinVelXY[Low];
+	return Low - 1 + UHM::SafeDivision(Before - Speed, Before - After);
+}
+
+float FBallGroundMovementData::GetIndexOfDistance(float Distance) const
+{
+	const int Num = DistanceArr.Num();
+	if(Distance <= 0.0f) return 0.0f;
+	if(Distance > DistanceArr.Last())
+	{
+		const float Speed = LinVelXY.Last();
+		if(Speed <= 0.0f) return -1.0f;
+		return Num - 1 + (Distance - DistanceArr.Last()) / (Speed * TimeStep);
+	}
+
+	int Low = 1;
+	int High = Num - 1;
+	while (Low < High)
+	{
+		const int Mid = (Low + High) / 2;
+		if(DistanceArr[Mid] >= Distance) High = Mid;
+		else Low = Mid + 1;
+	}
+
+	const float Before = DistanceArr[Low - 1];
+	const float After = DistanceArr[Low];
+	return Low - 1 + UHM::SafeDivision(Distance - Before, After - Before);
+}
+
+float FBallGroundMovementData::GetSpeedAtIndex(float Index) const
+{
+	const int Last = LinVelXY.Num() - 1;
+	if(Index >= Last) return LinVelXY[Last];
+	
+	const int Floor = FMath::Max(0, FMath::FloorToInt(Index));
+	return FMath::Lerp(LinVelXY[Floor], LinVelXY[Floor + 1], FMath::Max(0.0f, Index - Floor));
+}
+
+float FBallGroundMovementData::GetDistanceAtIndex(float Index) const
+{
+	const int Last = DistanceArr.Num() - 1;
+	if(Index >= Last) return DistanceArr[Last] + LinVelXY[Last] * (Index - Last) * TimeStep;
+	
+	const int Floor = FMath::Max(0, FMath::FloorToInt(Index));
+	return FMath::Lerp(DistanceArr[Floor], DistanceArr[Floor + 1], FMath::Max(0.0f, Index - Floor));
+}
@@ -0,0 +1,265 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Libs/BatchPredictionLib.h"
+#include "Aerodynamics/AerodynamicsSimulation.h"
+#include "Common/PhysRigidBodyParams.h"
+#include "Components/CustomPhysicsComponent.h"
+#include "Libs/PhysicsSimulation.h"
+#include "HandyMathLibrary.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "debug.h"
+
+void FPredictionBatchLanes::Init(const TArray<FPhysTransform>& Transforms, bool bStoreOnDistance)
+{
+    const int Num = Transforms.Num();
+    for (auto A : {&PX, &PY, &PZ, &VX, &VY, &VZ, &WX, &WY, &WZ, &PrevX, &PrevY, &PrevZ, &StartX, &StartY, &DragMul, &MagnusMul})
+    {
+        A->SetNumUninitialized(Num);
+    }
+    bNeedStoreOnDistance.Init(bStoreOnDistance, Num);
+    LaneId.SetNumUninitialized(Num);
+    
+    for (int i = 0; i < Num; ++i)
+    {
+        const auto& T = Transforms[i];
+        PX[i] = PrevX[i] = StartX[i] = T.Location.X;
+        PY[i] = PrevY[i] = StartY[i] = T.Location.Y;
+        PZ[i] = PrevZ[i] = T.Location.Z;
+        VX[i] = T.LinearVelocity.X;
+        VY[i] = T.LinearVelocity.Y;
+        VZ[i] = T.LinearVelocity.Z;
+        WX[i] = T.AngularVelocity.X;
+        WY[i] = T.AngularVelocity.Y;
+        WZ[i] = T.AngularVelocity.Z;
+        LaneId[i] = i;
+    }
+    NumActive = Num;
+}
+
+void FPredictionBatchLanes::Retire(int Lane)
+{
+    const int Last = NumActive - 1;
+    check(Lane <= Last)
+    
+    if(Lane != Last)
+    {
+        for (auto A : {&PX, &PY, &PZ, &VX, &VY, &VZ, &WX, &WY, &WZ, &PrevX, &PrevY, &PrevZ, &StartX, &StartY, &DragMul, &MagnusMul})
+        {
+            Swap((*A)[Lane], (*A)[Last]);
+        }
+        Swap(bNeedStoreOnDistance[Lane], bNeedStoreOnDistance[Last]);
+        Swap(LaneId[Lane], LaneId[Last]);
+    }
+    NumActive--;
+}
+
+void UBatchPredictionLib::CalculatePredictionCurvesWithMeta(UCustomPhysicsComponent* Obj, const FPhysCurveSpecialPrediction& Data,
+                                                            const TArray<FPhysTransform>& Transforms, TArray<FPhysicsPredictionCurveWithMeta>& Out)
+{
+    check(Obj)
+    CalculatePredictionCurvesWithMeta(Obj->PhysicsParams, Data, Transforms, Out);
+}
+
+void UBatchPredictionLib::CalculatePredictionCurvesWithMeta(const FPhysRigidBodyParams& RbParams, const FPhysCurveSpecialPrediction& Data,
+                                                            const TArray<FPhysTransform>& Transforms, TArray<FPhysicsPredictionCurveWithMeta>& Out)
+{
+    const int MaxSteps = Data.GetMaxIterations();
+    const float SimStep = Data.GetDeltaTime();
+
+    const auto Limits = &Data.Limits;
+    const auto ExtraData = &Data.ExtraData;
+    const bool bLimit_ZMin = Limits->Limit_MinZ.IsLimit();
+    const bool bLimit_ZMax = Limits->Limit_MaxZ.IsLimit();
+    const bool bLimit_DistanceFromStartXY = Limits->Limit_DistanceFromStartXY.IsLimit();
+    const bool bStoreLocationOnDistance = ExtraData->IsStoringLocationOnDistance();
+    const bool bStoreLocations = ExtraData->bStoreLocationVectors;
+
+    const float Limit_ZMin = Limits->Limit_MinZ.GetValue();
+    const float Limit_ZMax = Limits->Limit_MaxZ.GetValue();
+    const float DistanceFromStartXY = Limits->Limit_DistanceFromStartXY.GetValue();
+    const float XYDistanceToStoreZ = ExtraData->GetDistanceToStoreZ();
+
+    Out.Reset();
+    Out.SetNum(Transforms.Num());
+    
+    FPredictionBatchLanes L;
+    L.Init(Transforms, bStoreLocationOnDistance);
+
+    if(bStoreLocations)
+    {
+        for (int i = 0; i < L.NumActive; ++i) Out[i].AddLocationToArray(L.GetLocation(i));
+    }
+    
+    for (int Step = 1; Step < MaxSteps && L.NumActive > 0; ++Step)
+    {
+        UpdateAerodynamicCoefficients(RbParams, L);
+        IntegrateStep(RbParams, SimStep, L);
+
+        // iterate backwards so retired lane swap does not skip unchecked lanes
+        for (int Lane = L.NumActive - 1; Lane >= 0; --Lane)
+        {
+            auto& Result = Out[L.LaneId[Lane]];
+            const FVector NewLocation = L.GetLocation(Lane);
+            const float DistanceZ = NewLocation.Z;
+            const float DistanceXY = L.GetDistanceFromStartXY(Lane);
+
+            bool bContinueIteration = true;
+            if(bLimit_ZMin) bContinueIteration = DistanceZ > Limit_ZMin;
+            if(bLimit_ZMax && bContinueIteration) bContinueIteration = DistanceZ < Limit_ZMax;
+            if(bLimit_DistanceFromStartXY && bContinueIteration) bContinueIteration = DistanceXY < DistanceFromStartXY;
+
+            if(L.bNeedStoreOnDistance[Lane])
+            {
+                const bool bDistanceNearlyEqual = FMath::IsNearlyEqual(DistanceXY, XYDistanceToStoreZ);
+                const bool bDistanceOverPassed = DistanceXY > XYDistanceToStoreZ;
+                if(bDistanceNearlyEqual)
+                {
+                    Result.SetLocationCached(NewLocation);
+                    L.bNeedStoreOnDistance[Lane] = false;
+                }
+                else if(bDistanceOverPassed)
+                {
+                    const float PrevDistanceXY = L.GetPrevDistanceFromStartXY(Lane);
+                    const float Alpha = UHM::GetRatioFromPositiveRange(XYDistanceToStoreZ, PrevDistanceXY, DistanceXY);
+                    Result.SetLocationCached(UKismetMathLibrary::VLerp(L.GetPrevLocation(Lane), NewLocation, Alpha));
+                    L.bNeedStoreOnDistance[Lane] = false;
+                }
+            }
+
+            L.PrevX[Lane] = NewLocation.X;
+            L.PrevY[Lane] = NewLocation.Y;
+            L.PrevZ[Lane] = NewLocation.Z;
+            if(bStoreLocations) Result.AddLocationToArray(NewLocation);
+
+            if(!bContinueIteration) L.Retire(Lane);
+        }
+    }
+}
+
+bool UBatchPredictionLib::ValidateAgainstScalar(UCustomPhysicsComponent* Obj, const FPhysCurveSpecialPrediction& Data, const TArray<FPhysTransform>& Transforms,
+                                                const TArray<FPhysicsPredictionCurveWithMeta>& BatchResults, float Tolerance)
+{
+    check(Transforms.Num() == BatchResults.Num())
+    
+    bool bValid = true;
+    auto ScalarData = Data;
+    for (int i = 0; i < Transforms.Num(); ++i)
+    {
+        ScalarData.SetInitialTransform(Transforms[i]);
+        FPhysicsPredictionCurveWithMeta Scalar;
+        UPhysicsSimulation::CalculatePredictionCurveWithMeta(Obj, ScalarData, Scalar);
+
+        const auto& Batch = BatchResults[i];
+        const bool bSameCached = Scalar.IsVectorCached() == Batch.IsVectorCached();
+        const float Error = bSameCached && Scalar.IsVectorCached() ? FVector::Dist(Scalar.GetCachedVector(), Batch.GetCachedVector()) : 0.0f;
+        
+        if(!bSameCached || Error > Tolerance)
+        {
+            PrintToLog("Batch prediction mismatch at lane " + FString::FromInt(i) + ": " + FString::SanitizeFloat(Error));
+            bValid = false;
+        }
+    }
+    return bValid;
+}
+
+void UBatchPredictionLib::UpdateAerodynamicCoefficients(const FPhysRigidBodyParams& RbParams, FPredictionBatchLanes& L)
+{
+    // coefficient curve is sampled per lane; remaining math works on plain arrays
+    const auto ADParams = &RbParams.Aerodynamics;
+    const float DragImpact = ADParams->AirDragImpact.Value;
+    const float MagnusImpact = ADParams->MagnusImpact.Value;
+    
+    for (int i = 0; i < L.NumActive; ++i)
+    {
+        const float Speed = FMath::Sqrt(L.VX[i] * L.VX[i] + L.VY[i] * L.VY[i] + L.VZ[i] * L.VZ[i]);
+        const FVector Coefficients = ADParams->AirDrag.GetAirDragVector(Speed);
+        L.DragMul[i] = DragImpact * Coefficients.X;
+        L.MagnusMul[i] = MagnusImpact * Coefficients.Y;
+    }
+}
+
+void UBatchPredictionLib::IntegrateStep(const FPhysRigidBodyParams& RbParams, float DeltaTime, FPredictionBatchLanes& L)
+{
+    const auto ADParams = &RbParams.Aerodynamics;
+    const bool bDrag = ADParams->AirDragImpact.bEnabled;
+    const bool bMagnus = ADParams->MagnusImpact.bEnabled;
+    const float Mass = RbParams.GetMass();
+    const float AirDensity = ADParams->AirDrag.GetAirDensityKgCm3();
+    const float DragFactor = 0.5f * AirDensity * RbParams.GetSphericalCrossSectionArea();
+    const float LiftFactor = UAerodynamicsSimulation::GetSphereLiftFactor(RbParams.Radius, AirDensity);
+    const float GravityDeltaZ = RbParams.bGravityEnabled ? RbParams.GetGravityForce().Z * DeltaTime / Mass : 0.0f;
+    const float LinearDampingMul = RbParams.LinearDamping.bEnabled ? 1.0f - RbParams.LinearDamping.Value * DeltaTime : 1.0f;
+    const float AngularDampingMul = RbParams.AngularDamping.bEnabled ? 1.0f - RbParams.AngularDamping.Value * DeltaTime : 1.0f;
+    const float ForceToVelocity = DeltaTime / Mass;
+    
+    const auto& LinearClamp = RbParams.Constrains.LinearVelocity;
+    const bool bClampMin = LinearClamp.Min.bClamp;
+    const bool bClampMax = LinearClamp.Max.bClamp;
+    const float ClampMin = LinearClamp.Min.Value;
+    const float ClampMax = LinearClamp.Max.Value;
+
+    const int N = L.NumActive;
+    float* RESTRICT PX = L.PX.GetData();
+    float* RESTRICT PY = L.PY.GetData();
+    float* RESTRICT PZ = L.PZ.GetData();
+    float* RESTRICT VX = L.VX.GetData();
+    float* RESTRICT VY = L.VY.GetData();
+    float* RESTRICT VZ = L.VZ.GetData();
+    float* RESTRICT WX = L.WX.GetData();
+    float* RESTRICT WY = L.WY.GetData();
+    float* RESTRICT WZ = L.WZ.GetData();
+    const float* RESTRICT DragMul = L.DragMul.GetData();
+    const float* RESTRICT MagnusMul = L.MagnusMul.GetData();
+
+    for (int i = 0; i < N; ++i)
+    {
+        const float vx = VX[i], vy = VY[i], vz = VZ[i];
+        float fx = 0.0f, fy = 0.0f, fz = 0.0f;
+
+        // same thresholds as ComputeSphereAirDragForce / ComputeSphereLiftForceIdeal
+        const float SpeedSq = vx * vx + vy * vy + vz * vz;
+        const float Speed = FMath::Sqrt(SpeedSq);
+        if(bDrag && Speed > 0.1f)
+        {
+            const float M = DragMul[i] * DragFactor * Speed;
+            fx -= M * vx;
+            fy -= M * vy;
+            fz -= M * vz;
+        }
+        if(bMagnus)
+        {
+            const float cx = vy * WZ[i] - vz * WY[i];
+            const float cy = vz * WX[i] - vx * WZ[i];
+            const float cz = vx * WY[i] - vy * WX[i];
+            const float CrossSize = FMath::Sqrt(cx * cx + cy * cy + cz * cz);
+            const float M = CrossSize > 0.1f ? MagnusMul[i] * LiftFactor : 0.0f;
+            fx += M * cx;
+            fy += M * cy;
+            fz += M * cz;
+        }
+
+        float nvx = (vx + fx * ForceToVelocity) * LinearDampingMul;
+        float nvy = (vy + fy * ForceToVelocity) * LinearDampingMul;
+        float nvz = (vz + (GravityDeltaZ + fz * ForceToVelocity)) * LinearDampingMul;
+
+        // FVelocityClamp::GetVelocityClamped
+        const bool bNearlyZero = FMath::Abs(nvx) <= KINDA_SMALL_NUMBER && FMath::Abs(nvy) <= KINDA_SMALL_NUMBER && FMath::Abs(nvz) <= KINDA_SMALL_NUMBER;
+        const float NewSpeed = FMath::Sqrt(nvx * nvx + nvy * nvy + nvz * nvz);
+        float ClampMul = 1.0f;
+        if(bNearlyZero || (bClampMin && NewSpeed <= ClampMin)) ClampMul = 0.0f;
+        else if(bClampMax && NewSpeed > ClampMax) ClampMul = ClampMax / NewSpeed;
+        nvx *= ClampMul;
+        nvy *= ClampMul;
+        nvz *= ClampMul;
+
+        VX[i] = nvx;
+        VY[i] = nvy;
+        VZ[i] = nvz;
+        WX[i] *= AngularDampingMul;
+        WY[i] *= AngularDampingMul;
+        WZ[i] *= AngularDampingMul;
+        PX[i] += nvx * DeltaTime;
+        PY[i] += nvy * DeltaTime;
+        PZ[i] += nvz * DeltaTime;
+    }
+}
@@ -76,6 +76,16 @@ void UMathUtils::ApplyAngularVelocityToRotation(const FVector &AngularVelocity,
     InOutOrientation.Normalize();
 }
 
+void UMathUtils::ApplyAngularVelocityToRotationExpMap(const FVector& AngularVelocity, const float DeltaTime, FQuat& InOutOrientation)
+{
+    const float Speed = AngularVelocity.Size();
+    if(FMath::IsNearlyZero(Speed)) return;
+    
+    const FQuat DeltaRotation = FQuat(AngularVelocity / Speed, Speed * DeltaTime);
+    InOutOrientation = DeltaRotation * InOutOrientation;
+    InOutOrientation.Normalize();
+}
+
 FQuat UMathUtils::AngularVelocityToSpinFromRotator(const FRotator& Orientation, const FVector AngularVelocity)
 {
     return AngularVelocityToSpin(Orientation.Quaternion(), AngularVelocity);
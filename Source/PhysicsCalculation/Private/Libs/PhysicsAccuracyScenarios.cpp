@@ -0,0 +1,321 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Libs/PhysicsAccuracyScenarios.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "Collision/CollisionShapeSnapshot.h"
+#include "Common/PhysSimParams.h"
+#include "Common/RoughPredictionJob.h"
+#include "Libs/BallGroundMovementData.h"
+#include "Libs/PhysicsSimulation.h"
+
+FVector FPhysicsAccuracyScenarios::SimulateFlightLocation(const FPhysRigidBodyParams& RbParams, const FPhysTransform& T, float DeltaTime, float Time)
+{
+    const int NumSteps = FMath::Max(1, FMath::RoundToInt(Time / DeltaTime));
+    const FPhysSimParams SimParams(RbParams);
+    FPhysTransform Step = T;
+    for (int i = 0; i < NumSteps; ++i)
+    {
+        UPhysicsSimulation::PhysicsSimulateDelta(SimParams, DeltaTime, Step);
+    }
+    return Step.Location;
+}
+
+TArray<FPhysicsIntegratorAccuracy> FPhysicsAccuracyScenarios::MeasureIntegratorAccuracy(const FPhysRigidBodyParams& RbParams, const FPhysTransform& T, float BaseDeltaTime, float Time,
+                                                                                        const TArray<int>& StepMultipliers)
+{
+    TArray<FPhysicsIntegratorAccuracy> Out;
+    if(Time <= 0.0f || BaseDeltaTime <= 0.0f) return Out;
+
+    // whole number of base steps so every multiplier ends at the same time
+    int LCM = 1;
+    for (const int Mul : StepMultipliers)
+    {
+        if(Mul > 0) LCM = LCM / FMath::GreatestCommonDivisor(LCM, Mul) * Mul;
+    }
+    const float FlightTime = FMath::Max(1, FMath::RoundToInt(Time / (BaseDeltaTime * LCM))) * BaseDeltaTime * LCM;
+
+    auto Params = RbParams;
+    Params.Integrator = RungeKutta4;
+    const FVector Reference = SimulateFlightLocation(Params, T, BaseDeltaTime * 0.25f, FlightTime);
+
+    const EPhysIntegrator Integrators[] = {SemiImplicitEuler, VelocityVerlet, RungeKutta4};
+    for (const auto Integrator : Integrators)
+    {
+        Params.Integrator = Integrator;
+        for (const int Mul : StepMultipliers)
+        {
+            if(Mul < 1) continue;
+            
+            FPhysicsIntegratorAccuracy Row;
+            Row.Integrator = Integrator;
+            Row.DeltaTime = BaseDeltaTime * Mul;
+            Row.LocationError = (SimulateFlightLocation(Params, T, Row.DeltaTime, FlightTime) - Reference).Size();
+            Out.Add(Row);
+        }
+    }
+    
+    return Out;
+}
+
+TArray<FPhysicsGroundRollAccuracy> FPhysicsAccuracyScenarios::MeasureGroundRollAccuracy(const FPhysRigidBodyParams& RbParams, float Friction, float Restitution, float DeltaTime, float Time,
+                                                                                        const TArray<float>& StartSpeeds)
+{
+    TArray<FPhysicsGroundRollAccuracy> Out;
+    if(Time <= 0.0f || DeltaTime <= 0.0f) return Out;
+
+    FBallGroundMovementData Table;
+    Table.GroundFriction = Friction;
+    Table.GroundRestitution = Restitution;
+    Table.Simulate(RbParams, DeltaTime);
+    if(!Table.IsValid()) return Out;
+
+    FRoughPredictionInput In;
+    FBallGroundMovementData::MakeGroundContactInput(RbParams, Friction, Restitution, DeltaTime, In);
+    const FPhysSimParams SimParams(In.RbParams);
+    const int NumSteps = FMath::Max(1, FMath::RoundToInt(Time / DeltaTime));
+    const float Radius = RbParams.Radius;
+    FContactSolver Solver;
+
+    for (const float Speed : StartSpeeds)
+    {
+        for (const bool bSliding : {false, true})
+        {
+            const FVector AngularVelocity = bSliding ? FVector::ZeroVector : FVector(0, Speed / Radius, 0);
+            const FPhysTransform Start = FPhysTransform(FVector(0, 0, Radius), FQuat::Identity, FVector(Speed, 0, 0), AngularVelocity);
+
+            FPhysTransform Stepped = Start;
+            for (int i = 0; i < NumSteps; ++i)
+            {
+                FPhysTransform NewT;
+                FRoughPredictionJob::SimulateStep(In, SimParams, Stepped, Solver, NewT);
+                Stepped = NewT;
+            }
+            
+            FPhysTransform Tabulated;
+            Table.AdvanceOnGround(Start, NumSteps * DeltaTime, Friction, Tabulated);
+
+            FPhysicsGroundRollAccuracy Row;
+            Row.StartSpeed = Speed;
+            Row.bSliding = bSliding;
+            Row.LocationError = FVector::Dist2D(Stepped.Location, Tabulated.Location);
+            Row.SpeedError = FMath::Abs(Stepped.LinearVelocity.Size2D() - Tabulated.LinearVelocity.Size2D());
+            Out.Add(Row);
+        }
+    }
+    
+    return Out;
+}
+
+TArray<FPhysicsSweepAccuracy> FPhysicsAccuracyScenarios::MeasureSweepAccuracy(float Radius, float HighSpeedDistance, int NumReferenceSteps)
+{
+    TArray<FPhysicsSweepAccuracy> Out;
+    if(NumReferenceSteps <= 0 || Radius <= 0.0f) return Out;
+
+    auto AddCase = [&](const FString& Name, const FAnalyticCollisionShape& Shape, const FVector& Start, const FVector& Delta)
+    {
+        FPhysicsSweepAccuracy Row;
+        Row.Name = Name;
+
+        float Alpha = 0.0f;
+        float ReferenceAlpha = 0.0f;
+        FVector Normal;
+        Row.bHit = Shape.SweepSphere(Start, Delta, Radius, Alpha, Normal);
+        Row.bReferenceHit = FindReferenceTimeOfImpact(Shape, Start, Delta, Radius, NumReferenceSteps, ReferenceAlpha);
+        if(Row.bHit && Row.bReferenceHit) Row.LocationError = FMath::Abs(Alpha - ReferenceAlpha) * Delta.Size();
+        Out.Add(Row);
+    };
+
+    FAnalyticCollisionShape Box;
+    Box.Type = EAnalyticShapeType::Box;
+    Box.Extent = FVector(50.0f);
+
+    const float Side = Box.Extent.X + Radius;
+    AddCase("box face", Box, FVector(-3.0f * Side, 10.0f, 0.0f), FVector(6.0f * Side, 0.0f, 0.0f));
+    AddCase("box edge", Box, FVector(-3.0f * Side, Side - 1.0f, 0.0f), FVector(6.0f * Side, 0.0f, 0.0f));
+    AddCase("box corner", Box, FVector(3.0f * Side), FVector(-6.0f * Side));
+    AddCase("box grazing", Box, FVector(-3.0f * Side, Side + 0.1f, 0.0f), FVector(6.0f * Side, 0.0f, 0.0f));
+
+    Box.Rotation = FQuat(FVector(1.0f, 1.0f, 0.0f).GetSafeNormal(), PI / 5.0f);
+    AddCase("rotated box corner", Box, FVector(3.0f * Side), FVector(-6.0f * Side));
+
+    // thin plate is skipped entirely by discrete checks at both ends of the move
+    FAnalyticCollisionShape Plate;
+    Plate.Type = EAnalyticShapeType::Box;
+    Plate.Extent = FVector(500.0f, 500.0f, 1.0f);
+    AddCase("plate high speed", Plate, FVector(0.0f, 0.0f, HighSpeedDistance * 0.5f), FVector(0.0f, 0.0f, -HighSpeedDistance));
+    AddCase("plate grazing", Plate, FVector(-HighSpeedDistance * 0.5f, 0.0f, Plate.Extent.Z + Radius + 0.1f), FVector(HighSpeedDistance, 0.0f, 0.0f));
+
+    FAnalyticCollisionShape Capsule;
+    Capsule.Type = EAnalyticShapeType::Capsule;
+    Capsule.Radius = 20.0f;
+    Capsule.HalfLength = 50.0f;
+
+    const float CapsuleSide = Capsule.Radius + Radius;
+    AddCase("capsule side", Capsule, FVector(-3.0f * CapsuleSide, 0.0f, 10.0f), FVector(6.0f * CapsuleSide, 0.0f, 0.0f));
+    AddCase("capsule cap", Capsule, FVector(5.0f, 0.0f, Capsule.HalfLength + 3.0f * CapsuleSide), FVector(0.0f, 0.0f, -6.0f * CapsuleSide));
+    AddCase("capsule high speed", Capsule, FVector(-HighSpeedDistance * 0.5f, 0.0f, 0.0f), FVector(HighSpeedDistance, 0.0f, 0.0f));
+
+    FAnalyticCollisionShape Sphere;
+    Sphere.Radius = 30.0f;
+
+    const float SphereSide = Sphere.Radius + Radius;
+    AddCase("sphere off center", Sphere, FVector(-3.0f * SphereSide, 0.5f * SphereSide, 0.0f), FVector(6.0f * SphereSide, 0.0f, 0.0f));
+    AddCase("sphere grazing", Sphere, FVector(-3.0f * SphereSide, SphereSide + 0.1f, 0.0f), FVector(6.0f * SphereSide, 0.0f, 0.0f));
+    AddCase("sphere high speed", Sphere, FVector(-HighSpeedDistance * 0.5f, 5.0f, 0.0f), FVector(HighSpeedDistance, 0.0f, 0.0f));
+
+    return Out;
+}
+
+bool FPhysicsAccuracyScenarios::FindReferenceTimeOfImpact(const FAnalyticCollisionShape& Shape, const FVector& Start, const FVector& Delta, float Radius, int NumSteps,
+                                                          float& OutAlpha)
+{
+    FVector Point;
+    float FreeAlpha = 0.0f;
+    
+    for (int i = 1; i <= NumSteps; ++i)
+    {
+        const float Alpha = static_cast<float>(i) / NumSteps;
+        if(Shape.GetClosestPoint(Start + Delta * Alpha, Point) > Radius)
+        {
+            FreeAlpha = Alpha;
+            continue;
+        }
+
+        // contact lies between last free and first touching sample
+        float TouchAlpha = Alpha;
+        for (int j = 0; j < 20; ++j)
+        {
+            const float Mid = 0.5f * (FreeAlpha + TouchAlpha);
+            if(Shape.GetClosestPoint(Start + Delta * Mid, Point) > Radius) FreeAlpha = Mid;
+            else TouchAlpha = Mid;
+        }
+        OutAlpha = TouchAlpha;
+        return true;
+    }
+    return false;
+}
+
+TArray<FPhysicsContactSolverAccuracy> FPhysicsAccuracyScenarios::MeasureContactSolverAccuracy(const FContactSolverBody& Ball, float Radius, float Friction, float Restitution,
+                                                                                              float DeltaTime, const TArray<int>& Iterations, int NumStackSteps)
+{
+    TArray<FPhysicsContactSolverAccuracy> Out;
+    if(Ball.MassInv <= 0.0f || Radius <= 0.0f) return Out;
+
+    constexpr float Gravity = 980.0f;
+    constexpr float Penetration = 0.5f;
+    
+    auto MakeContact = [&](int BodyA, int BodyB, const FVector& Point, const FVector& Normal)
+    {
+        FContactSolverContact C;
+        C.BodyA = BodyA;
+        C.BodyB = BodyB;
+        C.Point = Point;
+        C.Normal = Normal;
+        C.Penetration = Penetration;
+        return C;
+    };
+
+    auto AddScenario = [&](const FString& Name, const TArray<FContactSolverBody>& Bodies, const TArray<FContactSolverContact>& Contacts, int NumSteps)
+    {
+        for (const int NumIterations : Iterations)
+        {
+            FContactSolver Solver;
+            FContactSolver SolverReversed;
+            Solver.NumIterations = SolverReversed.NumIterations = NumIterations;
+            SolveContactScenario(Bodies, Contacts, Friction, Restitution, Gravity * DeltaTime, NumSteps, false, Solver);
+            SolveContactScenario(Bodies, Contacts, Friction, Restitution, Gravity * DeltaTime, NumSteps, true, SolverReversed);
+
+            FPhysicsContactSolverAccuracy Row;
+            Row.Name = Name;
+            Row.NumIterations = NumIterations;
+            for (const auto& C : Contacts)
+            {
+                const FVector RelativeVelocity = Solver.Bodies[C.BodyB].GetVelocityAtPoint(C.Point) - Solver.Bodies[C.BodyA].GetVelocityAtPoint(C.Point);
+                Row.PenetratingVelocity = FMath::Max(Row.PenetratingVelocity, -(RelativeVelocity | C.Normal));
+            }
+            for (int i = 0; i < Bodies.Num(); ++i)
+            {
+                Row.OrderDifference = FMath::Max(Row.OrderDifference, FVector::Dist(Solver.Bodies[i].LinearVelocity, SolverReversed.Bodies[i].LinearVelocity));
+            }
+            Out.Add(Row);
+        }
+    };
+
+    FContactSolverBody Static;
+    
+    FContactSolverBody Heavy = Ball;
+    Heavy.MassInv *= 0.1f;
+    Heavy.InertiaInv = FSimpleMatrix3(Ball.InertiaInv.Row1 * 0.1f, Ball.InertiaInv.Row2 * 0.1f, Ball.InertiaInv.Row3 * 0.1f);
+
+    // ball is pressed into corner of post and ground
+    {
+        FContactSolverBody Pinched = Ball;
+        Pinched.Location = FVector(0, 0, Radius);
+        Pinched.LinearVelocity = FVector(800.0f, 0, -400.0f);
+        Pinched.AngularVelocity = FVector(0, 20.0f, 0);
+
+        AddScenario("pinch post and ground", {Static, Pinched},
+                    {MakeContact(0, 1, FVector::ZeroVector, FVector::UpVector), MakeContact(0, 1, FVector(Radius, 0, Radius), -FVector::ForwardVector)}, 1);
+    }
+
+    // ball on ground is squeezed by two heavy bodies approaching from both sides
+    {
+        FContactSolverBody Pinched = Ball;
+        Pinched.Location = FVector(0, 0, Radius);
+        
+        FContactSolverBody Left = Heavy;
+        Left.Location = FVector(-2.0f * Radius, 0, Radius);
+        Left.LinearVelocity = FVector(300.0f, 0, 0);
+
+        FContactSolverBody Right = Heavy;
+        Right.Location = FVector(2.0f * Radius, 0, Radius);
+        Right.LinearVelocity = FVector(-200.0f, 0, 50.0f);
+
+        AddScenario("pinch between bodies", {Static, Pinched, Left, Right},
+                    {MakeContact(0, 1, FVector::ZeroVector, FVector::UpVector), MakeContact(2, 1, FVector(-Radius, 0, Radius), FVector::ForwardVector),
+                     MakeContact(3, 1, FVector(Radius, 0, Radius), -FVector::ForwardVector)}, 1);
+    }
+
+    // two balls resting on each other; gravity has to be cancelled every step without jitter
+    if(NumStackSteps > 0)
+    {
+        FContactSolverBody Bottom = Ball;
+        Bottom.Location = FVector(0, 0, Radius);
+
+        FContactSolverBody Top = Ball;
+        Top.Location = FVector(0, 0, 3.0f * Radius);
+
+        AddScenario("stack", {Static, Bottom, Top},
+                    {MakeContact(0, 1, FVector::ZeroVector, FVector::UpVector), MakeContact(1, 2, FVector(0, 0, 2.0f * Radius), FVector::UpVector)}, NumStackSteps);
+    }
+    
+    return Out;
+}
+
+void FPhysicsAccuracyScenarios::SolveContactScenario(const TArray<FContactSolverBody>& Bodies, const TArray<FContactSolverContact>& Contacts, float Friction,
+                                                     float Restitution, float GravityDeltaVelocity, int NumSteps, bool bReverseOrder, FContactSolver& Solver)
+{
+    TArray<FContactSolverBody> State = Bodies;
+    
+    for (int Step = 0; Step < NumSteps; ++Step)
+    {
+        Solver.Reset();
+        for (auto Body : State)
+        {
+            if(Body.MassInv > 0.0f) Body.LinearVelocity.Z -= GravityDeltaVelocity;
+            Body.LinearImpulse = Body.AngularImpulse = Body.SeparationOffset = FVector::ZeroVector;
+            Solver.AddBody(Body);
+        }
+        for (int i = 0; i < Contacts.Num(); ++i)
+        {
+            const auto& C = Contacts[bReverseOrder ? Contacts.Num() - 1 - i : i];
+            Solver.AddContact(C.BodyA, C.BodyB, C.Point, C.Normal, C.Penetration, Friction, Restitution);
+        }
+        Solver.SolveContacts();
+        State = Solver.Bodies;
+    }
+}
+
+#endif
@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Libs/PhysicsBenchmarkLib.h"
+#include "Libs/PhysicsAccuracyScenarios.h"
+#include "Components/PhysicsComponent.h"
+#include "DataAssets/SpinMovementParams_DataAsset.h"
+#include "KickCalculationSystem/KickSolveJob.h"
+#include "Common/PhysSimParams.h"
+#include "Libs/PhysicsSimulation.h"
+#include "Libs/SpinMovementLib.h"
+#include "debug.h"
+
+FPhysicsBenchmarkResult UPhysicsBenchmarkLib::RunPhysicsBenchmark(UPhysicsComponent* PC, const FPhysicsBenchmarkSettings& Settings)
+{
+    FPhysicsBenchmarkResult Out;
+    if(!PC) return Out;
+
+    const auto& RbParams = PC->PhysicsParams;
+    const auto T = PC->CurrentTransform;
+    const float DeltaTime = PC->GetPrecisePredictSimStep();
+    
+    Out.SingleStepNs = MeasureSingleStepNs(RbParams, T, DeltaTime, Settings.NumSingleSteps, false);
+    Out.SingleStepDerivedParamsNs = MeasureSingleStepNs(RbParams, T, DeltaTime, Settings.NumSingleSteps, true);
+    Out.PrecisePredictionMs = MeasurePrecisePredictionMs(RbParams, T, DeltaTime, Settings.PrecisePredictionTime, Settings.NumPrecisePredictions);
+    Out.KickSolveMs = MeasureKickSolveMs(PC, Settings.KickData, Settings.NumKickSolves, Out.KickCandidates);
+    Out.CacheCellMs = MeasureCacheCellMs(PC, Settings.NumCacheCells, Out.NumCacheCells);
+
+#if !UE_BUILD_SHIPPING
+    // accuracy tables are development only, shipping build reports timings
+    Out.IntegratorAccuracy = FPhysicsAccuracyScenarios::MeasureIntegratorAccuracy(RbParams, T, DeltaTime, Settings.IntegratorAccuracyTime, Settings.IntegratorStepMultipliers);
+
+    auto GroundRbParams = RbParams;
+    GroundRbParams.Radius = PC->GetRadius();
+    Out.GroundRollAccuracy = FPhysicsAccuracyScenarios::MeasureGroundRollAccuracy(GroundRbParams, PC->GetFriction(), PC->GetRestitution(), DeltaTime,
+                                                                                  Settings.GroundRollTime, Settings.GroundRollSpeeds);
+    Out.SweepAccuracy = FPhysicsAccuracyScenarios::MeasureSweepAccuracy(PC->GetRadius(), Settings.SweepSpeed * DeltaTime, Settings.NumSweepReferenceSteps);
+
+    FContactSolverBody Ball;
+    Ball.MassInv = PC->GetMassInv();
+    Ball.InertiaInv = PC->GetInertiaTensorInverted();
+    Out.ContactSolverAccuracy = FPhysicsAccuracyScenarios::MeasureContactSolverAccuracy(Ball, PC->GetRadius(), PC->GetFriction(), PC->GetRestitution(), DeltaTime,
+                                                                                        Settings.ContactSolverIterations, Settings.ContactStackSteps);
+#endif
+
+    PrintToLog("Physics benchmark: " + Out.ToString());
+    PrintToLog("Physics benchmark kick candidates: " + Out.KickCandidates.ToString());
+    for (const auto& Row : Out.IntegratorAccuracy)
+    {
+        PrintToLog("Physics benchmark integrator: " + Row.ToString());
+    }
+    for (const auto& Row : Out.GroundRollAccuracy)
+    {
+        PrintToLog("Physics benchmark ground roll: " + Row.ToString());
+    }
+    for (const auto& Row : Out.SweepAccuracy)
+    {
+        PrintToLog("Physics benchmark sweep: " + Row.ToString());
+    }
+    for (const auto& Row : Out.ContactSolverAccuracy)
+    {
+        PrintToLog("Physics benchmark contact solver: " + Row.ToString());
+    }
+    return Out;
+}
+
+float UPhysicsBenchmarkLib::MeasureSingleStepNs(const FPhysRigidBodyParams& RbParams, const FPhysTransform& T, float DeltaTime, int NumSteps, bool bDeriveParamsEveryStep)
+{
+    if(NumSteps < 1 || DeltaTime <= 0.0f) return 0.0f;
+
+    const FPhysSimParams SimParams(RbParams);
+    
+    // restart from initial transform each step so all steps run in the same flight regime
+    FPhysTransform Sink = T;
+    const double Before = FPlatformTime::Seconds();
+    for (int i = 0; i < NumSteps; ++i)
+    {
+        FPhysTransform Step = T;
+        if(bDeriveParamsEveryStep) UPhysicsSimulation::PhysicsSimulateDelta(FPhysSimParams(RbParams), DeltaTime, Step);
+        else UPhysicsSimulation::PhysicsSimulateDelta(SimParams, DeltaTime, Step);
+        Sink.Location += Step.Location;
+    }
+    const double After = FPlatformTime::Seconds();
+
+    // keeps the loop from being optimized away
+    if(Sink.Location.ContainsNaN()) PrintToLog("Physics benchmark: NaN in single step");
+    return static_cast<float>((After - Before) * 1e9 / NumSteps);
+}
+
+float UPhysicsBenchmarkLib::MeasurePrecisePredictionMs(const FPhysRigidBodyParams& RbParams, const FPhysTransform& T, float DeltaTime, float Time, int NumRuns)
+{
+    if(NumRuns < 1 || DeltaTime <= 0.0f) return 0.0f;
+
+    const int NumSteps = FMath::Max(1, FMath::RoundToInt(Time / DeltaTime));
+    const FPhysSimParams SimParams(RbParams);
+    TArray<FPhysTransform> Transforms;
+    Transforms.Reserve(NumSteps);
+    
+    const double Before = FPlatformTime::Seconds();
+    for (int Run = 0; Run < NumRuns; ++Run)
+    {
+        Transforms.Reset();
+        FPhysTransform Step = T;
+        for (int i = 0; i < NumSteps; ++i)
+        {
+            UPhysicsSimulation::PhysicsSimulateDelta(SimParams, DeltaTime, Step);
+            Transforms.Add(Step);
+        }
+    }
+    const double After = FPlatformTime::Seconds();
+    
+    return static_cast<float>((After - Before) * 1e3 / NumRuns);
+}
+
+float UPhysicsBenchmarkLib::MeasureKickSolveMs(UPhysicsComponent* PC, const FKickCompData& Data, int NumRuns, FKickCandidateStats& OutStats)
+{
+    OutStats = FKickCandidateStats();
+    if(NumRuns < 1) return 0.0f;
+
+    auto KickData = Data;
+    KickData.bDrawResultTrajectories = false;
+    
+    int NumResults = 0;
+    const double Before = FPlatformTime::Seconds();
+    for (int i = 0; i < NumRuns; ++i)
+    {
+        // same path as UKickSystemLib::KickComputePossibleImpact, job is kept for its counters
+        FKickSolveJob Job(PC, KickData);
+        Job.RunToCompletion();
+        NumResults += Job.GetResult().ImpactTransformArray.Num();
+        OutStats = Job.GetStats();
+    }
+    const double After = FPlatformTime::Seconds();
+
+    PrintToLog("Physics benchmark: kick solutions per run " + FString::SanitizeFloat(static_cast<float>(NumResults) / NumRuns));
+    return static_cast<float>((After - Before) * 1e3 / NumRuns);
+}
+
+float UPhysicsBenchmarkLib::MeasureCacheCellMs(UPhysicsComponent* PC, int NumCells, int& OutNumCells)
+{
+    OutNumCells = 0;
+    if(NumCells < 1 || !PC->SpinMovementParams) return 0.0f;
+
+    auto Data = USpinMovementLib::MakeBallLaunchCacheGrid(PC);
+    auto Cells = USpinMovementLib::MakeBallLaunchCacheCells(PC);
+    if(Cells.Num() > NumCells) Cells.SetNum(NumCells);
+    OutNumCells = Cells.Num();
+    if(OutNumCells == 0) return 0.0f;
+
+    const auto Body = USpinMovementLib::MakeBallLaunchCacheBody(PC);
+    const double Before = FPlatformTime::Seconds();
+    for (const auto& Cell : Cells)
+    {
+        USpinMovementLib::CalculateDataFromLaunchParams(PC, Body, Cell, Data);
+    }
+    const double After = FPlatformTime::Seconds();
+
+    return static_cast<float>((After - Before) * 1e3 / OutNumCells);
+}
@@ -5,6 +5,7 @@
 #include "Components/CustomPhysicsBaseComponent.h"
 #include "Components/CustomPhysicsComponent.h"
 #include "Common/PhysRigidBodyParams.h"
+#include "Common/PhysSimParams.h"
 #include "Kismet/KismetMathLibrary.h"
 
 FVector UPhysicsSimulation::PTransformGetLinearVelocityAtPoint(const FPhysTransform& T, const FVector& P)
@@ -94,14 +95,83 @@ FVector UPhysicsSimulation::CalcInertiaEffect(FSimpleMatrix3 InertiaTensorInvert
     return (InertiaTensorInverted.MultiplyByVector(Arm ^ Normal))^ Arm;
 }
 
-void UPhysicsSimulation::UpdateTransformOrientation(const FPhysRigidBodyParams& RbParams, float DeltaTime, FPhysTransform& InOutT)
+void UPhysicsSimulation::UpdateTransformOrientation(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& InOutT)
 {
     FVector AngularVelocity = InOutT.AngularVelocity;
-    if(RbParams.Rendering.MaxAngularVelocity.bClamp)
+    if(SimParams.MaxRenderAngularVelocity.bClamp)
     {
-        AngularVelocity = RbParams.Rendering.GetAngularVelocityClamped(InOutT.AngularVelocity);
+        AngularVelocity = InOutT.AngularVelocity.GetClampedToSize(0.0f, SimParams.MaxRenderAngularVelocity.Value);
     }
-    UMathUtils::ApplyAngularVelocityToRotation(AngularVelocity, DeltaTime, InOutT.Orientation);
+    if(SimParams.bExponentialMapRotation)
+    {
+        UMathUtils::ApplyAngularVelocityToRotationExpMap(AngularVelocity, DeltaTime, InOutT.Orientation);
+    }
+    else
+    {
+        UMathUtils::ApplyAngularVelocityToRotation(AngularVelocity, DeltaTime, InOutT.Orientation);
+    }
+}
+
+FVector UPhysicsSimulation::GetLinearAcceleration(const FPhysSimParams& SimParams, const FVector& LinearVelocity, const FVector& AngularVelocity)
+{
+    return UAerodynamicsSimulation::CalculateAerodynamicForce(SimParams, LinearVelocity, AngularVelocity) * SimParams.MassInv + SimParams.Gravity;
+}
+
+void UPhysicsSimulation::IntegrateLinearMotion(const FPhysSimParams& SimParams, float DeltaTime, const FVector& AngularVelocityDelta, FPhysTransform& InOutT)
+{
+    switch (SimParams.Integrator)
+    {
+    case VelocityVerlet:
+        IntegrateVelocityVerlet(SimParams, DeltaTime, InOutT);
+        break;
+    case RungeKutta4:
+        IntegrateRungeKutta4(SimParams, DeltaTime, InOutT);
+        break;
+    default:
+        // location uses velocity after damping and constrains
+        InOutT.LinearVelocity += GetLinearAcceleration(SimParams, InOutT.LinearVelocity, InOutT.AngularVelocity) * DeltaTime;
+        InOutT.AngularVelocity += AngularVelocityDelta;
+        ApplyVelocityDamping(SimParams, DeltaTime, InOutT);
+        ApplyConstrains(SimParams.Constrains, InOutT);
+        InOutT.Location += InOutT.LinearVelocity * DeltaTime;
+        return;
+    }
+
+    InOutT.AngularVelocity += AngularVelocityDelta;
+    ApplyVelocityDamping(SimParams, DeltaTime, InOutT);
+    ApplyConstrains(SimParams.Constrains, InOutT);
+}
+
+void UPhysicsSimulation::IntegrateVelocityVerlet(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& InOutT)
+{
+    // forces depend on velocity, so end acceleration is taken at Euler predicted velocity (Heun)
+    const FVector AV = InOutT.AngularVelocity;
+    const FVector V0 = InOutT.LinearVelocity;
+    const FVector A0 = GetLinearAcceleration(SimParams, V0, AV);
+    const FVector A1 = GetLinearAcceleration(SimParams, V0 + A0 * DeltaTime, AV);
+
+    InOutT.Location += (V0 + 0.5f * A0 * DeltaTime) * DeltaTime;
+    InOutT.LinearVelocity = V0 + 0.5f * (A0 + A1) * DeltaTime;
+}
+
+void UPhysicsSimulation::IntegrateRungeKutta4(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& InOutT)
+{
+    // forces do not depend on location, so location derivative of each stage is stage velocity
+    const FVector AV = InOutT.AngularVelocity;
+    const float HalfDT = 0.5f * DeltaTime;
+    
+    const FVector V1 = InOutT.LinearVelocity;
+    const FVector A1 = GetLinearAcceleration(SimParams, V1, AV);
+    const FVector V2 = V1 + A1 * HalfDT;
+    const FVector A2 = GetLinearAcceleration(SimParams, V2, AV);
+    const FVector V3 = V1 + A2 * HalfDT;
+    const FVector A3 = GetLinearAcceleration(SimParams, V3, AV);
+    const FVector V4 = V1 + A3 * DeltaTime;
+    const FVector A4 = GetLinearAcceleration(SimParams, V4, AV);
+
+    constexpr float Sixth = 1.0f / 6.0f;
+    InOutT.Location += (V1 + 2.0f * V2 + 2.0f * V3 + V4) * (DeltaTime * Sixth);
+    InOutT.LinearVelocity += (A1 + 2.0f * A2 + 2.0f * A3 + A4) * (DeltaTime * Sixth);
 }
 
 void UPhysicsSimulation::ApplyConstrains(const FPhysConstrains& Constrains, FPhysTransform& InOutT)
@@ -109,62 +179,39 @@ void UPhysicsSimulation::ApplyConstrains(const FPhysConstrains& Constrains, FPhy
     Constrains.ClampVelocity(InOutT.LinearVelocity, InOutT.AngularVelocity);
 }
 
-void UPhysicsSimulation::ApplyVelocityDamping(const FPhysRigidBodyParams& RbParams, float DeltaTime, FPhysTransform& OutT)
+void UPhysicsSimulation::ApplyVelocityDamping(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& OutT)
 {
-    const auto Linear = &RbParams.LinearDamping;
-    const auto Angular = &RbParams.AngularDamping;
-
-    if(Linear->bEnabled)
+    if(SimParams.bLinearDamping)
     {
-        SimulateVelocityDamping(OutT.LinearVelocity,Linear->Value, DeltaTime);
+        SimulateVelocityDamping(OutT.LinearVelocity, SimParams.LinearDamping, DeltaTime);
     }
-    if(Angular->bEnabled)
+    if(SimParams.bAngularDamping)
     {
-        SimulateVelocityDamping(OutT.AngularVelocity, Angular->Value, DeltaTime);
-    }    
+        SimulateVelocityDamping(OutT.AngularVelocity, SimParams.AngularDamping, DeltaTime);
+    }
 }
 
 void UPhysicsSimulation::PhysicsSimulateDelta(FPSI_Data& Data, FPhysTransform& OutT)
 {
     check(Data.Obj)
-    auto InT = Data.GetTransform();
-    auto RbParams = Data.Obj->PhysicsParams;
-    float DeltaTime = Data.GetDeltaTime();
+    const auto& SimParams = Data.Obj->GetSimParams();
+    const float DeltaTime = Data.GetDeltaTime();
     
-    OutT = InT;
-
-    FVector locationOffset = FVector::ZeroVector;
-    {
-        FVector LinearVelocityAccumulated = FVector::ZeroVector;
-        FVector AngularVelocityAccumulated = FVector::ZeroVector;
-
-        if(RbParams.bGravityEnabled) 
-        {
-            FVector GForce = RbParams.GetGravityForce();
-            SimulateAddImpulseFromForce(LinearVelocityAccumulated, GForce, DeltaTime, RbParams.GetMass());
-        }
+    OutT = Data.GetTransform();
 
-        {
-            FVector ADLinearVelocity = FVector::ZeroVector;
-            FVector ADAngularVelocity = FVector::ZeroVector;
-
-            UAerodynamicsSimulation::CalculateAerodynamicImpact(Data, ADLinearVelocity, ADAngularVelocity, locationOffset);
+    FVector LocationOffset = FVector::ZeroVector;
+    FVector ExtraAngularVelocity = FVector::ZeroVector;
+    UAerodynamicsSimulation::CalculateExtraForcesImpact(Data, ExtraAngularVelocity, LocationOffset);
+    OutT.Location += LocationOffset;
 
-            OutT.Location += locationOffset;
-            LinearVelocityAccumulated += ADLinearVelocity;
-            AngularVelocityAccumulated += ADAngularVelocity;
-        }
+    IntegrateLinearMotion(SimParams, DeltaTime, ExtraAngularVelocity, OutT);
+    UpdateTransformOrientation(SimParams, DeltaTime, OutT);
+}
 
-        OutT.LinearVelocity += LinearVelocityAccumulated;
-        OutT.AngularVelocity += AngularVelocityAccumulated;
-    }
-    
-    ApplyVelocityDamping(RbParams, DeltaTime, OutT);
-    ApplyConstrains(RbParams.Constrains, OutT);
-    
-    OutT.Location += OutT.LinearVelocity * DeltaTime;
-    
-    UpdateTransformOrientation(RbParams, DeltaTime, OutT);
+void UPhysicsSimulation::PhysicsSimulateDelta(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& InOutT)
+{
+    IntegrateLinearMotion(SimParams, DeltaTime, FVector::ZeroVector, InOutT);
+    UpdateTransformOrientation(SimParams, DeltaTime, InOutT);
 }
 
 void UPhysicsSimulation::SimulateAddImpulseFromForce(FVector& InOutLinearVelocity, const FVector& Force, const float DeltaTime, const float Mass)
@@ -80,9 +80,11 @@ FPhysTransform UPhysicsUtils::TLerp(const FPhysTransform& A, const FPhysTransfor
     return FPhysTransform(Location, Orientation, LinearVelocity, AngularVelocity);
 }
 
-FBallGroundMovementData UPhysicsUtils::ComputeBallGroundMovementData(const FPhysRigidBodyParams& P, float Time_Step)
+FBallGroundMovementData UPhysicsUtils::ComputeBallGroundMovementData(const FPhysRigidBodyParams& P, float Time_Step, float GroundFriction, float GroundRestitution)
 {
     FBallGroundMovementData D;
+    D.GroundFriction = GroundFriction;
+    D.GroundRestitution = GroundRestitution;
     D.Simulate(P, Time_Step);
     return D;
 }
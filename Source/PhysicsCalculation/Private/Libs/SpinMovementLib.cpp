@@ -6,8 +6,86 @@
 #include "ParabolicMotion/ParabolicMotionToRealLib.h"
 #include "DataAssets/PhysicsCache_DataAsset.h"
 #include "ImpulseDistribution/ImpulseDistributionLib.h"
+#include "Libs/AdaptiveIntegrationLib.h"
+#include "Libs/PhysicsSimulation.h"
+#include "Libs/UtilsLib.h"
+#include "Async/ParallelFor.h"
+#include "debug.h"
 
-FBallLaunchCache_Data USpinMovementLib::CalculateBallLaunchCache(UAdvancedPhysicsComponent* PC)
+FBallLaunchCache_Data USpinMovementLib::CalculateBallLaunchCache(UAdvancedPhysicsComponent* PC, FBallLaunchCacheBuildProgress* Progress)
+{
+    FBallLaunchCache_Data OutData = MakeBallLaunchCacheGrid(PC);
+
+    // cells are filtered on calling thread because limit curves are UObjects
+    const auto Cells = MakeBallLaunchCacheCells(PC);
+
+    FBallLaunchCacheBuildProgress LocalProgress;
+    if(!Progress) Progress = &LocalProgress;
+    Progress->Reset(Cells.Num());
+
+    ComputeBallLaunchCacheCells(PC, MakeBallLaunchCacheBody(PC), Cells, OutData, *Progress);
+    return OutData;
+}
+
+FBallLaunchCacheBody USpinMovementLib::MakeBallLaunchCacheBody(UAdvancedPhysicsComponent* PC)
+{
+    FBallLaunchCacheBody Out;
+    Out.SimParams = PC->GetSimParams();
+    Out.TRest = PC->CurrentTransform;
+    // spin or velocity of ball at build time must not get into cells
+    Out.TRest.LinearVelocity = FVector::ZeroVector;
+    Out.TRest.AngularVelocity = FVector::ZeroVector;
+    return Out;
+}
+
+void USpinMovementLib::ComputeBallLaunchCacheCells(UAdvancedPhysicsComponent* PC, const FBallLaunchCacheBody& Body, const TArray<FBallLaunchParams>& Cells,
+                                                   FBallLaunchCache_Data& OutData, FBallLaunchCacheBuildProgress& Progress)
+{
+    const auto Params = &PC->SpinMovementParams->Data;
+    const int NumCells = Cells.Num();
+    if(NumCells == 0) return;
+
+    // each chunk is a contiguous range of cells in serial order (which is also grid order),
+    // so appending shards chunk by chunk reproduces layout of single threaded build
+    const bool bForceSingleThread = !Params->bParallelComputation || !FPlatformProcess::SupportsMultithreading();
+    const int NumWorkers = bForceSingleThread ? 1 : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    const int NumChunks = FMath::Clamp(NumWorkers * 4, 1, NumCells);
+    const int ChunkSize = FMath::DivideAndRoundUp(NumCells, NumChunks);
+
+    TArray<FBallLaunchCache_Data> Shards;
+    Shards.SetNum(NumChunks);
+
+    ParallelFor(NumChunks, [&](int32 ChunkIndex)
+    {
+        const int First = ChunkIndex * ChunkSize;
+        const int Last = FMath::Min(First + ChunkSize, NumCells);
+        if(First >= Last) return;
+
+        const int FirstGridCell = OutData.GetGridCellIndex(Cells[First]);
+        const int LastGridCell = OutData.GetGridCellIndex(Cells[Last - 1]);
+        Shards[ChunkIndex] = OutData.MakeShard(FirstGridCell, LastGridCell - FirstGridCell + 1);
+        
+        for (int i = First; i < Last; ++i)
+        {
+            if(Progress.IsCancelled()) return;
+            CalculateDataFromLaunchParams(PC, Body, Cells[i], Shards[ChunkIndex]);
+            Progress.MarkCellDone();
+        }
+    }, bForceSingleThread);
+
+    if(Progress.IsCancelled())
+    {
+        PrintToLog("Ball launch cache computation cancelled: " + FString::FromInt(Progress.GetNumCellsDone()) + "/" + FString::FromInt(NumCells));
+        return;
+    }
+
+    for (const auto& Shard : Shards)
+    {
+        OutData.AppendShard(Shard);
+    }
+}
+
+FBallLaunchCache_Data USpinMovementLib::MakeBallLaunchCacheGrid(UAdvancedPhysicsComponent* PC)
 {
     const auto Params = &PC->SpinMovementParams->Data;
     const auto LaunchSpeedData = Params->GetLaunchSpeedCmSec();
@@ -23,7 +101,20 @@ FBallLaunchCache_Data USpinMovementLib::CalculateBallLaunchCache(UAdvancedPhysic
     OutData.SetSideSpinAngleVector(SideSpinAngleData);
     OutData.SetVerticalLevelWidth(VerticalLevelWidth);
     OutData.Validate();
+    OutData.InitGrid();
+    return OutData;
+}
+
+TArray<FBallLaunchParams> USpinMovementLib::MakeBallLaunchCacheCells(UAdvancedPhysicsComponent* PC)
+{
+    const auto Params = &PC->SpinMovementParams->Data;
+    const auto LaunchSpeedData = Params->GetLaunchSpeedCmSec();
+    const auto LaunchAngleData = Params->LaunchAngle.GetValueArrayFullRange();
+    const auto FrontSpinAngleData = Params->FrontSpinAngle.GetValueArrayFullRange();
+    const auto SideSpinAngleData = Params->SideSpinAngle.GetValueArrayFullRange();
 
+    TArray<FBallLaunchParams> Out;
+    
     for (int launch_speed_ind = 0; launch_speed_ind < LaunchSpeedData.Num(); ++launch_speed_ind)
     {
         for (int launch_angle_ind = 0; launch_angle_ind < LaunchAngleData.Num(); ++launch_angle_ind)
@@ -43,32 +134,34 @@ FBallLaunchCache_Data USpinMovementLib::CalculateBallLaunchCache(UAdvancedPhysic
                     const bool CanUseLaunchParams = Params->CanUseLaunchParams(LaunchParams);
                     if(CanUseLaunchParams)
                     {
-                        CalculateDataFromLaunchParams(PC, LaunchParams, OutData);
+                        Out.Add(LaunchParams);
                     }
                 }
             }
         }
     }
-    return OutData;
+    return Out;
 }
 
-void USpinMovementLib::CalculateDataFromLaunchParams(UAdvancedPhysicsComponent* PC, const FBallLaunchParams& LaunchParams, FBallLaunchCache_Data& OutData)
+void USpinMovementLib::CalculateDataFromLaunchParams(UAdvancedPhysicsComponent* PC, const FBallLaunchCacheBody& Body, const FBallLaunchParams& LaunchParams,
+                                                     FBallLaunchCache_Data& OutData)
 {
     const auto Params = &PC->SpinMovementParams->Data;
     const float SimStep = Params->SimulationStep;
     const int   NumSteps = Params->GetComputationNumSteps();
-    const FVector COM = FVector(0.0f, 0.0f, PC->GetRadius());
+    const FVector COM = FVector(0.0f, 0.0f, Body.SimParams.Radius);
                     
     FPhysTransform TLaunch;
     const auto Impulse = GetImpulseFromBallLaunchParams(PC, LaunchParams, COM);
-    const auto Curve = CalculateSpinTrajectory(PC, Impulse, COM, SimStep, NumSteps, TLaunch);
+    const auto Curve = CalculateSpinTrajectory(PC, Body, Impulse, COM, SimStep, NumSteps, TLaunch);
+    const FIndexedTrajectory Trajectory(Curve.GetVectorKeys(), SimStep);
     FVector GroundLocation;
-    UParabolicMotionToRealLib::GetTrajectoryGroundLocation(Curve, GroundLocation, true);
+    UParabolicMotionToRealLib::GetTrajectoryGroundLocation(Trajectory, GroundLocation, true);
     
     const float MaxDistance = (GroundLocation - COM).Size2D();
     OutData.AddDistanceValue(LaunchParams, MaxDistance);
 
-    const auto VerticalDistribution = CalculateVerticalDistributionFromTrajectory(PC, Curve);
+    const auto VerticalDistribution = CalculateVerticalDistributionFromTrajectory(PC, Trajectory);
     OutData.AddVerticalDistribution(LaunchParams, VerticalDistribution);
 }
 
@@ -87,13 +180,39 @@ FImpulseReconstructed USpinMovementLib::GetImpulseFromBallLaunchParams(UAdvanced
     return FImpulseReconstructed(Impulse, ApplyLocation);
 }
 
-FCustomVectorCurve USpinMovementLib::CalculateSpinTrajectory(UAdvancedPhysicsComponent* Obj, const FImpulseReconstructed& ImpulseData, FVector COM, float TimeStep, int NumSteps, FPhysTransform& TLaunch)
+FCustomVectorCurve USpinMovementLib::CalculateSpinTrajectory(UAdvancedPhysicsComponent* Obj, const FBallLaunchCacheBody& Body, const FImpulseReconstructed& ImpulseData,
+                                                             FVector COM, float TimeStep, int NumSteps, FPhysTransform& TLaunch)
 {
-    TLaunch = Obj->CalculateImpulseImpactAtLocationOtherCOM(ImpulseData.Impulse, ImpulseData.ApplyLocation, COM, FVector::ZeroVector, true);
-    return  UParabolicMotionToRealLib::CalculateMotionCurveFromTransform(Obj, TLaunch, TimeStep, NumSteps);
+    // as UCustomPhysicsComponent::CalculateImpulseImpactAtLocationOtherCOM with both velocities removed
+    TLaunch = Body.TRest;
+    TLaunch.Location = COM;
+    UPhysicsSimulation::SimulateAddImpulseAtLocationForSphere2(TLaunch.LinearVelocity, TLaunch.AngularVelocity, ImpulseData.Impulse, Body.SimParams.Mass,
+                                                               ImpulseData.ApplyLocation, TLaunch.Location, Body.SimParams.InertiaInv);
+    
+    // same sampling as CalculateMotionCurveFromTransform: no collisions, stop below zero Z
+    constexpr float LimitZ = 0.0f;
+    if(Obj->SpinMovementParams && Obj->SpinMovementParams->Data.AdaptiveStep.bEnabled)
+    {
+        const auto& Settings = Obj->SpinMovementParams->Data.AdaptiveStep;
+        const auto Transforms = UAdaptiveIntegrationLib::SimulateWithFixedOutput(Body.SimParams, Settings, TLaunch, TimeStep, NumSteps, true, LimitZ);
+        return FCustomVectorCurve(UUtilsLib::LocationsFromPhysTransformArray(Transforms), TimeStep);
+    }
+
+    TArray<FVector> Locations;
+    Locations.Reserve(NumSteps);
+    Locations.Add(TLaunch.Location);
+    
+    FPhysTransform T = TLaunch;
+    for (int i = 1; i < NumSteps; ++i)
+    {
+        UPhysicsSimulation::PhysicsSimulateDelta(Body.SimParams, TimeStep, T);
+        Locations.Add(T.Location);
+        if(T.Location.Z <= LimitZ) break;
+    }
+    return FCustomVectorCurve(Locations, TimeStep);
 }
 
-FBallLaunchVerticalDistribution USpinMovementLib::CalculateVerticalDistributionFromTrajectory(UAdvancedPhysicsComponent* PC, const FCustomVectorCurve& Curve)
+FBallLaunchVerticalDistribution USpinMovementLib::CalculateVerticalDistributionFromTrajectory(UAdvancedPhysicsComponent* PC, const FIndexedTrajectory& Trajectory)
 {
     FBallLaunchVerticalDistribution Out;
 
@@ -101,8 +220,8 @@ FBallLaunchVerticalDistribution USpinMovementLib::CalculateVerticalDistributionF
     auto VerticalLevels = Params->GetTargetVerticalLevels();
     const float LevelWidth = Params->GetVerticalLevelWidth();
     const float Radius = PC->GetRadius() + 1.0f;
-    const float TimeMaxZ = Curve.GetMaxZTime();
-    const FVector StartLocation = Curve.GetValueAtZero();
+    const float TimeMaxZ = Trajectory.GetMaxZTime();
+    const FVector StartLocation = Trajectory.GetStartLocation();
     
     // we limit results by distance from launch position to save more space
     
@@ -118,8 +237,8 @@ FBallLaunchVerticalDistribution USpinMovementLib::CalculateVerticalDistributionF
 
         TArray<float> MinTimes = {};
         TArray<float> MaxTimes = {};
-        const bool HasMin = Curve.GetTimesWhenZEquals(MinZ, MinTimes);
-        const bool HasMax = Curve.GetTimesWhenZEquals(MaxZ, MaxTimes);
+        const bool HasMin = Trajectory.GetTimesAtZ(MinZ, MinTimes);
+        const bool HasMax = Trajectory.GetTimesAtZ(MaxZ, MaxTimes);
         const bool HasMinMax = HasMin && HasMax;
 
         if(HasMinMax)
@@ -128,8 +247,8 @@ FBallLaunchVerticalDistribution USpinMovementLib::CalculateVerticalDistributionF
                         
             for (const auto TimePair : TimePairs)
             {
-                FVector MinLocation = Curve.GetVectorValue(TimePair.Min);
-                FVector MaxLocation = Curve.GetVectorValue(TimePair.Max);
+                FVector MinLocation = Trajectory.GetLocationAtTime(TimePair.Min);
+                FVector MaxLocation = Trajectory.GetLocationAtTime(TimePair.Max);
 
                 const float MinDistanceXY = (MinLocation - StartLocation).Size2D();
                 const float MaxDistanceXY = (MaxLocation - StartLocation).Size2D();
@@ -152,7 +271,7 @@ FBallLaunchVerticalDistribution USpinMovementLib::CalculateVerticalDistributionF
 FCustomVectorCurve USpinMovementLib::CalculateSpinTrajectory(UAdvancedPhysicsComponent* Obj, const FBallLaunchParams& P, FVector COM, float TimeStep, int NumSteps, FPhysTransform& TLaunch)
 {
     const auto Impulse = GetImpulseFromBallLaunchParams(Obj, P, COM);
-    return CalculateSpinTrajectory(Obj, Impulse, COM, TimeStep, NumSteps, TLaunch);
+    return CalculateSpinTrajectory(Obj, MakeBallLaunchCacheBody(Obj), Impulse, COM, TimeStep, NumSteps, TLaunch);
 }
 
 uint8 USpinMovementLib::GetVerticalLevelIndexFromDistanceZ(float DistanceZ, float LevelWidth)
@@ -49,7 +49,7 @@ FTrajectoryData UTrajectoryPredictionLib::CalculateTrajectoryDataFromImpulse(UAd
     const auto Points = Obj->PredictMovementFromTransformAnyTimeStepAndGetLocations(Impact, SimStep, NumSteps, bCheckCollisions, bLimitZ, LimitZ);
     const auto Trajectory = FCustomVectorCurve(Points, SimStep);
         
-    OutData.Init(Impact, Trajectory, Target);
+    OutData.Init(Impact, Trajectory, Target, SimStep);
     
     return OutData;
 }
@@ -171,7 +171,7 @@ FTrajectoryData UTrajectoryPredictionLib::GetCorrectedTrajectoryFromUnreachable(
 
     auto OutData = FTrajectoryData();
     const auto Trajectory = ComputeTrajectoryFromTransform(Obj, T, PhysSimStep, PhysNumSteps);
-    OutData.Init(T, Trajectory, CompData.Target);
+    OutData.Init(T, Trajectory, CompData.Target, PhysSimStep);
 
     return GetCorrectedTrajectoryData(Obj, CompData, OutData);
 }
@@ -220,18 +220,19 @@ float UTrajectoryPredictionLib::GetTrajectoryDeltaX(UAdvancedPhysicsComponent* O
     constexpr bool bLimitZ = true;
     constexpr bool bCheckCollisions = false;
 
-    const auto CurveBase = BaseData.Trajectory;
-    const auto CurveFirstIter = Obj->PredictMovementFromTransformAndGetTrajectoryAsCurveAnyTimeStep(T_FirstIter, TimeStep, NumSteps, bCheckCollisions, bLimitZ, LimitZ);
+    const auto PointsFirstIter = Obj->PredictMovementFromTransformAnyTimeStepAndGetLocations(T_FirstIter, TimeStep, NumSteps, bCheckCollisions, bLimitZ, LimitZ);
+    const auto IndexBase = BaseData.HasIndex() ? BaseData.Index : FIndexedTrajectory(BaseData.GetTrajectoryPoints(), TimeStep);
+    const auto IndexFirstIter = FIndexedTrajectory(PointsFirstIter, TimeStep);
 
     float t0, t1;
-    const bool b0 = CurveBase.GetLastTimeWhenZEquals(t0);
-    const bool b1 = CurveFirstIter.GetLastTimeWhenZEquals(t1);
+    const bool b0 = IndexBase.GetLastTimeAtZ(LimitZ, t0);
+    const bool b1 = IndexFirstIter.GetLastTimeAtZ(LimitZ, t1);
 
     check(b0)
     check(b1)
 
-    const FVector V0 = CurveBase.GetVectorValue(t0);
-    const FVector V1 = CurveFirstIter.GetVectorValue(t1);
+    const FVector V0 = IndexBase.GetLocationAtTime(t0);
+    const FVector V1 = IndexFirstIter.GetLocationAtTime(t1);
     const FVector VP0 = V0.ProjectOnToNormal(BaseDir);
     const FVector VP1 = V1.ProjectOnToNormal(BaseDir);
 
@@ -50,6 +50,14 @@ void UUtilsLib::SubscribeToPhysicsProcessor(UCustomPhysicsBaseComponent* Obj)
     }
 }
 
+void UUtilsLib::UnsubscribeFromPhysicsProcessor(UCustomPhysicsBaseComponent* Obj)
+{
+    if(UCustomPhysicsProcessor* PhysicsProcessor = GetPhysicsProcessor())
+    {
+        PhysicsProcessor->UnsubscribeObject(Obj);
+    }
+}
+
 void UUtilsLib::UpdateTimeBasedGenerator(FGeneratorTimeBased& G, float DeltaTime)
 {
     if(G.DoUpdate())
@@ -61,11 +69,7 @@ void UUtilsLib::UpdateTimeBasedGenerator(FGeneratorTimeBased& G, float DeltaTime
 
         UMathUtils::ExtractDataFromTimeForPrediction(DeltaTime, CurrentTimeBNP, SimStep, NumUpdateSteps, _, __, NextTimeBeforeUpdate);
 
-        for (int i = 0; i < NumUpdateSteps; ++i)
-        {
-            G.UpdateOneStep();
-        }
-        
+        G.AdvanceSteps(NumUpdateSteps);
         G.SetTimeBeforeNextUpdate(NextTimeBeforeUpdate);
     }
 }
@@ -67,10 +67,12 @@ FParabolicMotionCurve UParabolicMotionToRealLib::GetParabolicMultiplierCurveForL
         if(LaunchAngle >= DirectAngle)
         {
             const float DistanceX = TargetLocation.X - Location.X;
-            float LaunchSpeed, RealMaxDistance;
-            const float Multiplier = GetParabolicMultiplier(Obj, CompData, LaunchSpeed, RealMaxDistance);
-            RefCurve->AddKey(DistanceX, Multiplier);
-            MaxDistanceCurve->AddKey(LaunchSpeed, RealMaxDistance);
+            float Multiplier, LaunchSpeed, RealMaxDistance;
+            if(GetParabolicMultiplier(Obj, CompData, Multiplier, LaunchSpeed, RealMaxDistance))
+            {
+                RefCurve->AddKey(DistanceX, Multiplier);
+                MaxDistanceCurve->AddKey(LaunchSpeed, RealMaxDistance);
+            }
         }
         else
         {
@@ -96,25 +98,34 @@ FPMCompData UParabolicMotionToRealLib::CreateParabolicCompParams(UAdvancedPhysic
     const float Tolerance = Params->ComputationLocationTolerance;
     const float MultiplierChangeStep = Params->MultiplierChangeStep;
     CompData.Init(TargetLocation, LaunchLocation, LaunchAngle, TimeStep, NumSteps, Tolerance, MultiplierChangeStep);
+    CompData.MaxSolverIterations = Params->MaxSolverIterations;
 
     return CompData;
 }
 
-float UParabolicMotionToRealLib::GetParabolicMultiplier(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, float& LaunchSpeed, float& MaxDistance)
+bool UParabolicMotionToRealLib::GetParabolicMultiplier(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, float& Multiplier, float& LaunchSpeed, float& MaxDistance)
 {
     const float LaunchAngle = CompData.LaunchAngle;
     const FVector TargetLocation = CompData.TargetLocation;
     const FVector LaunchLocation = CompData.LaunchLocation;
     const FVector V = CompData.GetVectorToTargetRelative();
 
-    check(V.X >= 0.0f)
+    Multiplier = 1.0f;
+    LaunchSpeed = 0.0f;
+    MaxDistance = 0.0f;
+
+    if(V.X < 0.0f)
+    {
+        PrintToLog("Target is behind launch location, no parabolic multiplier");
+        return false;
+    }
 
     const float DirectAngle = CalculateDirectAngle(TargetLocation, LaunchLocation);
     const bool bInvalidAngle = LaunchAngle < DirectAngle;
     if(bInvalidAngle)
     {
         PrintToLog("Invalid angle for parabolic multiplier");
-        return 1.0f;
+        return false;
     }
     
     const float ParabolicSpeed = UParabolicMotionLib::GetRequiredLaunchSpeedForAngle(LaunchAngle, V.X, V.Z);
@@ -124,105 +135,162 @@ float UParabolicMotionToRealLib::GetParabolicMultiplier(UAdvancedPhysicsComponen
     const FVector AV = FVector::ZeroVector;
     const auto T_Parabolic = FPhysTransform(LaunchLocation, FQuat::Identity, LV_Base, AV);
 
-    const float OutMultiplier = GetParabolicMultiplier_Body(Obj, CompData, T_Parabolic, 1.0f);
+    const auto Result = SolveParabolicMultiplier(Obj, CompData, T_Parabolic, 1.0f);
+    if(!Result.bGroundHit)
+    {
+        // computation time of CompData is too short for trajectory to land
+        PrintToLog("Parabolic multiplier: trajectory doesn't reach ground for angle " + FString::SanitizeFloat(LaunchAngle));
+        return false;
+    }
 
+    if(!Result.bConverged)
     {
-        auto TResult = T_Parabolic;
-        TResult.ScaleLinearVelocity(OutMultiplier);
-        const auto RealCurve = CalculateMotionCurveFromTransform(Obj, TResult, CompData.TimeStep, CompData.NumSteps);
-        float GroundTime;
-        const bool bValid = RealCurve.GetLastTimeWhenZEquals(GroundTime, 0.0f);
-        check(bValid)
-        
-        LaunchSpeed = TResult.LinearVelocity.Size();
-        MaxDistance = (RealCurve.GetVectorValue(GroundTime) - TResult.Location).Size2D();
+        PrintToLog("Parabolic multiplier not converged for angle " + FString::SanitizeFloat(LaunchAngle) + " residual: " + FString::SanitizeFloat(Result.Residual));
     }
+
+    Multiplier = Result.Multiplier;
+    LaunchSpeed = ParabolicSpeed * Result.Multiplier;
+    MaxDistance = Result.GroundDistance;
     
-    return OutMultiplier;
+    return true;
 }
 
-float UParabolicMotionToRealLib::GetParabolicMultiplier_Body(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, const FPhysTransform& T_Parabolic, float BaseMultiplier)
+FPMSolverSample UParabolicMotionToRealLib::EvaluateParabolicMultiplier(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, const FPhysTransform& T_Parabolic, float Multiplier)
 {
-    const auto Comparison = GetComparisonBaseToOneStep(Obj, T_Parabolic, CompData.TimeStep, CompData.NumSteps, BaseMultiplier, CompData.MultiplierChangeStep);
+    FPMSolverSample Out;
+    Out.Multiplier = Multiplier;
+
+    auto T = T_Parabolic;
+    T.LinearVelocity *= Multiplier;
+    const auto Curve = CalculateMotionCurveFromTransform(Obj, T, CompData.TimeStep, CompData.NumSteps);
 
-    const float MulIncreaseStep = CompData.MultiplierChangeStep;
     const FVector Target = CompData.TargetLocation;
-    const float TargetX = Target.X;
-    const float TargetZ = Target.Z;
-    const auto CurveBase = &Comparison.CurveBase;
-    const float StepDeltaX = Comparison.GetStepDeltaX();
-    const float StepDeltaZ = Comparison.GetStepDeltaZ();
     constexpr float XAdditionalOffset = 15.0f;
-    const float TargetDeltaX = TargetX  + XAdditionalOffset - Comparison.GetBaseXWhenZeroZ();
+
+    float GroundTime;
+    Out.bGroundHit = Curve.GetLastTimeWhenZEquals(GroundTime, 0.0f);
+    const FVector GroundLocation = Out.bGroundHit ? Curve.GetVectorValue(GroundTime) : T.Location;
+    Out.GroundDistance = (GroundLocation - T.Location).Size2D();
 
     TArray<FVector> LocationsSearchX;
-    const bool bBaseReachX = CurveBase->GetAllVectorsWhereXEquals(TargetX, LocationsSearchX);
+    Out.bReachX = Curve.GetAllVectorsWhereXEquals(Target.X, LocationsSearchX);
 
-    if(bBaseReachX)
+    if(Out.bReachX)
     {
         const FVector NearestLocation = UHMV::GetNearestLocation(LocationsSearchX, Target);
-        const float TargetDeltaZ = TargetZ - NearestLocation.Z;
-        const float Distance = FMath::Abs(TargetDeltaZ);
-        
-        if(Distance <= CompData.LocationTolerance)
-        {
-            return BaseMultiplier;
-        }
-
-        const float MulChange = ComputeMultiplierChangeValue(TargetDeltaZ, StepDeltaZ, MulIncreaseStep);
-        const float NewMultiplier = BaseMultiplier + MulChange;
-        return GetParabolicMultiplier_Body(Obj, CompData, T_Parabolic, NewMultiplier);
+        Out.Residual = NearestLocation.Z - Target.Z;
+    }
+    else
+    {
+        // target is never reached so ground contact is short of it and residual stays negative
+        Out.Residual = FMath::Min(GroundLocation.X - (Target.X + XAdditionalOffset), -CompData.LocationTolerance);
     }
     
-    const float MulChange = ComputeMultiplierChangeValue(TargetDeltaX, StepDeltaX, MulIncreaseStep);
-    const float NewMultiplier = BaseMultiplier + MulChange;
-    return GetParabolicMultiplier_Body(Obj, CompData, T_Parabolic, NewMultiplier);
+    return Out;
 }
 
-float UParabolicMotionToRealLib::ComputeMultiplierChangeValue(float DistanceDelta, float StepDelta, float MulIncreaseStep)
+FPMSolverResult UParabolicMotionToRealLib::SolveParabolicMultiplier(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, const FPhysTransform& T_Parabolic, float InitialMultiplier)
 {
-    return (DistanceDelta / StepDelta) * MulIncreaseStep;
-}
+    FPMSolverResult Out;
 
-FTrajectoryStepComparison UParabolicMotionToRealLib::GetComparisonBaseToOneStep(UAdvancedPhysicsComponent* Obj, const FPhysTransform& T_Parabolic, float TimeStep, int NumSteps, float BaseMultiplier, float MultiplierStep)
-{
-    FTrajectoryStepComparison Out;
-    
-    auto T_Base = T_Parabolic;
-    T_Base.LinearVelocity *= BaseMultiplier;
-    
-    auto T_FirstIter = T_Base;
-    T_FirstIter.LinearVelocity *= BaseMultiplier + MultiplierStep;
+    const int MaxIterations = FMath::Max(2, CompData.MaxSolverIterations);
+    const float Tolerance = CompData.LocationTolerance;
+    const float MinStep = FMath::Max(CompData.MultiplierChangeStep, KINDA_SMALL_NUMBER);
+    constexpr float MinMultiplier = 0.01f;
+    constexpr float MaxBracketGrowth = 4.0f;
 
-    const auto CurveBase = CalculateMotionCurveFromTransform(Obj, T_Base, TimeStep, NumSteps);
-    const auto CurveFirstIter = CalculateMotionCurveFromTransform(Obj, T_FirstIter, TimeStep, NumSteps);
+    FPMSolverSample Best;
+    bool bHasBest = false;
 
-    float t0, t1;
-    const bool b0 = CurveBase.GetLastTimeWhenZEquals(t0);
-    const bool b1 = CurveFirstIter.GetLastTimeWhenZEquals(t1);
-    check(b0)
-    check(b1)
+    auto IsConverged = [Tolerance](const FPMSolverSample& S){ return S.bReachX && FMath::Abs(S.Residual) <= Tolerance; };
+    auto Evaluate = [&](float Multiplier)
+    {
+        const auto S = EvaluateParabolicMultiplier(Obj, CompData, T_Parabolic, Multiplier);
+        ++Out.NumSimulations;
+        if(!bHasBest || FMath::Abs(S.Residual) < FMath::Abs(Best.Residual))
+        {
+            Best = S;
+            bHasBest = true;
+        }
+        return S;
+    };
+    auto Finish = [&](bool bConverged)
+    {
+        Out.ApplySample(Best);
+        Out.bConverged = bConverged;
+        return Out;
+    };
 
-    const float X_BaseZero = CurveBase.GetVectorValue(t0).X;
-    const float X_FirstIterZero = CurveFirstIter.GetVectorValue(t1).X;
-    const float StepDeltaZ = CurveFirstIter.GetVectorValue(t0).Z;
+    // bracketing: walk in the direction of the root, using secant estimate to size the step
+    FPMSolverSample A = Evaluate(InitialMultiplier);
+    if(IsConverged(A)) return Finish(true);
 
-    const bool bExpectedChangeX = X_FirstIterZero > X_BaseZero;
+    FPMSolverSample B = Evaluate(FMath::Max(MinMultiplier, InitialMultiplier + (A.Residual < 0.0f ? MinStep : -MinStep)));
+    if(IsConverged(B)) return Finish(true);
 
-    if(!bExpectedChangeX)
+    while(FMath::Sign(A.Residual) == FMath::Sign(B.Residual))
     {
-        PrintToLog("Base: " + FString::SanitizeFloat(X_BaseZero) + " Iter: " + FString::SanitizeFloat(X_FirstIterZero));
+        if(Out.NumSimulations >= MaxIterations) return Finish(false);
+        
+        const float Width = FMath::Abs(B.Multiplier - A.Multiplier);
+        const float Direction = B.Residual < 0.0f ? 1.0f : -1.0f;
+        const float ResidualDelta = B.Residual - A.Residual;
+        
+        float NextWidth = Width * 2.0f;
+        if(!FMath::IsNearlyZero(ResidualDelta))
+        {
+            const float SecantWidth = FMath::Abs(B.Residual * (B.Multiplier - A.Multiplier) / ResidualDelta);
+            // overshoot secant a bit so the root ends up inside the bracket
+            NextWidth = FMath::Clamp(SecantWidth * 1.25f, MinStep, Width * MaxBracketGrowth);
+        }
+
+        float Next = B.Multiplier + Direction * NextWidth;
+        if(Next <= MinMultiplier)
+        {
+            if(B.Multiplier <= MinMultiplier) return Finish(false);
+            Next = FMath::Max(MinMultiplier, 0.5f * (B.Multiplier + MinMultiplier));
+        }
+        
+        A = B;
+        B = Evaluate(Next);
+        if(IsConverged(B)) return Finish(true);
     }
-    
-    check(bExpectedChangeX)
 
-    Out.CurveBase = CurveBase;
-    Out.CurveFirstIter = CurveFirstIter;
-    Out.X_BaseWhenZeroZ = X_BaseZero;
-    Out.X_OneStepWhenZeroZ = X_FirstIterZero;
-    Out.StepDeltaZ = StepDeltaZ;
+    // Illinois: regula falsi with halving of the stale endpoint's weight
+    FPMSolverSample Lo = A.Residual < 0.0f ? A : B;
+    FPMSolverSample Hi = A.Residual < 0.0f ? B : A;
+    float LoResidual = Lo.Residual;
+    float HiResidual = Hi.Residual;
+    int LastSide = 0;
 
-    return Out;
+    while(Out.NumSimulations < MaxIterations)
+    {
+        if(FMath::Abs(Hi.Multiplier - Lo.Multiplier) <= CompData.MultiplierTolerance)
+        {
+            return Finish(Best.bReachX);
+        }
+        
+        const float Next = (Lo.Multiplier * HiResidual - Hi.Multiplier * LoResidual) / (HiResidual - LoResidual);
+        const auto S = Evaluate(Next);
+        if(IsConverged(S)) return Finish(true);
+
+        if(S.Residual < 0.0f)
+        {
+            Lo = S;
+            LoResidual = S.Residual;
+            if(LastSide == -1) HiResidual *= 0.5f;
+            LastSide = -1;
+        }
+        else
+        {
+            Hi = S;
+            HiResidual = S.Residual;
+            if(LastSide == 1) LoResidual *= 0.5f;
+            LastSide = 1;
+        }
+    }
+    
+    return Finish(false);
 }
 
 void UParabolicMotionToRealLib::DrawCurveTrajectory(UObject* Obj, FCustomVectorCurve Curve, FLinearColor Color)
@@ -376,6 +444,15 @@ bool UParabolicMotionToRealLib::GetTrajectoryGroundLocation(const FCustomVectorC
     return bGround;
 }
 
+bool UParabolicMotionToRealLib::GetTrajectoryGroundLocation(const FIndexedTrajectory& Trajectory, FVector& OutLocation, bool bCheckForTrue)
+{
+    float GroundTime;
+    const bool bGround = Trajectory.GetLastTimeAtZ(0.0f, GroundTime);
+    if(bCheckForTrue) check(bGround)
+    OutLocation = Trajectory.GetLocationAtTime(GroundTime);
+    return bGround;
+}
+
 FCustomVectorCurve UParabolicMotionToRealLib::CalculateMotionCurveFromTransform(UAdvancedPhysicsComponent* Obj, const FPhysTransform& T, float TimeStep, int NumSteps)
 {
     constexpr float LimitZ = 0.0f;
@@ -1,7 +1,8 @@
 ﻿#include "Common/PhysPredict.h"
-#include "CommonUtils/Public/Utils.h"
 #include "Components/CustomPhysicsComponent.h"
 #include "Components/CustomPhysicsProcessor.h"
+#include "Async/Async.h"
+#include "Libs/PhysicsUtils.h"
 
 
 int FPhysPredict::GetPreciseStepsCount() const
@@ -29,10 +30,31 @@ int FPhysPredict::GetRoughStepsCount() const
 
 void FPhysPredict::RecomputePrediction()
 {
+	bRecomputePending = false;
 	RecomputePrecisePredict();
 	RecomputeRoughPredict();
 }
 
+void FPhysPredict::RequestRecompute()
+{
+	bRecomputePending = true;
+	RecomputeStats.NumRequested++;
+}
+
+bool FPhysPredict::FlushRecompute()
+{
+	if(!bRecomputePending) return false;
+	if(!bPredict)
+	{
+		bRecomputePending = false;
+		return false;
+	}
+
+	RecomputePrediction();
+	RecomputeStats.NumPerformed++;
+	return true;
+}
+
 void FPhysPredict::EnablePrediction()
 {
 	if(Comp)
@@ -45,8 +67,13 @@ void FPhysPredict::EnablePrediction()
 void FPhysPredict::DisablePrediction()
 {
 	bPredict = false;
+	bRecomputePending = false;
+	RoughPredictJob.Reset();
+	GroundRollJobs.Reset();
 	PrecisePredictedTransforms.Empty();
 	RoughPredictedTransforms.Empty();
+	PreciseContacts.Reset();
+	RoughContacts.Reset();
 }
 
 float FPhysPredict::GetSimulationDeltaTime() const
@@ -61,15 +88,17 @@ float FPhysPredict::GetSimulationDeltaTime() const
 void FPhysPredict::RecomputePrecisePredict()
 {
 	TimeLeftToNextPPT = GetSimulationDeltaTime();
-	PrecisePredictedTransforms.Empty();
 
 	if(Comp->PhysicsProcessor)
 	{
 		const int StepsToAdd = GetPreciseStepsCount();
+		PrecisePredictedTransforms.Reset(StepsToAdd);
+		PreciseContacts.Reset(Comp->PhysicsProcessor->GetLiveContactCache());
 		AddStepsToPrecisePredictArray(StepsToAdd);
 	}
 	else
 	{
+		PrecisePredictedTransforms.Reset(1);
 		PrecisePredictedTransforms.Add(Comp->CurrentTransform);
 	}
 }
@@ -77,21 +106,145 @@ void FPhysPredict::RecomputePrecisePredict()
 void FPhysPredict::RecomputeRoughPredict()
 {
 	TimeSinceRoughPredictUpdate = 0.0f;
-	RoughPredictedTransforms.Empty();
+
+	// previous result is served while new one is computed, so the very first one is computed in place
+	const bool bAsync = Settings.bAsyncRoughPredict && HasRoughPredicted();
+	if(bAsync && StartRoughPredictJob()) return;
+	RoughPredictJob.Reset();
 
 	if(Comp->PhysicsProcessor)
 	{
 		const int StepsToAdd = GetRoughStepsCount();
+		RoughPredictedTransforms.Reset(StepsToAdd);
+		// starts from last precise step
+		RoughContacts = PreciseContacts;
 		AddStepsToRoughPredictArray(StepsToAdd);
 	}
 	else
 	{
+		RoughPredictedTransforms.Reset(1);
 		RoughPredictedTransforms.Add(Comp->CurrentTransform);
 	}
 	
 	Comp->OnRoughPredictionRecomputed.Broadcast();
 }
 
+bool FPhysPredict::MakeRoughPredictionInput(FRoughPredictionInput& In)
+{
+	const auto Processor = Comp ? Comp->PhysicsProcessor : nullptr;
+	if(!Processor || !Comp->IsCustomPhysicsEnabled()) return false;
+
+	In.StartTransform = *GetLastPrecisePredictedTransformPtrOrObjCurrentTransform();
+	In.RbParams = Comp->PhysicsParams;
+	In.SimStep = GetRoughSimulationTimeStep();
+	In.NumSteps = GetRoughStepsCount();
+	In.AdaptiveStep = Settings.RoughAdaptiveStep;
+	In.SetFromObject(Comp);
+	In.bCheckCollisions = true;
+	In.ContactSolverIterations = Processor->ContactSolverIterations;
+	In.bContactSolverWarmStart = Processor->bContactSolverWarmStart;
+
+	In.Colliders.Reserve(Processor->SimpleObjects.Num());
+	for (const auto Obj : Processor->SimpleObjects)
+	{
+		if(!Obj) continue;
+		
+		Obj->UpdateCollisionSnapshot();
+		if(!Obj->GetCollisionSnapshot().IsValid()) return false;
+
+		In.Colliders.AddDefaulted_GetRef().SetFromObject(Obj);
+	}
+
+	if(Settings.bTabulatedGroundRoll) AssignGroundRollTables(In);
+	return true;
+}
+
+void FPhysPredict::AssignGroundRollTables(FRoughPredictionInput& In)
+{
+	auto RbParams = In.RbParams;
+	RbParams.Radius = In.Radius;
+	const float SimStep = GetSimulationDeltaTime();
+	const uint32 ParamsSignature = FBallGroundMovementData::MakeParamsSignature(RbParams, SimStep, In.ContactSolverIterations, In.bContactSolverWarmStart);
+
+	TSet<uint32> UsedSignatures;
+	for (auto& C : In.Colliders)
+	{
+		// ground is not known before job finds it, so every resting collider gets table of its own contact values
+		if(!C.IsResting()) continue;
+
+		const float Friction = UPhysicsUtils::CombinePhysValue(C.Friction, In.Friction, In.FrictionCombineMode);
+		const EPhysicsCombineMode RestitutionMode = UPhysicsUtils::SelectPhysCombineMode(C.RestitutionCombineMode, In.RestitutionCombineMode);
+		const float Restitution = UPhysicsUtils::CombinePhysValue(C.Restitution, In.Restitution, RestitutionMode);
+		const uint32 Signature = FBallGroundMovementData::MakeSignature(ParamsSignature, Friction, Restitution);
+		UsedSignatures.Add(Signature);
+
+		if(const auto Table = GroundRollTables.Find(Signature)) C.GroundRoll = *Table;
+		else if(!GroundRollJobs.Contains(Signature)) StartGroundRollJob(In, RbParams, Friction, Restitution, Signature);
+	}
+
+	for (auto It = GroundRollTables.CreateIterator(); It; ++It)
+	{
+		if(!UsedSignatures.Contains(It.Key())) It.RemoveCurrent();
+	}
+	// dropped jobs finish in background and are released by worker
+	for (auto It = GroundRollJobs.CreateIterator(); It; ++It)
+	{
+		if(!UsedSignatures.Contains(It.Key())) It.RemoveCurrent();
+	}
+}
+
+void FPhysPredict::StartGroundRollJob(const FRoughPredictionInput& In, const FPhysRigidBodyParams& RbParams, float Friction, float Restitution, uint32 Signature)
+{
+	const auto Job = MakeShared<FGroundRollBuildJob, ESPMode::ThreadSafe>();
+	Job->RbParams = RbParams;
+	Job->SimStep = GetSimulationDeltaTime();
+	Job->Friction = Friction;
+	Job->Restitution = Restitution;
+	Job->ContactSolverIterations = In.ContactSolverIterations;
+	Job->bContactSolverWarmStart = In.bContactSolverWarmStart;
+	Job->Signature = Signature;
+
+	GroundRollJobs.Add(Signature, Job);
+	Async(EAsyncExecution::ThreadPool, [Job]()
+	{
+		Job->Run();
+	});
+}
+
+void FPhysPredict::PollGroundRollJobs()
+{
+	for (auto It = GroundRollJobs.CreateIterator(); It; ++It)
+	{
+		if(!It.Value()->IsCompleted()) continue;
+		
+		GroundRollTables.Add(It.Key(), It.Value()->Result);
+		It.RemoveCurrent();
+	}
+}
+
+bool FPhysPredict::StartRoughPredictJob()
+{
+	const auto Job = MakeShared<FRoughPredictionJob, ESPMode::ThreadSafe>();
+	if(!MakeRoughPredictionInput(Job->Input)) return false;
+
+	RoughPredictJob = Job;
+	Async(EAsyncExecution::ThreadPool, [Job]()
+	{
+		Job->Run();
+	});
+	return true;
+}
+
+void FPhysPredict::PollRoughPredictJob()
+{
+	if(RoughPredictJob.IsValid() && RoughPredictJob->IsCompleted())
+	{
+		RoughPredictedTransforms = MoveTemp(RoughPredictJob->Result);
+		RoughPredictJob.Reset();
+		Comp->OnRoughPredictionRecomputed.Broadcast();
+	}
+}
+
 void FPhysPredict::AddStepsToPrecisePredictArray(const int StepsToAdd)
 {
 	if(Comp)
@@ -100,7 +253,7 @@ void FPhysPredict::AddStepsToPrecisePredictArray(const int StepsToAdd)
 		for (int i = 0; i < StepsToAdd; ++i)
 		{
 			const float SkipTime = PrecisePredictedTransforms.Num() * StepTime;
-			auto NewTransform = Comp->CalculateNextPreciseTransform(*GetLastPrecisePredictedTransformPtrOrObjCurrentTransform(), SkipTime, true);
+			auto NewTransform = Comp->CalculateNextPreciseTransform(*GetLastPrecisePredictedTransformPtrOrObjCurrentTransform(), SkipTime, PreciseContacts, true);
 			PrecisePredictedTransforms.Add(NewTransform);
 		}
 	}
@@ -115,7 +268,7 @@ void FPhysPredict::AddStepsToRoughPredictArray(const int StepsToAdd)
 			constexpr float SkipTime = 0;
 			auto T = *GetLastRoughPredictedTransformPtrOrLastPreciseTransform();
 			const float SimStep = GetRoughSimulationTimeStep();
-			auto NewTransform = Comp->CalculateNextRoughTransform(T, SimStep, SkipTime, true);
+			auto NewTransform = Comp->CalculateNextRoughTransform(T, SimStep, SkipTime, RoughContacts, true);
 			RoughPredictedTransforms.Add(NewTransform);
 		}
 	}
@@ -124,17 +277,19 @@ void FPhysPredict::AddStepsToRoughPredictArray(const int StepsToAdd)
 void FPhysPredict::UpdatePrecisePredictionDataBySteps(int StepsToUpdate)
 {
 	if(StepsToUpdate < 1) return;
-	CommonUtils::RemoveArrayItemsFromEdge(PrecisePredictedTransforms, StepsToUpdate, true);
+	PrecisePredictedTransforms.RemoveFromFront(StepsToUpdate);
 	AddStepsToPrecisePredictArray(StepsToUpdate);
 }
 
 void FPhysPredict::AdvanceByTime(float TimeBeforeNextPredict, int StepsToUpdate)
 {
+	PollRoughPredictJob();
+	PollGroundRollJobs();
 	SetTimeBeforeNextPredict(TimeBeforeNextPredict);
 	UpdatePrecisePredictionDataBySteps(StepsToUpdate);
 	TimeSinceRoughPredictUpdate += StepsToUpdate * GetSimulationDeltaTime();
 
-	const bool ShouldRecomputeRough = ShouldRecomputeRoughPredict(TimeSinceRoughPredictUpdate);
+	const bool ShouldRecomputeRough = !IsRoughPredictInProgress() && ShouldRecomputeRoughPredict(TimeSinceRoughPredictUpdate);
 	if(ShouldRecomputeRough)
 	{
 		RecomputeRoughPredict();
@@ -143,12 +298,12 @@ void FPhysPredict::AdvanceByTime(float TimeBeforeNextPredict, int StepsToUpdate)
 
 FPhysTransform* FPhysPredict::GetFirstPrecisePredictedTransformPtr()
 {
-	return HasTPredicted() ? &PrecisePredictedTransforms[0] : nullptr;
+	return PrecisePredictedTransforms.GetFirstPtr();
 }
 
 FPhysTransform* FPhysPredict::GetLastPrecisePredictedTransformPtr()
 {
-	return HasTPredicted() ? &PrecisePredictedTransforms.Last() : nullptr;
+	return PrecisePredictedTransforms.GetLastPtr();
 }
 
 FPhysTransform* FPhysPredict::GetLastPrecisePredictedTransformPtrOrObjCurrentTransform()
@@ -160,12 +315,12 @@ FPhysTransform* FPhysPredict::GetLastPrecisePredictedTransformPtrOrObjCurrentTra
 
 FPhysTransform* FPhysPredict::GetFirstRoughPredictedTransformPtr()
 {
-	return HasRoughPredicted() ? &RoughPredictedTransforms[0] : nullptr;
+	return RoughPredictedTransforms.GetFirstPtr();
 }
 
 FPhysTransform* FPhysPredict::GetLastRoughPredictedTransformPtr()
 {
-	return HasRoughPredicted() ? &RoughPredictedTransforms.Last() : nullptr;
+	return RoughPredictedTransforms.GetLastPtr();
 }
 
 FPhysTransform* FPhysPredict::GetLastRoughPredictedTransformPtrOrLastPreciseTransform()
@@ -177,19 +332,20 @@ FPhysTransform* FPhysPredict::GetLastRoughPredictedTransformPtrOrLastPreciseTran
 
 FPhysTransform* FPhysPredict::GetPrecisePredictedTransformPtrAfterStepCount(int NumSubsteps) 
 {
-	return Native::ArrayGetElementByIndexInBounds(NumSubsteps, PrecisePredictedTransforms);
+	return PrecisePredictedTransforms.GetPtrInBounds(NumSubsteps);
 }
 
 FPhysTransform* FPhysPredict::GetRoughPredictedTransformPtrAfterStepCount(int NumSubsteps) 
 {
-	return Native::ArrayGetElementByIndexInBounds(NumSubsteps, RoughPredictedTransforms);
+	return RoughPredictedTransforms.GetPtrInBounds(NumSubsteps);
 }
 
 TArray<FVector> FPhysPredict::GetPredictedLocations()
 {
 	TArray<FVector> A;
-	for (auto Element : PrecisePredictedTransforms) A.Add(Element.Location);
-	for (auto Element : RoughPredictedTransforms) A.Add(Element.Location);
+	A.Reserve(PrecisePredictedTransforms.Num() + RoughPredictedTransforms.Num());
+	for (int i = 0; i < PrecisePredictedTransforms.Num(); ++i) A.Add(PrecisePredictedTransforms[i].Location);
+	for (int i = 0; i < RoughPredictedTransforms.Num(); ++i) A.Add(RoughPredictedTransforms[i].Location);
 	return A;
 }
 
@@ -3,25 +3,30 @@
 #include "debug.h"
 #include "HandyMathArrayLibrary.h"
 #include "Libs/SpinMovementLib.h"
+#include "PhysicsCache/BallLaunchCacheResidency.h"
 
 void FBallLaunchCache_Data::SetLaunchSpeedVector(const TArray<float>& LaunchSpeedData)
 {
     LaunchSpeedHV.MakeCurveFromValues(LaunchSpeedData);
+    LaunchSpeedHashes = MakeAxisHashes(LaunchSpeedHV, LaunchSpeedData);
 }
 
 void FBallLaunchCache_Data::SetLaunchAngleVector(const TArray<float>& Data)
 {
     LaunchAngleHV.MakeCurveFromValues(Data);    
+    LaunchAngleHashes = MakeAxisHashes(LaunchAngleHV, Data);
 }
 
 void FBallLaunchCache_Data::SetFrontSpinAngleVector(const TArray<float>& Data)
 {
     FrontSpinAngleHV.MakeCurveFromValues(Data);
+    FrontSpinAngleHashes = MakeAxisHashes(FrontSpinAngleHV, Data);
 }
 
 void FBallLaunchCache_Data::SetSideSpinAngleVector(const TArray<float>& Data)
 {
     SideSpinAngleHV.MakeCurveFromValues(Data);
+    SideSpinAngleHashes = MakeAxisHashes(SideSpinAngleHV, Data);
 }
 
 void FBallLaunchCache_Data::Validate() const
@@ -33,18 +38,221 @@ void FBallLaunchCache_Data::Validate() const
     check(VerticalLevelWidth > 0.0f)
 }
 
-void FBallLaunchCache_Data::AddVerticalDistribution(const FBallLaunchParams& Input, const FBallLaunchVerticalDistribution& S)
+void FBallLaunchCache_Data::InitGrid()
 {
-    const auto Hash = HashRealValuesToClosest(Input);
-    check(!VerticalDistribution.Contains(Hash))
-    VerticalDistribution.Add(Hash, S);
+    const int NumCells = GetNumGridCells();
+    GridCellOffset = 0;
+    NumItems = 0;
+    MaxDistanceGrid.Init(-1.0f, NumCells);
+    VerticalRangeStart.Init(0, NumCells);
+    VerticalRangeNum.Init(0, NumCells);
+    VerticalRanges.Empty();
+}
+
+void FBallLaunchCache_Data::ConvertLegacyStorage()
+{
+    if(Map.Num() == 0) return;
+
+    TArray<int> SpeedHashes, AngleHashes, FrontSpinHashes, SideSpinHashes;
+    for (const auto& Item : Map)
+    {
+        SpeedHashes.AddUnique(Item.Key.LaunchSpeedHash);
+        AngleHashes.AddUnique(Item.Key.LaunchAngleHash);
+        FrontSpinHashes.AddUnique(Item.Key.FrontSpinAngleHash);
+        SideSpinHashes.AddUnique(Item.Key.SideSpinAngleHash);
+    }
+    SpeedHashes.Sort();
+    AngleHashes.Sort();
+    FrontSpinHashes.Sort();
+    SideSpinHashes.Sort();
+
+    LaunchSpeedHashes = SpeedHashes;
+    LaunchAngleHashes = AngleHashes;
+    FrontSpinAngleHashes = FrontSpinHashes;
+    SideSpinAngleHashes = SideSpinHashes;
+    InitGrid();
+
+    for (const auto& Item : Map)
+    {
+        AddDistanceValue(Item.Key, Item.Value);
+        if(const auto Distribution = VerticalDistribution.Find(Item.Key))
+        {
+            AddVerticalDistribution(Item.Key, *Distribution);
+        }
+    }
+    
+    Map.Empty();
+    VerticalDistribution.Empty();
+}
+
+FBallLaunchCache_Data FBallLaunchCache_Data::MakeShard(int FirstCellIndex, int NumCells) const
+{
+    check(FirstCellIndex >= 0 && FirstCellIndex + NumCells <= GetNumGridCells())
+    
+    FBallLaunchCache_Data Shard;
+    Shard.LaunchSpeedHV = LaunchSpeedHV;
+    Shard.LaunchAngleHV = LaunchAngleHV;
+    Shard.FrontSpinAngleHV = FrontSpinAngleHV;
+    Shard.SideSpinAngleHV = SideSpinAngleHV;
+    Shard.VerticalLevelWidth = VerticalLevelWidth;
+    Shard.LaunchSpeedHashes = LaunchSpeedHashes;
+    Shard.LaunchAngleHashes = LaunchAngleHashes;
+    Shard.FrontSpinAngleHashes = FrontSpinAngleHashes;
+    Shard.SideSpinAngleHashes = SideSpinAngleHashes;
+    Shard.MaxDistanceGrid.Init(-1.0f, NumCells);
+    Shard.VerticalRangeStart.Init(0, NumCells);
+    Shard.VerticalRangeNum.Init(0, NumCells);
+    Shard.GridCellOffset = FirstCellIndex;
+    return Shard;
+}
+
+void FBallLaunchCache_Data::AppendShard(const FBallLaunchCache_Data& Shard)
+{
+    // shards are appended in partition order, so packed ranges keep order of serial computation
+    const int RangeOffset = VerticalRanges.Num();
+    
+    for (int i = 0; i < Shard.MaxDistanceGrid.Num(); ++i)
+    {
+        if(Shard.MaxDistanceGrid[i] < 0.0f) continue;
+        
+        const int Cell = GetLocalCellIndex(Shard.GridCellOffset + i);
+        check(Cell != INDEX_NONE)
+        check(MaxDistanceGrid[Cell] < 0.0f)
+        MaxDistanceGrid[Cell] = Shard.MaxDistanceGrid[i];
+        VerticalRangeStart[Cell] = Shard.VerticalRangeStart[i] + RangeOffset;
+        VerticalRangeNum[Cell] = Shard.VerticalRangeNum[i];
+    }
+    VerticalRanges.Append(Shard.VerticalRanges);
+    NumItems += Shard.NumItems;
+}
+
+int FBallLaunchCache_Data::GetGridCellIndex(const FBallLaunchParamsHashed& Hash) const
+{
+    const int SpeedIndex = GetAxisIndex(LaunchSpeedHashes, Hash.LaunchSpeedHash);
+    const int AngleIndex = GetAxisIndex(LaunchAngleHashes, Hash.LaunchAngleHash);
+    const int FrontSpinIndex = GetAxisIndex(FrontSpinAngleHashes, Hash.FrontSpinAngleHash);
+    const int SideSpinIndex = GetAxisIndex(SideSpinAngleHashes, Hash.SideSpinAngleHash);
+
+    const bool B1 = SpeedIndex != INDEX_NONE && AngleIndex != INDEX_NONE;
+    const bool B2 = FrontSpinIndex != INDEX_NONE && SideSpinIndex != INDEX_NONE;
+    if(!B1 || !B2) return INDEX_NONE;
+    
+    int Index = SpeedIndex;
+    Index = Index * LaunchAngleHashes.Num() + AngleIndex;
+    Index = Index * FrontSpinAngleHashes.Num() + FrontSpinIndex;
+    Index = Index * SideSpinAngleHashes.Num() + SideSpinIndex;
+    return Index;
+}
+
+int FBallLaunchCache_Data::FindComputedCell(const FBallLaunchParamsHashed& Hash) const
+{
+    const int Cell = GetLocalCellIndex(GetGridCellIndex(Hash));
+    if(Cell == INDEX_NONE || MaxDistanceGrid[Cell] < 0.0f) return INDEX_NONE;
+    return Cell;
+}
+
+const float* FBallLaunchCache_Data::FindDistance(const FBallLaunchParamsHashed& Hash) const
+{
+    const int Cell = FindComputedCell(Hash);
+    return Cell != INDEX_NONE ? &MaxDistanceGrid[Cell] : nullptr;
+}
+
+bool FBallLaunchCache_Data::FindVerticalDistribution(const FBallLaunchParamsHashed& Hash, FBallLaunchVerticalDistribution& Out) const
+{
+    const int Cell = FindComputedCell(Hash);
+    if(Cell == INDEX_NONE) return false;
+    
+    Out = FBallLaunchVerticalDistribution::FromPacked(VerticalRanges.GetData() + VerticalRangeStart[Cell], VerticalRangeNum[Cell]);
+    return true;
+}
+
+bool FBallLaunchCache_Data::CanCellReachTarget(int Cell, uint8 LevelIndex, float DistanceXY, float MulDistanceXY) const
+{
+    const int First = VerticalRangeStart[Cell];
+    const int Last = First + VerticalRangeNum[Cell];
+    for (int i = First; i < Last; ++i)
+    {
+        const auto& Range = VerticalRanges[i];
+        if(Range.LevelIndex == LevelIndex && Range.IsValueInRange(DistanceXY, MulDistanceXY)) return true;
+    }
+    return false;
+}
+
+bool FBallLaunchCache_Data::CanSlabReachTarget(const FBallLaunchParamsHashed& Hash, int NumFixedAxes, uint8 LevelIndex, float DistanceXY, float MulDistanceXY) const
+{
+    int FirstCell, NumCells;
+    if(!GetSlabCells(Hash, NumFixedAxes, FirstCell, NumCells)) return false;
+    
+    for (int Cell = FirstCell; Cell < FirstCell + NumCells; ++Cell)
+    {
+        if(MaxDistanceGrid[Cell] >= 0.0f && CanCellReachTarget(Cell, LevelIndex, DistanceXY, MulDistanceXY)) return true;
+    }
+    return false;
+}
+
+TMap<FBallLaunchParamsHashed, float> FBallLaunchCache_Data::MakeDistanceMap() const
+{
+    TMap<FBallLaunchParamsHashed, float> Out;
+    Out.Reserve(NumItems);
+
+    int Cell = 0;
+    for (const int Speed : LaunchSpeedHashes)
+    {
+        for (const int Angle : LaunchAngleHashes)
+        {
+            for (const int FrontSpin : FrontSpinAngleHashes)
+            {
+                for (const int SideSpin : SideSpinAngleHashes)
+                {
+                    const int LocalCell = GetLocalCellIndex(Cell++);
+                    if(LocalCell == INDEX_NONE || MaxDistanceGrid[LocalCell] < 0.0f) continue;
+                    Out.Add(FBallLaunchParamsHashed(Speed, Angle, FrontSpin, SideSpin), MaxDistanceGrid[LocalCell]);
+                }
+            }
+        }
+    }
+    return Out;
+}
+
+bool FBallLaunchCache_Data::AddVerticalDistribution(const FBallLaunchParams& Input, const FBallLaunchVerticalDistribution& S)
+{
+    return AddVerticalDistribution(HashRealValuesToClosest(Input), S);
+}
+
+bool FBallLaunchCache_Data::AddVerticalDistribution(const FBallLaunchParamsHashed& Hash, const FBallLaunchVerticalDistribution& S)
+{
+    const int Cell = GetLocalCellIndex(GetGridCellIndex(Hash));
+    check(Cell != INDEX_NONE)
+    check(VerticalRangeNum[Cell] == 0)
+    
+    const int Start = VerticalRanges.Num();
+    S.AppendPacked(VerticalRanges);
+    const int Num = VerticalRanges.Num() - Start;
+    if(Num > MaxRangesPerCell)
+    {
+        VerticalRanges.SetNum(Start);
+        PrintToLog("Ball launch cache: vertical distribution has " + FString::FromInt(Num) + " ranges, limit is " + FString::FromInt(MaxRangesPerCell));
+        return false;
+    }
+    
+    VerticalRangeStart[Cell] = Start;
+    VerticalRangeNum[Cell] = static_cast<uint8>(Num);
+    return true;
 }
 
 void FBallLaunchCache_Data::AddDistanceValue(const FBallLaunchParams& Input, float Distance)
 {
-    const auto Hash = HashRealValuesToClosest(Input);
-    check(!Map.Contains(Hash))
-    Map.Add(Hash, Distance);
+    AddDistanceValue(HashRealValuesToClosest(Input), Distance);
+}
+
+void FBallLaunchCache_Data::AddDistanceValue(const FBallLaunchParamsHashed& Hash, float Distance)
+{
+    const int Cell = GetLocalCellIndex(GetGridCellIndex(Hash));
+    check(Cell != INDEX_NONE)
+    check(MaxDistanceGrid[Cell] < 0.0f)
+    check(Distance >= 0.0f)
+    MaxDistanceGrid[Cell] = Distance;
+    NumItems++;
 }
 
 TArray<float> FBallLaunchCache_Data::SelectDistancesFromHashArray(const TArray<FBallLaunchParamsHashed>& Data)
@@ -53,7 +261,7 @@ TArray<float> FBallLaunchCache_Data::SelectDistancesFromHashArray(const TArray<F
 
     for (auto Hash : Data)
     {
-        const auto Item = Map.Find(Hash);
+        const auto Item = FindDistance(Hash);
         check(Item)
         OutData.Add(*Item);
     }
@@ -77,6 +285,12 @@ FBallLaunchParamsHashSelection FBallLaunchCache_Data::SelectHashedLaunchParams(c
 }
 
 FBallLaunchParamsHashSelectionSimple FBallLaunchCache_Data::SelectHashedLaunchParamsWithLaunchSpeedRequiredDistanceCheck(const FBallLaunchParams& Input, float MinDistance)
+{
+    return SelectHashedLaunchParamsWithLaunchSpeedRequiredDistanceCheck(Input, MinDistance, [this](int) -> const FBallLaunchCache_Data& {return *this;});
+}
+
+FBallLaunchParamsHashSelectionSimple FBallLaunchCache_Data::SelectHashedLaunchParamsWithLaunchSpeedRequiredDistanceCheck(const FBallLaunchParams& Input, float MinDistance,
+    TFunctionRef<const FBallLaunchCache_Data&(int LaunchSpeedHash)> GetSpeedData) const
 {
     TArray<int> LaunchSpeedHashes = LaunchSpeedHV.GetHashesAfterValue(Input.LaunchSpeed);
     const auto LaunchAngleKeys = LaunchAngleHV.GetHashValues(Input.LaunchAngle);
@@ -87,10 +301,11 @@ FBallLaunchParamsHashSelectionSimple FBallLaunchCache_Data::SelectHashedLaunchPa
 
     for (const int LaunchSpeed : LaunchSpeedHashes)
     {
+        const auto& SpeedData = GetSpeedData(LaunchSpeed);
         auto HashArray = SelectHashedLaunchParams(LaunchSpeed, LaunchAngleKeys, FrontSpinKeys, SideSpinKeys);
         for (auto Hash : HashArray)
         {
-            const auto DistancePtr = Map.Find(Hash);
+            const auto DistancePtr = SpeedData.FindDistance(Hash);
             check(DistancePtr)
             const float Distance = *DistancePtr;
             if(Distance >= MinDistance)
@@ -124,7 +339,7 @@ FBallLaunchParams FBallLaunchCache_Data::GetLaunchParamsFromHash(const FBallLaun
 {
     // if this hash is not in the map -> we can make fake data; but make exception now
     
-    check(Map.Contains(Hash))
+    check(FindDistance(Hash))
     FBallLaunchParams OutData;
 
     OutData.LaunchSpeed = LaunchSpeedHV.GetSearchValueFromHash(Hash.LaunchSpeedHash);
@@ -187,10 +402,133 @@ bool FBallLaunchCache_Data::IsLaunchParamsPureHashed(const FBallLaunchParams& In
     return Input.Equals(Restored);
 }
 
+int FBallLaunchCache_Data::GetAxisIndex(const TArray<int>& AxisHashes, int Hash)
+{
+    const int Num = AxisHashes.Num();
+    if(Num == 0) return INDEX_NONE;
+
+    // hashes of regular grid are consecutive, so index is just an offset
+    const int Offset = Hash - AxisHashes[0];
+    if(Offset >= 0 && Offset < Num && AxisHashes[Offset] == Hash) return Offset;
+    
+    return AxisHashes.IndexOfByKey(Hash);
+}
+
+TArray<int> FBallLaunchCache_Data::MakeAxisHashes(const FHashVector& HV, const TArray<float>& Values)
+{
+    TArray<int> Out;
+    for (const float Value : Values)
+    {
+        const int Hash = HV.GetClosestHashValue(Value);
+        check(!Out.Contains(Hash))
+        Out.Add(Hash);
+    }
+    return Out;
+}
+
+int FBallLaunchCache_Data::GetLocalCellIndex(int CellIndex) const
+{
+    if(CellIndex == INDEX_NONE) return INDEX_NONE;
+    const int Local = CellIndex - GridCellOffset;
+    return MaxDistanceGrid.IsValidIndex(Local) ? Local : INDEX_NONE;
+}
+
+bool FBallLaunchCache_Data::GetSlabCells(const FBallLaunchParamsHashed& Hash, int NumFixedAxes, int& OutFirstCell, int& OutNumCells) const
+{
+    check(NumFixedAxes >= 1 && NumFixedAxes <= 4)
+    
+    const TArray<int>* Axes[] = {&LaunchSpeedHashes, &LaunchAngleHashes, &FrontSpinAngleHashes, &SideSpinAngleHashes};
+    const int Hashes[] = {Hash.LaunchSpeedHash, Hash.LaunchAngleHash, Hash.FrontSpinAngleHash, Hash.SideSpinAngleHash};
+    
+    int First = 0;
+    int Num = 1;
+    for (int i = 0; i < 4; ++i)
+    {
+        int Index = 0;
+        if(i < NumFixedAxes)
+        {
+            Index = GetAxisIndex(*Axes[i], Hashes[i]);
+            if(Index == INDEX_NONE) return false;
+        }
+        else
+        {
+            Num *= Axes[i]->Num();
+        }
+        First = First * Axes[i]->Num() + Index;
+    }
+    
+    OutFirstCell = GetLocalCellIndex(First);
+    OutNumCells = Num;
+    return OutFirstCell != INDEX_NONE && MaxDistanceGrid.IsValidIndex(OutFirstCell + Num - 1);
+}
+
+bool UBallLaunchCache::OpenChunkedFile(const FString& Path, int64 MemoryBudget)
+{
+    const auto NewResidency = MakeShared<FBallLaunchCacheResidency>();
+    if(!NewResidency->Open(Path, MemoryBudget)) return false;
+    
+    Residency = NewResidency;
+    QueryChunk.Reset();
+    DistanceMap.Empty();
+    DistanceMapNumItems = INDEX_NONE;
+    Data = Residency->GetGrid();
+    return true;
+}
+
+void UBallLaunchCache::PrefetchLaunchSpeedRange(float MinLaunchSpeed, float MaxLaunchSpeed)
+{
+    if(!IsChunked()) return;
+    
+    const int FirstSpeedIndex = Data.GetLaunchSpeedIndex(Data.LaunchSpeedHV.GetClosestHashValue(MinLaunchSpeed));
+    const int LastSpeedIndex = Data.GetLaunchSpeedIndex(Data.LaunchSpeedHV.GetClosestHashValue(MaxLaunchSpeed));
+    if(FirstSpeedIndex == INDEX_NONE || LastSpeedIndex == INDEX_NONE) return;
+    
+    Residency->Prefetch(FirstSpeedIndex, LastSpeedIndex);
+}
+
+FBallLaunchCacheResidencyStats UBallLaunchCache::GetResidencyStats() const
+{
+    return IsChunked() ? Residency->GetStats() : FBallLaunchCacheResidencyStats();
+}
+
+const FBallLaunchCache_Data& UBallLaunchCache::GetSpeedData(int LaunchSpeedHash)
+{
+    if(!IsChunked()) return Data;
+
+    // Data has no cells, so unreadable chunk behaves as not computed one
+    QueryChunk = Residency->GetChunk(Residency->GetChunkIndexForSpeed(LaunchSpeedHash));
+    return QueryChunk.IsValid() ? *QueryChunk : Data;
+}
+
+TMap<FBallLaunchParamsHashed, float> UBallLaunchCache::GetMap()
+{
+    if(DistanceMapNumItems == Data.NumItems) return DistanceMap;
+    
+    if(!IsChunked())
+    {
+        DistanceMap = Data.MakeDistanceMap();
+        DistanceMapNumItems = Data.NumItems;
+        return DistanceMap;
+    }
+
+    TMap<FBallLaunchParamsHashed, float> Out;
+    Out.Reserve(Data.NumItems);
+    for (int i = 0; i < Residency->GetNumChunks(); ++i)
+    {
+        if(const auto Chunk = Residency->GetChunk(i)) Out.Append(Chunk->MakeDistanceMap());
+    }
+    // map without unreadable chunks is not cached, so they are retried next time
+    if(Out.Num() != Data.NumItems) return Out;
+    
+    DistanceMap = MoveTemp(Out);
+    DistanceMapNumItems = Data.NumItems;
+    return DistanceMap;
+}
+
 float UBallLaunchCache::GetDistanceFromInput(FBallLaunchParams Input)
 {
     const auto Hash = Data.HashRealValuesToClosest(Input);
-    const auto Item = Data.Map.Find(Hash);
+    const auto Item = GetSpeedData(Hash.LaunchSpeedHash).FindDistance(Hash);
     check(Item)
     return *Item;
 }
@@ -198,32 +536,57 @@ float UBallLaunchCache::GetDistanceFromInput(FBallLaunchParams Input)
 bool UBallLaunchCache::CanInputReachTarget(FBallLaunchParams Input, float DistanceXY, float DistanceZ, float AbsDerivationZ, float MulDistanceXY)
 {
     const auto Hash = Data.HashRealValuesToClosest(Input);
-    if(const auto Item = Data.VerticalDistribution.Find(Hash))
+    const auto& CellData = GetSpeedData(Hash.LaunchSpeedHash);
+    const int Cell = CellData.FindComputedCell(Hash);
+    if(Cell != INDEX_NONE)
     {
-        AbsDerivationZ = FMath::Abs(AbsDerivationZ);
         if(MulDistanceXY <= 0.0f) MulDistanceXY = 1.0f;
-        const auto PreciseLevelIndex = Data.GetVerticalLevelIndex(DistanceZ);
-        const auto MinLevelIndex = Data.GetVerticalLevelIndex(DistanceZ - AbsDerivationZ);
-        const auto MaxLevelIndex = Data.GetVerticalLevelIndex(DistanceZ + AbsDerivationZ);
-        
-        if(Item->CanReachTarget(PreciseLevelIndex, DistanceXY, MulDistanceXY)) return true;
-        if(Item->CanReachTarget(MinLevelIndex, DistanceXY, MulDistanceXY)) return true;
-        if(Item->CanReachTarget(MaxLevelIndex, DistanceXY, MulDistanceXY)) return true;
+        uint8 Levels[3];
+        GetTargetLevelIndices(DistanceZ, AbsDerivationZ, Levels);
+        for (const uint8 LevelIndex : Levels)
+        {
+            if(CellData.CanCellReachTarget(Cell, LevelIndex, DistanceXY, MulDistanceXY)) return true;
+        }
     }
     return false;
 }
 
-bool UBallLaunchCache::IsLaunchParamsPureHashed(const FBallLaunchParams& Input) const
+bool UBallLaunchCache::CanSlabReachTarget(const FBallLaunchParams& Input, int NumFixedAxes, float DistanceXY, float DistanceZ, float AbsDerivationZ, float MulDistanceXY)
+{
+    const auto Hash = Data.HashRealValuesToClosest(Input);
+    const auto& SlabData = GetSpeedData(Hash.LaunchSpeedHash);
+    
+    if(MulDistanceXY <= 0.0f) MulDistanceXY = 1.0f;
+    uint8 Levels[3];
+    GetTargetLevelIndices(DistanceZ, AbsDerivationZ, Levels);
+    for (const uint8 LevelIndex : Levels)
+    {
+        if(SlabData.CanSlabReachTarget(Hash, NumFixedAxes, LevelIndex, DistanceXY, MulDistanceXY)) return true;
+    }
+    return false;
+}
+
+void UBallLaunchCache::GetTargetLevelIndices(float DistanceZ, float AbsDerivationZ, uint8 (&OutLevels)[3]) const
+{
+    AbsDerivationZ = FMath::Abs(AbsDerivationZ);
+    OutLevels[0] = Data.GetVerticalLevelIndex(DistanceZ);
+    OutLevels[1] = Data.GetVerticalLevelIndex(DistanceZ - AbsDerivationZ);
+    OutLevels[2] = Data.GetVerticalLevelIndex(DistanceZ + AbsDerivationZ);
+}
+
+bool UBallLaunchCache::IsLaunchParamsPureHashed(const FBallLaunchParams& Input)
 {
-    return Data.IsLaunchParamsPureHashed(Input);
+    const auto Hash = Data.HashRealValuesToClosest(Input, false);
+    return GetSpeedData(Hash.LaunchSpeedHash).IsLaunchParamsPureHashed(Input);
 }
 
 bool UBallLaunchCache::GetVDistributionForLaunchParams(const FBallLaunchParams& Input, TMap<int, FVerticalDistributionDistanceItem>& Out)
 {
     const auto Hash = Data.HashRealValuesToClosest(Input);
-    if(const auto Ptr = Data.VerticalDistribution.Find(Hash))
+    FBallLaunchVerticalDistribution Distribution;
+    if(GetSpeedData(Hash.LaunchSpeedHash).FindVerticalDistribution(Hash, Distribution))
     {
-        Out = Ptr->GetMapIntKey();
+        Out = Distribution.GetMapIntKey();
         return true;
     }
     return false;
@@ -236,14 +599,15 @@ bool UBallLaunchCache::ComputeLaunchParamsLaunchSpeedAdjust(FBallLaunchParams In
     const float SideSpinSigned = InitialParams.SideSpinAngle;
     InitialParams.MakeAbsSideSpin();
 
-    const auto Selection = Data.SelectHashedLaunchParamsWithLaunchSpeedRequiredDistanceCheck(InitialParams, SafeDistance);
+    const auto Selection = Data.SelectHashedLaunchParamsWithLaunchSpeedRequiredDistanceCheck(InitialParams, SafeDistance,
+        [this](int LaunchSpeedHash) -> const FBallLaunchCache_Data& {return GetSpeedData(LaunchSpeedHash);});
     const bool bFoundRequired = Selection.IsValid();
     if(bFoundRequired)
     {
         int Index;
         float ClosestDistance = UHMA::FloatArraySelectClosestValue(SafeDistance, Selection.Distances, Index);
         const auto Hash = Selection.HashArray[Index];
-        OutParams = Data.GetLaunchParamsFromHash(Hash);
+        OutParams = GetSpeedData(Hash.LaunchSpeedHash).GetLaunchParamsFromHash(Hash);
         OutParams.SetSideSpinSign(SideSpinSigned);
         return true;
     }
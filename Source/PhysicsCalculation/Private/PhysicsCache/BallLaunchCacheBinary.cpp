@@ -0,0 +1,418 @@
+﻿#include "PhysicsCache/BallLaunchCacheBinary.h"
+#include "DataAssets/SpinMovementParams_DataAsset.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+int64 FBallLaunchCacheChunkInfo::GetResidentSize() const
+{
+    constexpr int64 CellSize = sizeof(float) + sizeof(int) + sizeof(uint8);
+    return NumCells * CellSize + NumRanges * static_cast<int64>(sizeof(FBallLaunchVerticalRange));
+}
+
+FArchive& operator<<(FArchive& Ar, FBallLaunchCacheChunkInfo& Info)
+{
+    Ar << Info.FirstCell << Info.NumCells << Info.NumRanges << Info.NumItems << Info.Offset << Info.Crc;
+    return Ar;
+}
+
+int64 FBallLaunchCacheFileHeader::GetResidentSize() const
+{
+    int64 Size = 0;
+    for (const auto& Info : Chunks)
+    {
+        Size += Info.GetResidentSize();
+    }
+    return Size;
+}
+
+uint16 FBallLaunchCacheBinary::PackDistance(float Distance)
+{
+    if(Distance < 0.0f) return NoDistance;
+    const float Packed = FMath::RoundToFloat(Distance / DistanceQuantum);
+    return static_cast<uint16>(FMath::Clamp(Packed, 0.0f, static_cast<float>(NoDistance - 1)));
+}
+
+float FBallLaunchCacheBinary::UnpackDistance(uint16 Packed, float Quantum)
+{
+    return Packed == NoDistance ? -1.0f : Packed * Quantum;
+}
+
+void FBallLaunchCacheBinary::SerializeBlock(FArchive& Ar, void* Data, int64 NumBytes)
+{
+    if(NumBytes <= 0) return;
+    Ar.Serialize(Data, NumBytes);
+}
+
+void FBallLaunchCacheBinary::SaveAxis(FArchive& Ar, const TArray<float>& Values, const TArray<int>& Hashes)
+{
+    int32 Num = Values.Num();
+    Ar << Num;
+    for (float V : Values)
+    {
+        Ar << V;
+    }
+    for (int32 Hash : Hashes)
+    {
+        Ar << Hash;
+    }
+}
+
+bool FBallLaunchCacheBinary::LoadAxis(FArchive& Ar, TArray<float>& OutValues, TArray<int>& OutHashes)
+{
+    int32 Num = 0;
+    Ar << Num;
+    if(Ar.IsError() || Num <= 0 || Num > MaxAxisSize) return false;
+
+    OutValues.SetNumUninitialized(Num);
+    OutHashes.SetNumUninitialized(Num);
+    for (auto& V : OutValues)
+    {
+        Ar << V;
+    }
+    for (auto& Hash : OutHashes)
+    {
+        Ar << Hash;
+    }
+    return !Ar.IsError();
+}
+
+bool FBallLaunchCacheBinary::DoAxesMatch(const FBallLaunchCache_Data& Data, const TArray<float> (&Axes)[4])
+{
+    const FHashVector* AxisHV[] = {&Data.LaunchSpeedHV, &Data.LaunchAngleHV, &Data.FrontSpinAngleHV, &Data.SideSpinAngleHV};
+    const TArray<int>* AxisHashes[] = {&Data.LaunchSpeedHashes, &Data.LaunchAngleHashes, &Data.FrontSpinAngleHashes, &Data.SideSpinAngleHashes};
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto& Hashes = *AxisHashes[i];
+        if(Axes[i].Num() != Hashes.Num()) return false;
+        for (int j = 0; j < Hashes.Num(); ++j)
+        {
+            const float Value = Axes[i][j];
+            const float DataValue = AxisHV[i]->GetSearchValueFromHash(Hashes[j]);
+            if(!FMath::IsNearlyEqual(DataValue, Value, KINDA_SMALL_NUMBER * FMath::Max(1.0f, FMath::Abs(Value)))) return false;
+        }
+    }
+    return true;
+}
+
+bool FBallLaunchCacheBinary::LoadFailed(FBallLaunchCache_Data& OutData)
+{
+    OutData = FBallLaunchCache_Data();
+    return false;
+}
+
+bool FBallLaunchCacheBinary::LoadFailed(FBallLaunchCacheFileHeader& OutHeader)
+{
+    OutHeader = FBallLaunchCacheFileHeader();
+    return false;
+}
+
+void FBallLaunchCacheBinary::PackChunk(const FBallLaunchCache_Data& Data, FBallLaunchCacheChunkInfo& InOutInfo, TArray<uint8>& OutBytes)
+{
+    const int32 FirstCell = InOutInfo.FirstCell;
+    const int32 NumCells = InOutInfo.NumCells;
+
+    // ranges are written in cell order, so start indices can be restored on load
+    TArray<uint16> Distances;
+    Distances.SetNumUninitialized(NumCells);
+    TArray<uint8> RangeNum(Data.VerticalRangeNum.GetData() + FirstCell, NumCells);
+    TArray<uint8> Levels;
+    TArray<float> MinDistances;
+    TArray<float> MaxDistances;
+    int32 NumItems = 0;
+    
+    for (int i = 0; i < NumCells; ++i)
+    {
+        const int Cell = FirstCell + i;
+        Distances[i] = PackDistance(Data.MaxDistanceGrid[Cell]);
+        if(Data.MaxDistanceGrid[Cell] >= 0.0f) NumItems++;
+        
+        const int Start = Data.VerticalRangeStart[Cell];
+        for (int r = Start; r < Start + RangeNum[i]; ++r)
+        {
+            const auto& Range = Data.VerticalRanges[r];
+            Levels.Add(Range.LevelIndex);
+            MinDistances.Add(Range.MinDistanceXY);
+            MaxDistances.Add(Range.MaxDistanceXY);
+        }
+    }
+
+    OutBytes.Reset();
+    FMemoryWriter Writer(OutBytes);
+    SerializeBlock(Writer, Distances.GetData(), Distances.Num() * sizeof(uint16));
+    SerializeBlock(Writer, RangeNum.GetData(), RangeNum.Num());
+    SerializeBlock(Writer, Levels.GetData(), Levels.Num());
+    SerializeBlock(Writer, MinDistances.GetData(), MinDistances.Num() * sizeof(float));
+    SerializeBlock(Writer, MaxDistances.GetData(), MaxDistances.Num() * sizeof(float));
+
+    InOutInfo.NumRanges = Levels.Num();
+    InOutInfo.NumItems = NumItems;
+    InOutInfo.Crc = FCrc::MemCrc32(OutBytes.GetData(), OutBytes.Num());
+}
+
+bool FBallLaunchCacheBinary::UnpackChunk(const TArray<uint8>& Bytes, const FBallLaunchCacheChunkInfo& Info, float Quantum, FBallLaunchCache_Data& InOutShard)
+{
+    const int32 NumCells = Info.NumCells;
+    const int32 NumRanges = Info.NumRanges;
+    check(InOutShard.MaxDistanceGrid.Num() == NumCells)
+    
+    TArray<uint16> Distances;
+    TArray<uint8> Levels;
+    TArray<float> MinDistances;
+    TArray<float> MaxDistances;
+    Distances.SetNumUninitialized(NumCells);
+    Levels.SetNumUninitialized(NumRanges);
+    MinDistances.SetNumUninitialized(NumRanges);
+    MaxDistances.SetNumUninitialized(NumRanges);
+
+    FMemoryReader Reader(Bytes);
+    SerializeBlock(Reader, Distances.GetData(), Distances.Num() * sizeof(uint16));
+    SerializeBlock(Reader, InOutShard.VerticalRangeNum.GetData(), NumCells);
+    SerializeBlock(Reader, Levels.GetData(), Levels.Num());
+    SerializeBlock(Reader, MinDistances.GetData(), MinDistances.Num() * sizeof(float));
+    SerializeBlock(Reader, MaxDistances.GetData(), MaxDistances.Num() * sizeof(float));
+    if(Reader.IsError()) return false;
+
+    int32 RangeStart = 0;
+    for (int i = 0; i < NumCells; ++i)
+    {
+        InOutShard.MaxDistanceGrid[i] = UnpackDistance(Distances[i], Quantum);
+        InOutShard.VerticalRangeStart[i] = RangeStart;
+        RangeStart += InOutShard.VerticalRangeNum[i];
+    }
+    if(RangeStart != NumRanges) return false;
+
+    InOutShard.VerticalRanges.SetNum(NumRanges);
+    for (int i = 0; i < NumRanges; ++i)
+    {
+        auto& Range = InOutShard.VerticalRanges[i];
+        Range.LevelIndex = Levels[i];
+        Range.MinDistanceXY = MinDistances[i];
+        Range.MaxDistanceXY = MaxDistances[i];
+    }
+    InOutShard.NumItems = Info.NumItems;
+    return true;
+}
+
+bool FBallLaunchCacheBinary::Save(FArchive& Ar, const FBallLaunchCache_Data& Data, const FSpinMovementParams& Params, int32 SpeedsPerChunk)
+{
+    check(Ar.IsSaving())
+
+    // only complete grid can be saved: no shards and no legacy maps
+    const int32 NumCells = Data.GetNumGridCells();
+    const int32 NumSpeeds = Data.LaunchSpeedHashes.Num();
+    if(NumCells == 0 || Data.GridCellOffset != 0 || Data.MaxDistanceGrid.Num() != NumCells || Data.Map.Num() > 0) return false;
+
+    const TArray<float> Axes[] = {
+        Params.GetLaunchSpeedCmSec(),
+        Params.LaunchAngle.GetValueArrayFullRange(),
+        Params.FrontSpinAngle.GetValueArrayFullRange(),
+        Params.SideSpinAngle.GetValueArrayFullRange()};
+    const TArray<int>* AxisHashes[] = {&Data.LaunchSpeedHashes, &Data.LaunchAngleHashes, &Data.FrontSpinAngleHashes, &Data.SideSpinAngleHashes};
+    // values are written from params and hashes from data; they differ if params were changed after cache was computed
+    if(!DoAxesMatch(Data, Axes)) return false;
+
+    // chunks are packed first: table with their sizes and checksums precedes them
+    SpeedsPerChunk = FMath::Clamp(SpeedsPerChunk, 1, NumSpeeds);
+    const int32 CellsPerChunk = SpeedsPerChunk * (NumCells / NumSpeeds);
+    const int32 NumChunks = FMath::DivideAndRoundUp(NumSpeeds, SpeedsPerChunk);
+    TArray<FBallLaunchCacheChunkInfo> Chunks;
+    TArray<TArray<uint8>> ChunkBytes;
+    Chunks.SetNum(NumChunks);
+    ChunkBytes.SetNum(NumChunks);
+    
+    int64 Offset = 0;
+    for (int i = 0; i < NumChunks; ++i)
+    {
+        auto& Info = Chunks[i];
+        Info.FirstCell = i * CellsPerChunk;
+        Info.NumCells = FMath::Min(CellsPerChunk, NumCells - Info.FirstCell);
+        Info.Offset = Offset;
+        PackChunk(Data, Info, ChunkBytes[i]);
+        Offset += ChunkBytes[i].Num();
+    }
+
+    // header body is written to memory first to be covered by its own checksum
+    TArray<uint8> HeaderBytes;
+    FMemoryWriter HeaderWriter(HeaderBytes);
+    float LevelWidth = Data.VerticalLevelWidth;
+    float Quantum = DistanceQuantum;
+    int32 NumItems = Data.NumItems;
+    HeaderWriter << LevelWidth << Quantum << NumItems;
+    
+    for (int i = 0; i < 4; ++i)
+    {
+        SaveAxis(HeaderWriter, Axes[i], *AxisHashes[i]);
+    }
+
+    int32 FileNumCells = NumCells;
+    int32 FileNumChunks = NumChunks;
+    HeaderWriter << FileNumCells << SpeedsPerChunk << FileNumChunks;
+    for (auto& Info : Chunks)
+    {
+        HeaderWriter << Info;
+    }
+
+    uint32 FileMagic = Magic;
+    uint32 FileVersion = Version;
+    int32 HeaderSize = HeaderBytes.Num();
+    uint32 HeaderCrc = FCrc::MemCrc32(HeaderBytes.GetData(), HeaderBytes.Num());
+    Ar << FileMagic << FileVersion << HeaderSize;
+    SerializeBlock(Ar, HeaderBytes.GetData(), HeaderBytes.Num());
+    Ar << HeaderCrc;
+    for (auto& Bytes : ChunkBytes)
+    {
+        SerializeBlock(Ar, Bytes.GetData(), Bytes.Num());
+    }
+    
+    return !Ar.IsError();
+}
+
+bool FBallLaunchCacheBinary::LoadHeader(FArchive& Ar, FBallLaunchCacheFileHeader& OutHeader)
+{
+    check(Ar.IsLoading())
+    OutHeader = FBallLaunchCacheFileHeader();
+
+    uint32 FileMagic = 0;
+    uint32 FileVersion = 0;
+    int32 HeaderSize = 0;
+    Ar << FileMagic << FileVersion << HeaderSize;
+    if(Ar.IsError() || FileMagic != Magic || FileVersion != Version || HeaderSize <= 0 || HeaderSize > MaxHeaderSize) return false;
+
+    // body is parsed only after checksum matches
+    TArray<uint8> HeaderBytes;
+    HeaderBytes.SetNumUninitialized(HeaderSize);
+    SerializeBlock(Ar, HeaderBytes.GetData(), HeaderBytes.Num());
+    uint32 HeaderCrc = 0;
+    Ar << HeaderCrc;
+    if(Ar.IsError() || FCrc::MemCrc32(HeaderBytes.GetData(), HeaderBytes.Num()) != HeaderCrc) return false;
+
+    FMemoryReader HeaderReader(HeaderBytes);
+    if(!LoadHeaderBody(HeaderReader, OutHeader) || HeaderReader.Tell() != HeaderSize) return LoadFailed(OutHeader);
+    
+    OutHeader.PayloadStart = Ar.Tell();
+    return true;
+}
+
+bool FBallLaunchCacheBinary::LoadHeaderBody(FArchive& Ar, FBallLaunchCacheFileHeader& OutHeader)
+{
+    float LevelWidth = 0.0f;
+    float Quantum = 0.0f;
+    int32 NumItems = 0;
+    Ar << LevelWidth << Quantum << NumItems;
+    if(Ar.IsError() || LevelWidth <= 0.0f || Quantum <= 0.0f) return false;
+
+    TArray<float> Axes[4];
+    TArray<int> AxisHashes[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        if(!LoadAxis(Ar, Axes[i], AxisHashes[i])) return LoadFailed(OutHeader);
+    }
+
+    // hashes are rebuilt from values; stored ones only verify that hashing is unchanged
+    auto& Grid = OutHeader.Grid;
+    Grid.SetLaunchSpeedVector(Axes[0]);
+    Grid.SetLaunchAngleVector(Axes[1]);
+    Grid.SetFrontSpinAngleVector(Axes[2]);
+    Grid.SetSideSpinAngleVector(Axes[3]);
+    const bool bSameSpeed = Grid.LaunchSpeedHashes == AxisHashes[0] && Grid.LaunchAngleHashes == AxisHashes[1];
+    const bool bSameSpin = Grid.FrontSpinAngleHashes == AxisHashes[2] && Grid.SideSpinAngleHashes == AxisHashes[3];
+    if(!bSameSpeed || !bSameSpin) return LoadFailed(OutHeader);
+    
+    Grid.SetVerticalLevelWidth(LevelWidth);
+    Grid.NumItems = NumItems;
+
+    int32 NumCells = 0;
+    int32 SpeedsPerChunk = 0;
+    int32 NumChunks = 0;
+    Ar << NumCells << SpeedsPerChunk << NumChunks;
+    const int32 NumSpeeds = Grid.LaunchSpeedHashes.Num();
+    const bool bValidCells = NumCells == Grid.GetNumGridCells();
+    const bool bValidChunks = SpeedsPerChunk > 0 && SpeedsPerChunk <= NumSpeeds && NumChunks == FMath::DivideAndRoundUp(NumSpeeds, SpeedsPerChunk);
+    if(Ar.IsError() || !bValidCells || !bValidChunks) return LoadFailed(OutHeader);
+
+    // table must describe consecutive bands without gaps
+    const int32 CellsPerChunk = SpeedsPerChunk * (NumCells / NumSpeeds);
+    OutHeader.Chunks.SetNum(NumChunks);
+    int64 Offset = 0;
+    for (int i = 0; i < NumChunks; ++i)
+    {
+        auto& Info = OutHeader.Chunks[i];
+        Ar << Info;
+        const bool bValidCellRange = Info.FirstCell == i * CellsPerChunk && Info.NumCells == FMath::Min(CellsPerChunk, NumCells - Info.FirstCell);
+        const bool bValidRanges = Info.NumRanges >= 0 && Info.NumRanges <= static_cast<int64>(Info.NumCells) * MAX_uint8;
+        if(Ar.IsError() || !bValidCellRange || !bValidRanges || Info.Offset != Offset) return LoadFailed(OutHeader);
+        Offset += Info.GetNumBytes();
+    }
+
+    OutHeader.Quantum = Quantum;
+    OutHeader.SpeedsPerChunk = SpeedsPerChunk;
+    return true;
+}
+
+bool FBallLaunchCacheBinary::LoadChunk(FArchive& Ar, const FBallLaunchCacheFileHeader& Header, int32 ChunkIndex, FBallLaunchCache_Data& OutShard)
+{
+    check(Ar.IsLoading())
+    if(!Header.Chunks.IsValidIndex(ChunkIndex)) return false;
+
+    const auto& Info = Header.Chunks[ChunkIndex];
+    TArray<uint8> Bytes;
+    Bytes.SetNumUninitialized(Info.GetNumBytes());
+    Ar.Seek(Header.PayloadStart + Info.Offset);
+    SerializeBlock(Ar, Bytes.GetData(), Bytes.Num());
+    if(Ar.IsError() || FCrc::MemCrc32(Bytes.GetData(), Bytes.Num()) != Info.Crc) return false;
+
+    OutShard = Header.Grid.MakeShard(Info.FirstCell, Info.NumCells);
+    return UnpackChunk(Bytes, Info, Header.Quantum, OutShard);
+}
+
+bool FBallLaunchCacheBinary::Load(FArchive& Ar, FBallLaunchCache_Data& OutData)
+{
+    FBallLaunchCacheFileHeader Header;
+    if(!LoadHeader(Ar, Header)) return LoadFailed(OutData);
+
+    // chunks are stored in cell order, so appending them restores complete grid
+    OutData = Header.Grid;
+    OutData.InitGrid();
+    for (int i = 0; i < Header.Chunks.Num(); ++i)
+    {
+        FBallLaunchCache_Data Shard;
+        if(!LoadChunk(Ar, Header, i, Shard)) return LoadFailed(OutData);
+        OutData.AppendShard(Shard);
+    }
+    return true;
+}
+
+bool FBallLaunchCacheBinary::SaveToFile(const FString& Path, const FBallLaunchCache_Data& Data, const FSpinMovementParams& Params, int32 SpeedsPerChunk)
+{
+    // file writer truncates target on open; previous cache is replaced only after complete file is written
+    const FString TempPath = Path + TEXT(".tmp");
+    auto& FileManager = IFileManager::Get();
+    TUniquePtr<FArchive> Writer(FileManager.CreateFileWriter(*TempPath));
+    if(!Writer) return false;
+    
+    bool bSaved = Save(*Writer, Data, Params, SpeedsPerChunk);
+    bSaved = Writer->Close() && bSaved;
+    Writer.Reset();
+    
+    if(bSaved) bSaved = FileManager.Move(*Path, *TempPath, true);
+    if(!bSaved) FileManager.Delete(*TempPath);
+    return bSaved;
+}
+
+bool FBallLaunchCacheBinary::LoadFromFile(const FString& Path, FBallLaunchCache_Data& OutData)
+{
+    // file is streamed chunk by chunk; only one packed chunk is held in temporary buffer
+    const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Path));
+    if(!Reader) return false;
+    
+    return Load(*Reader, OutData);
+}
+
+bool FBallLaunchCacheBinary::LoadHeaderFromFile(const FString& Path, FBallLaunchCacheFileHeader& OutHeader)
+{
+    const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Path));
+    if(!Reader) return false;
+    
+    return LoadHeader(*Reader, OutHeader);
+}
@@ -0,0 +1,26 @@
+﻿#include "PhysicsCache/BallLaunchCacheBuildJob.h"
+#include "Libs/SpinMovementLib.h"
+
+void FBallLaunchCacheBuildJob::Init(UAdvancedPhysicsComponent* InTarget, FBallLaunchCacheBuildProgress* InProgress)
+{
+    Target = InTarget;
+    Progress = InProgress;
+    Data = USpinMovementLib::MakeBallLaunchCacheGrid(Target);
+    Cells = USpinMovementLib::MakeBallLaunchCacheCells(Target);
+    Body = USpinMovementLib::MakeBallLaunchCacheBody(Target);
+    Progress->Reset(Cells.Num());
+}
+
+void FBallLaunchCacheBuildJob::Run()
+{
+    USpinMovementLib::ComputeBallLaunchCacheCells(Target, Body, Cells, Data, *Progress);
+    bCompleted = true;
+}
+
+void FBallLaunchCacheBuildJob::Wait() const
+{
+    while (!IsCompleted())
+    {
+        FPlatformProcess::Sleep(0.001f);
+    }
+}
@@ -0,0 +1,181 @@
+﻿#include "PhysicsCache/BallLaunchCacheResidency.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+
+void FBallLaunchCacheChunkLoadJob::Run()
+{
+    const TUniquePtr<FArchive> JobReader(IFileManager::Get().CreateFileReader(*Path));
+    bSucceeded = JobReader && FBallLaunchCacheBinary::LoadChunk(*JobReader, *Header, ChunkIndex, Result);
+    bCompleted = true;
+}
+
+bool FBallLaunchCacheResidency::Open(const FString& InPath, int64 InMemoryBudget)
+{
+    Close();
+
+    const auto NewHeader = MakeShared<FBallLaunchCacheFileHeader, ESPMode::ThreadSafe>();
+    Reader.Reset(IFileManager::Get().CreateFileReader(*InPath));
+    if(!Reader || !FBallLaunchCacheBinary::LoadHeader(*Reader, *NewHeader))
+    {
+        Reader.Reset();
+        return false;
+    }
+
+    Path = InPath;
+    Header = NewHeader;
+    MemoryBudget = FMath::Max<int64>(InMemoryBudget, 0);
+    TotalBytes = NewHeader->GetResidentSize();
+    Slots.SetNum(NewHeader->Chunks.Num());
+    Stats.NumChunks = Slots.Num();
+    return true;
+}
+
+void FBallLaunchCacheResidency::Close()
+{
+    // running jobs hold their own header reference; their results are dropped
+    Slots.Empty();
+    Header.Reset();
+    Reader.Reset();
+    Path.Empty();
+    ResidentBytes = 0;
+    TotalBytes = 0;
+    UseCounter = 0;
+    NumPendingJobs = 0;
+    Stats = FBallLaunchCacheResidencyStats();
+}
+
+void FBallLaunchCacheResidency::SetMemoryBudget(int64 Bytes)
+{
+    MemoryBudget = FMath::Max<int64>(Bytes, 0);
+    TrimToBudget(INDEX_NONE);
+}
+
+int FBallLaunchCacheResidency::GetChunkIndexForSpeed(int LaunchSpeedHash) const
+{
+    if(!IsOpen()) return INDEX_NONE;
+    const int SpeedIndex = Header->Grid.GetLaunchSpeedIndex(LaunchSpeedHash);
+    return SpeedIndex != INDEX_NONE ? Header->GetChunkIndex(SpeedIndex) : INDEX_NONE;
+}
+
+TSharedPtr<const FBallLaunchCache_Data> FBallLaunchCacheResidency::GetChunk(int ChunkIndex)
+{
+    if(!IsOpen() || !Slots.IsValidIndex(ChunkIndex)) return nullptr;
+    CollectPrefetched();
+
+    auto& Slot = Slots[ChunkIndex];
+    Slot.LastUse = ++UseCounter;
+    if(Slot.Data.IsValid())
+    {
+        Stats.NumHits++;
+        return Slot.Data;
+    }
+
+    // reading here costs the same as waiting for unfinished prefetch and doesn't depend on thread pool load
+    if(Slot.PrefetchJob.IsValid())
+    {
+        Slot.PrefetchJob.Reset();
+        NumPendingJobs--;
+    }
+    
+    FBallLaunchCache_Data Shard;
+    if(!FBallLaunchCacheBinary::LoadChunk(*Reader, *Header, ChunkIndex, Shard)) return nullptr;
+    
+    Stats.NumMisses++;
+    MakeResident(ChunkIndex, MoveTemp(Shard));
+    return Slot.Data;
+}
+
+void FBallLaunchCacheResidency::Prefetch(int FirstSpeedIndex, int LastSpeedIndex)
+{
+    if(!IsOpen()) return;
+    CollectPrefetched();
+
+    const int LastIndex = Header->Grid.LaunchSpeedHashes.Num() - 1;
+    const int FirstChunk = Header->GetChunkIndex(FMath::Clamp(FirstSpeedIndex, 0, LastIndex));
+    const int LastChunk = Header->GetChunkIndex(FMath::Clamp(LastSpeedIndex, 0, LastIndex));
+
+    int64 RequestedBytes = 0;
+    for (int i = FirstChunk; i <= LastChunk; ++i)
+    {
+        // chunks beyond budget would evict ones requested earlier in the same band
+        RequestedBytes += GetChunkSize(i);
+        if(MemoryBudget > 0 && RequestedBytes > MemoryBudget) return;
+
+        auto& Slot = Slots[i];
+        Slot.LastUse = ++UseCounter;
+        if(Slot.Data.IsValid() || Slot.PrefetchJob.IsValid()) continue;
+
+        const auto Job = MakeShared<FBallLaunchCacheChunkLoadJob, ESPMode::ThreadSafe>();
+        Job->Header = Header;
+        Job->Path = Path;
+        Job->ChunkIndex = i;
+        Slot.PrefetchJob = Job;
+        NumPendingJobs++;
+        Async(EAsyncExecution::ThreadPool, [Job]()
+        {
+            Job->Run();
+        });
+    }
+}
+
+FBallLaunchCacheResidencyStats FBallLaunchCacheResidency::GetStats() const
+{
+    constexpr float BytesInMB = 1024.0f * 1024.0f;
+    FBallLaunchCacheResidencyStats Out = Stats;
+    Out.ResidentMB = ResidentBytes / BytesInMB;
+    Out.TotalMB = TotalBytes / BytesInMB;
+    return Out;
+}
+
+void FBallLaunchCacheResidency::CollectPrefetched()
+{
+    if(NumPendingJobs == 0) return;
+
+    for (int i = 0; i < Slots.Num(); ++i)
+    {
+        auto& Slot = Slots[i];
+        if(!Slot.PrefetchJob.IsValid() || !Slot.PrefetchJob->IsCompleted()) continue;
+
+        const auto Job = Slot.PrefetchJob;
+        Slot.PrefetchJob.Reset();
+        NumPendingJobs--;
+        if(Job->bSucceeded && !Slot.Data.IsValid())
+        {
+            Stats.NumPrefetched++;
+            MakeResident(i, MoveTemp(Job->Result));
+        }
+    }
+}
+
+void FBallLaunchCacheResidency::MakeResident(int ChunkIndex, FBallLaunchCache_Data&& Data)
+{
+    Slots[ChunkIndex].Data = MakeShared<FBallLaunchCache_Data>(MoveTemp(Data));
+    ResidentBytes += GetChunkSize(ChunkIndex);
+    Stats.NumResidentChunks++;
+    TrimToBudget(ChunkIndex);
+}
+
+void FBallLaunchCacheResidency::TrimToBudget(int KeepChunkIndex)
+{
+    while (MemoryBudget > 0 && ResidentBytes > MemoryBudget)
+    {
+        int Oldest = INDEX_NONE;
+        for (int i = 0; i < Slots.Num(); ++i)
+        {
+            if(i == KeepChunkIndex || !Slots[i].Data.IsValid()) continue;
+            if(Oldest == INDEX_NONE || Slots[i].LastUse < Slots[Oldest].LastUse) Oldest = i;
+        }
+        // chunk larger than budget stays resident alone
+        if(Oldest == INDEX_NONE) return;
+        Evict(Oldest);
+    }
+}
+
+void FBallLaunchCacheResidency::Evict(int ChunkIndex)
+{
+    // queries that still hold the chunk keep it alive until they finish
+    Slots[ChunkIndex].Data.Reset();
+    ResidentBytes -= GetChunkSize(ChunkIndex);
+    Stats.NumResidentChunks--;
+    Stats.NumEvictions++;
+}
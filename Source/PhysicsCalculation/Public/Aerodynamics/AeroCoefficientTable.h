@@ -0,0 +1,128 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/CurveVector.h"
+#include "Misc/Crc.h"
+
+/*
+ * Uniformly sampled copy of air drag curve (X - drag coefficient, Y - lift coefficient)
+ * indexed by velocity magnitude (cm/s); lookup is O(1) with linear interpolation.
+ * Velocities outside of curve time range are clamped to its edges only if curve extrapolation is constant there,
+ * otherwise lookup fails and curve has to be evaluated.
+ * Table is immutable once built and is shared between copies of body params.
+ */
+struct FAeroCoefficientTable
+{
+    static constexpr int NumSamples = 1024;
+
+    TArray<FVector2D> Samples;
+    float MinSpeed = 0.0f;
+    float MaxSpeed = 0.0f;
+    float SpeedStepInv = 0.0f;
+    bool bClampBelow = true;
+    bool bClampAbove = true;
+    
+    const UCurveVector* SourceCurve = nullptr;
+    uint32 SourceSignature = 0;
+
+    // max deviation from source curve measured between samples after build
+    float MaxError = 0.0f;
+
+public:
+    bool IsBuiltFor(const UCurveVector* Curve) const {return Curve && SourceCurve == Curve;}
+    // detects both replaced curve asset and keys or extrapolation changed in place
+    bool IsUpToDate(const UCurveVector* Curve) const {return IsBuiltFor(Curve) && SourceSignature == MakeCurveSignature(Curve);}
+    float GetMaxError() const {return MaxError;}
+    
+    void Reset()
+    {
+        Samples.Empty();
+        MinSpeed = 0.0f;
+        MaxSpeed = 0.0f;
+        SpeedStepInv = 0.0f;
+        bClampBelow = true;
+        bClampAbove = true;
+        SourceCurve = nullptr;
+        SourceSignature = 0;
+        MaxError = 0.0f;
+    }
+
+    void Build(const UCurveVector* Curve)
+    {
+        Reset();
+        if(!Curve) return;
+
+        Curve->GetTimeRange(MinSpeed, MaxSpeed);
+        // only drag and lift channels are sampled
+        bClampBelow = IsConstantExtrapolation(Curve->FloatCurves[0].PreInfinityExtrap) && IsConstantExtrapolation(Curve->FloatCurves[1].PreInfinityExtrap);
+        bClampAbove = IsConstantExtrapolation(Curve->FloatCurves[0].PostInfinityExtrap) && IsConstantExtrapolation(Curve->FloatCurves[1].PostInfinityExtrap);
+
+        const bool bSingleSample = MaxSpeed <= MinSpeed;
+        const int Num = bSingleSample ? 1 : NumSamples;
+        const float Step = bSingleSample ? 0.0f : (MaxSpeed - MinSpeed) / (Num - 1);
+        SpeedStepInv = bSingleSample ? 0.0f : 1.0f / Step;
+
+        Samples.SetNumUninitialized(Num);
+        for (int i = 0; i < Num; ++i)
+        {
+            const FVector V = Curve->GetVectorValue(MinSpeed + i * Step);
+            Samples[i] = FVector2D(V.X, V.Y);
+        }
+
+        SourceCurve = Curve;
+        SourceSignature = MakeCurveSignature(Curve);
+
+        // interpolation error is largest between samples
+        for (int i = 0; i < Num - 1; ++i)
+        {
+            const float Speed = MinSpeed + (i + 0.5f) * Step;
+            const FVector V = Curve->GetVectorValue(Speed);
+            FVector2D T;
+            GetValue(Speed, T);
+            MaxError = FMath::Max(MaxError, FMath::Max(FMath::Abs(V.X - T.X), FMath::Abs(V.Y - T.Y)));
+        }
+    }
+
+    // returns false if table is empty or Speed is in extrapolated range which table does not reproduce
+    bool GetValue(float Speed, FVector2D& OutValue) const
+    {
+        const int LastIndex = Samples.Num() - 1;
+        if(LastIndex < 0) return false;
+        if(Speed < MinSpeed && !bClampBelow) return false;
+        if(Speed > MaxSpeed && !bClampAbove) return false;
+        if(LastIndex == 0)
+        {
+            OutValue = Samples[0];
+            return true;
+        }
+
+        const float Position = FMath::Clamp((Speed - MinSpeed) * SpeedStepInv, 0.0f, static_cast<float>(LastIndex));
+        const int Index = FMath::Min(static_cast<int>(Position), LastIndex - 1);
+        const float Alpha = Position - Index;
+        OutValue = FMath::Lerp(Samples[Index], Samples[Index + 1], Alpha);
+        return true;
+    }
+
+    static bool IsConstantExtrapolation(ERichCurveExtrapolation Extrapolation)
+    {
+        return Extrapolation == RCCE_Constant || Extrapolation == RCCE_None;
+    }
+
+    static uint32 MakeCurveSignature(const UCurveVector* Curve)
+    {
+        uint32 Crc = 0;
+        if(!Curve) return Crc;
+        
+        for (const auto& FloatCurve : Curve->FloatCurves)
+        {
+            for (const auto& Key : FloatCurve.Keys)
+            {
+                const float KeyData[] = {Key.Time, Key.Value, Key.ArriveTangent, Key.LeaveTangent, static_cast<float>(Key.InterpMode)};
+                Crc = FCrc::MemCrc32(KeyData, sizeof(KeyData), Crc);
+            }
+            const uint8 Extrapolation[] = {FloatCurve.PreInfinityExtrap, FloatCurve.PostInfinityExtrap};
+            Crc = FCrc::MemCrc32(Extrapolation, sizeof(Extrapolation), Crc);
+        }
+        return Crc;
+    }
+};
@@ -9,6 +9,7 @@
 
 struct FPhysTransform;
 struct FPhysRigidBodyParams;
+struct FPhysSimParams;
 struct FBodyAerodynamics;
 struct FSideforceBaseGenerator;
 class UCustomPhysicsComponent;
@@ -25,12 +26,19 @@ public:
      * use independent location offset because generator introduces crucial error during recalculation from location to velocity
      */
     static void CalculateAerodynamicImpact(FPSI_Data& Data, FVector& OutLinearVelocity, FVector& OutAngularVelocity, FVector& locationOffset);
+    // sideforce part of aerodynamic impact only; velocity independent, so integrators apply it once per step
+    static void CalculateExtraForcesImpact(FPSI_Data& Data, FVector& OutAngularVelocity, FVector& locationOffset);
+    static FVector CalculateAerodynamicForce(const FPhysRigidBodyParams& RbParams, const FVector& LinearVelocity, const FVector& AngularVelocity);
+    static FVector CalculateAerodynamicForce(const FPhysSimParams& SimParams, const FVector& LinearVelocity, const FVector& AngularVelocity);
 
 protected:
-    static FVector CalculateAerodynamicForce(const FPhysRigidBodyParams& RbParams, const FVector& LinearVelocity, const FVector& AngularVelocity);
     static FVector ComputeSphereAirDragForce(float CrossSectionArea, float AirDensity, FVector LinearVelocity);
     static FVector ComputeSphereLiftForceIdeal(float Radius, float AirDensity, FVector LinearVelocity, FVector AngularVelocity);
 
+public:
+    // lift force is this factor multiplied by (LinearVelocity ^ AngularVelocity)
+    static float GetSphereLiftFactor(float Radius, float AirDensity);
+
 public:
     static FVector GetOffsetToApplyWithTimeSkip(FSideforceBaseGenerator& S, FVector ForwardVector, FVector RightVector, FVector UpVector,
                                                 float DeltaTime, float SkipTime, float VelocityImpactAlpha);
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "ConstantsHM.h"
+#include "AeroCoefficientTable.h"
 #include "Curves/CurveVector.h"
 #include "AirDrag.generated.h"
 
@@ -24,9 +25,51 @@ public:
     // UPROPERTY(EditAnywhere, BlueprintReadOnly)
     float AirDensity = 1.2f;
 
+    /*
+     * Baked AirDragCurve; used instead of curve evaluation while it was built from current curve asset.
+     * Shared by copies of params, a rebuild replaces the pointer and never modifies table in use.
+     */
+    TSharedPtr<const FAeroCoefficientTable, ESPMode::ThreadSafe> CoefficientTable;
+
 public:
+    // replaces curve and bakes it right away, so simulation never evaluates curve or checks for edits per step
+    void SetAirDragCurve(UCurveVector* Curve)
+    {
+        AirDragCurve = Curve;
+        UpdateCoefficientTable();
+    }
+
+    /*
+     * Rebuilds coefficient table only if curve asset was replaced or its keys were changed;
+     * returns true if table was rebuilt.
+     * Called on init, curve assignment and property edits - not per tick.
+     */
+    bool UpdateCoefficientTable()
+    {
+        if(!AirDragCurve)
+        {
+            const bool bHadTable = CoefficientTable.IsValid();
+            CoefficientTable.Reset();
+            return bHadTable;
+        }
+        if(CoefficientTable.IsValid() && CoefficientTable->IsUpToDate(AirDragCurve)) return false;
+
+        const auto Table = MakeShared<FAeroCoefficientTable, ESPMode::ThreadSafe>();
+        Table->Build(AirDragCurve);
+        CoefficientTable = Table;
+        return true;
+    }
     
-    FVector GetAirDragVector(float Velocity) const {return  AirDragCurve ? AirDragCurve->GetVectorValue(Velocity) : FVector::ZeroVector;}
+    FVector GetAirDragVector(float Velocity) const
+    {
+        const FAeroCoefficientTable* Table = CoefficientTable.Get();
+        FVector2D V;
+        if(Table && Table->IsBuiltFor(AirDragCurve) && Table->GetValue(Velocity, V))
+        {
+            return FVector(V.X, V.Y, 0.0f);
+        }
+        return  AirDragCurve ? AirDragCurve->GetVectorValue(Velocity) : FVector::ZeroVector;
+    }
     float GetAirDragCoefficient(float Velocity) const {return GetAirDragVector(Velocity).X;}
     float GetLiftCoefficient(float Velocity) const {return GetAirDragVector(Velocity).Y;}
     float GetAirDensityKgCm3() const {return AirDensity * M3ToCm3;}
@@ -38,6 +38,7 @@ public:
 
     void Init()
     {
+        AirDrag.UpdateCoefficientTable();
         Sideforce.Init();
     }
 };
\ No newline at end of file
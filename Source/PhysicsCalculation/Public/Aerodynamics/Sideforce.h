@@ -48,6 +48,15 @@ public:
         LocationOffsetGenerator.Init();
         AngularVelocityGenerator.Init();
     }
+
+    // generators share seed; their streams differ
+    void Init(int32 Seed)
+    {
+        LocationOffsetGenerator.Init(Seed);
+        AngularVelocityGenerator.Init(Seed);
+    }
+
+    int32 GetSeed() const {return LocationOffsetGenerator.Seed;}
     
     void Update(float DeltaTime)
     {
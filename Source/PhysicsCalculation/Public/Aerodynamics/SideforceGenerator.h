@@ -50,7 +50,7 @@ public:
     float MaxVerticalDistance = 0.0f;
 
 public:
-    virtual FVector ProduceVector() override {return ProduceRandomVector(MaxHorizontalDistance, MaxVerticalDistance, 0.0f);}
+    virtual FVector ProduceVector(int64 Step) const override {return ProduceRandomVector(MaxHorizontalDistance, MaxVerticalDistance, 0.0f, Step, 0);}
 
     static float GetHorizontalValue(const FVector &V) {return V.X;}
     static float GetVerticalValue(const FVector &V) {return V.Y;}
@@ -73,6 +73,6 @@ struct FAngularVelocityGenerator : public FSideforceBaseGenerator
     float MaxAxisValue;
 
 public:
-    virtual FVector ProduceVector() override {return ProduceRandomVector(MaxAxisValue, MaxAxisValue, MaxAxisValue);}
+    virtual FVector ProduceVector(int64 Step) const override {return ProduceRandomVector(MaxAxisValue, MaxAxisValue, MaxAxisValue, Step, 1);}
 
 };
\ No newline at end of file
@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UCustomPhysicsBaseComponent;
+
+/*
+ * Uniform grid over cached world bounds of simplified (non simulated) objects.
+ * Bounds are refreshed once per processor tick and object is reinserted only if its bounds changed;
+ * objects covering too many cells are kept in separate list and tested always (e.g. ground).
+ */
+struct PHYSICSCALCULATION_API FCollisionBroadphase
+{
+    static constexpr int MaxCellsPerObject = 64;
+
+    float CellSize = 200.0f;
+    
+    TArray<UCustomPhysicsBaseComponent*> Objects;
+    TArray<FBox> Boxes;
+    TArray<int> OversizedObjects;
+    TMap<FIntVector, TArray<int>> Cells;
+    // full grid rebuilds; changes only when object set or cell size is changed
+    int32 NumRebuilds = 0;
+
+public:
+    void Reset();
+    
+    /*
+     * Call once per tick before substeps; rebuilds grid if object set or cell size was changed
+     */
+    void Update(const TArray<UCustomPhysicsBaseComponent*>& SimplifiedObjects, float InCellSize);
+
+    /*
+     * Indices of objects whose bounds overlap Box; sorted ascending, without duplicates
+     */
+    void Query(const FBox& Box, TArray<int>& OutIndices) const;
+    
+    int Num() const {return Objects.Num();}
+    UCustomPhysicsBaseComponent* GetObject(int Index) const {return Objects[Index];}
+
+protected:
+    static FBox GetObjectBox(const UCustomPhysicsBaseComponent* Obj);
+    void GetCellRange(const FBox& Box, FIntVector& OutMin, FIntVector& OutMax) const;
+    static int GetNumCells(const FIntVector& Min, const FIntVector& Max);
+    void Insert(int Index);
+    void Remove(int Index);
+};
@@ -5,10 +5,12 @@
 #include "CoreMinimal.h"
 #include "Common/PhysRigidBodyParams.h"
 #include "Common/PhysTransform.h"
+#include "Common/PSI_Data.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "CollisionDetection.generated.h"
 
 struct FCollisionPair;
+struct FCollisionBroadphase;
 class UCustomPhysicsComponent;
 class UCustomPhysicsBaseComponent;
 /**
@@ -24,15 +26,40 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 	static bool DetectCollisionAgainstSphere(UPrimitiveComponent* PC, const FVector& SLocation, const float& SRadius, FVector& CollisionPointPC, float& Penetration);
+	// uses analytic collision snapshot of object if available, engine query otherwise
+	static bool DetectCollisionAgainstSphere(const UCustomPhysicsBaseComponent* Obj, const FVector& SLocation, float SRadius, FVector& CollisionPointPC, float& Penetration);
 
 	static bool TestCustomCollisionAgainstSphere(UCustomPhysicsBaseComponent* ObjA, UCustomPhysicsComponent* ObjB, FCollisionPair& CollisionPair);
 	static bool FindCollisionsAgainstSphereArray(const TArray<UCustomPhysicsComponent*>& FullObjects, const TArray<UCustomPhysicsBaseComponent*>& SimplifiedObjects, TArray<FCollisionPair>& CollisionPairs);
+	// narrow phase runs only against objects whose cached bounds overlap sphere bounds
+	static bool FindCollisionsAgainstSphereArray(const TArray<UCustomPhysicsComponent*>& FullObjects, const FCollisionBroadphase& Broadphase, TArray<FCollisionPair>& CollisionPairs);
+	// same as above; Candidates is caller owned scratch buffer
+	static bool FindCollisionsAgainstSphereArray(const TArray<UCustomPhysicsComponent*>& FullObjects, const FCollisionBroadphase& Broadphase, TArray<FCollisionPair>& CollisionPairs, TArray<int>& Candidates);
 	static bool FindCollisionAgainstSpherePredictMode(FVector SphereLocation, UCustomPhysicsComponent* Obj, const TArray<UCustomPhysicsBaseComponent*>& StaticObjects, TArray<FCollisionPair>& CollisionPairs);
+	/*
+	 * Continuous detection: Alpha is fraction of the move at first contact, SphereLocation is sphere center at that instant.
+	 * Analytic time of impact for objects with collision snapshot, stepped sampling otherwise.
+	 * Overlap at StartLocation is not reported - it is handled by discrete detection.
+	 */
 	static bool FindFirstCollisionAgainstSphere(FVector StartLocation, FVector EndLocation, UCustomPhysicsComponent* Obj,
 												const TArray<UCustomPhysicsBaseComponent*>& StaticObjects, FCollisionPair& Collision,
 												FVector& SphereLocation, float& Alpha);
+	static bool FindFirstCollisionAgainstSphereStepped(const FVector& StartLocation, const FVector& EndLocation, float Radius, const UCustomPhysicsBaseComponent* StaticObj,
+													   float& Alpha, FVector& Normal);
+	/*
+	 * If sphere of Data.Obj moves farther than TunnelingDetectionSphereRadiusMul * Radius from T to TNext (step of Data.DeltaTime)
+	 * and hits something on the way, collision is resolved at contact instant and the rest of the step is integrated from there;
+	 * that part is swept again, up to MaxSweepContactsPerStep contacts. Otherwise OutT is TNext.
+	 */
+	static bool SweepSpherePredictMode(const FPSI_Data& Data, const FPhysTransform& T, const FPhysTransform& TNext,
+									   const TArray<UCustomPhysicsBaseComponent*>& StaticObjects, FPhysTransform& OutT);
+	// same against objects of broadphase within reach of the step; Candidates and StaticObjects are caller owned scratch buffers
+	static bool SweepSpherePredictMode(const FPSI_Data& Data, const FPhysTransform& T, const FPhysTransform& TNext, const FCollisionBroadphase& Broadphase,
+									   TArray<int>& Candidates, TArray<UCustomPhysicsBaseComponent*>& StaticObjects, FPhysTransform& OutT);
 	static void ResolveCustomCollisionAgainstSphere(const FCollisionPair& CollisionPair);
 	static void ResolveCustomCollisionAgainstSpherePredictMode(const FPhysTransform& T, const FCollisionPair& CollisionPair, FPhysTransform& OutT);
+	// same without validity check of pair; contacts found by continuous detection touch without penetration
+	static void ResolveContactAgainstSpherePredictMode(const FPhysTransform& T, const FCollisionPair& CollisionPair, FPhysTransform& OutT);
 
 	static void CalcSeparationOffsets(float InvMassA, float InvMassB, FVector PV, FVector& OffsetA, FVector& OffsetB);
 	static void ApplyCollisionImpulse(UCustomPhysicsBaseComponent* Obj, const FVector& FullImpulse, const FVector& CP, float Time, bool bRecomputePredict);
@@ -0,0 +1,156 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UPrimitiveComponent;
+
+enum class EAnalyticShapeType : uint8
+{
+    Sphere,
+    Box,
+    Capsule
+};
+
+/*
+ * Simple collision element in world space
+ */
+struct PHYSICSCALCULATION_API FAnalyticCollisionShape
+{
+    EAnalyticShapeType Type = EAnalyticShapeType::Sphere;
+    FVector Center = FVector::ZeroVector;
+    FQuat Rotation = FQuat::Identity;
+    // box half size
+    FVector Extent = FVector::ZeroVector;
+    // sphere and capsule
+    float Radius = 0.0f;
+    // half length of capsule segment (without caps); segment is aligned with local Z
+    float HalfLength = 0.0f;
+
+public:
+    /*
+     * Same contract as UPrimitiveComponent::GetClosestPointOnCollision:
+     * returns distance to shape, 0 and the point itself if point is inside
+     */
+    float GetClosestPoint(const FVector& Point, FVector& OutPoint) const
+    {
+        switch (Type)
+        {
+        case EAnalyticShapeType::Box: return GetClosestPointBox(Point, OutPoint);
+        case EAnalyticShapeType::Capsule:
+            {
+                const FVector Axis = Rotation.GetAxisZ();
+                const float T = FMath::Clamp(FVector::DotProduct(Point - Center, Axis), -HalfLength, HalfLength);
+                return GetClosestPointSphere(Center + Axis * T, Radius, Point, OutPoint);
+            }
+        default: return GetClosestPointSphere(Center, Radius, Point, OutPoint);
+        }
+    }
+
+    /*
+     * Time of impact of sphere moving from Start by Delta.
+     * OutAlpha is fraction of Delta at first contact, OutNormal points from shape to sphere center.
+     * Returns false if sphere misses, only grazes shape or already overlaps it at Start
+     * (overlap is left to discrete detection).
+     */
+    bool SweepSphere(const FVector& Start, const FVector& Delta, float SphereRadius, float& OutAlpha, FVector& OutNormal) const;
+
+protected:
+    static float GetClosestPointSphere(const FVector& SphereCenter, float SphereRadius, const FVector& Point, FVector& OutPoint)
+    {
+        const FVector Delta = Point - SphereCenter;
+        const float Distance = Delta.Size();
+        if(Distance <= SphereRadius)
+        {
+            OutPoint = Point;
+            return 0.0f;
+        }
+        OutPoint = SphereCenter + Delta * (SphereRadius / Distance);
+        return Distance - SphereRadius;
+    }
+
+    float GetClosestPointBox(const FVector& Point, FVector& OutPoint) const
+    {
+        const FVector Local = Rotation.UnrotateVector(Point - Center);
+        const FVector Clamped = FVector(FMath::Clamp(Local.X, -Extent.X, Extent.X),
+                                        FMath::Clamp(Local.Y, -Extent.Y, Extent.Y),
+                                        FMath::Clamp(Local.Z, -Extent.Z, Extent.Z));
+        const float Distance = FVector::Dist(Local, Clamped);
+        OutPoint = Distance > 0.0f ? Center + Rotation.RotateVector(Clamped) : Point;
+        return Distance;
+    }
+
+    // point moving along segment against sphere and capsule inflated by sphere radius; OutT in [0, 1]
+    static bool SweepPointSphere(const FVector& Start, const FVector& Delta, const FVector& SphereCenter, float SphereRadius, float& OutT, FVector& OutNormal);
+    static bool SweepPointCapsule(const FVector& Start, const FVector& Delta, const FVector& A, const FVector& B, float CapsuleRadius, float& OutT, FVector& OutNormal);
+    // box rounded by sphere radius: faces by slab test, edges and corners as capsules
+    bool SweepSphereBox(const FVector& Start, const FVector& Delta, float SphereRadius, float& OutT, FVector& OutNormal) const;
+};
+
+/*
+ * Collision of primitive component converted to analytic shapes; refreshed once per tick.
+ * Queries use no UObject access, so they may run on any thread.
+ * If collision contains elements without analytic form (convex, mesh), snapshot stays invalid
+ * and engine query has to be used.
+ */
+struct FCollisionShapeSnapshot
+{
+    TArray<FAnalyticCollisionShape> Shapes;
+    bool bValid = false;
+
+    const UPrimitiveComponent* Source = nullptr;
+    FTransform SourceTransform = FTransform::Identity;
+
+public:
+    bool IsValid() const {return bValid;}
+    
+    void Reset()
+    {
+        Shapes.Reset();
+        bValid = false;
+        Source = nullptr;
+    }
+    
+    // rebuilds shapes only if component or its transform was changed
+    void Update(const UPrimitiveComponent* P);
+
+    /*
+     * Returns distance to closest shape; negative if there are no shapes (collision disabled)
+     */
+    float GetClosestPoint(const FVector& Point, FVector& OutPoint) const
+    {
+        float MinDistance = -1.0f;
+        for (const auto& Shape : Shapes)
+        {
+            FVector ShapePoint;
+            const float Distance = Shape.GetClosestPoint(Point, ShapePoint);
+            if(MinDistance < 0.0f || Distance < MinDistance)
+            {
+                MinDistance = Distance;
+                OutPoint = ShapePoint;
+            }
+        }
+        return MinDistance;
+    }
+
+    // earliest time of impact among shapes, see FAnalyticCollisionShape::SweepSphere
+    bool SweepSphere(const FVector& Start, const FVector& Delta, float SphereRadius, float& OutAlpha, FVector& OutNormal) const
+    {
+        bool bHit = false;
+        OutAlpha = 1.0f;
+        for (const auto& Shape : Shapes)
+        {
+            float Alpha;
+            FVector Normal;
+            if(Shape.SweepSphere(Start, Delta, SphereRadius, Alpha, Normal) && (!bHit || Alpha < OutAlpha))
+            {
+                bHit = true;
+                OutAlpha = Alpha;
+                OutNormal = Normal;
+            }
+        }
+        return bHit;
+    }
+
+protected:
+    bool Build(const UPrimitiveComponent* P);
+};
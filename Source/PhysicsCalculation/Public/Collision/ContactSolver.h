@@ -0,0 +1,111 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Common/PhysTransform.h"
+#include "Common/SimpleMatrix3.h"
+
+struct FCollisionPair;
+class UCustomPhysicsBaseComponent;
+class UCustomPhysicsComponent;
+
+struct FContactSolverBody
+{
+    UCustomPhysicsBaseComponent* Obj = nullptr;
+    FVector Location = FVector::ZeroVector;
+    FVector LinearVelocity = FVector::ZeroVector;
+    FVector AngularVelocity = FVector::ZeroVector;
+    float MassInv = 0.0f;
+    FSimpleMatrix3 InertiaInv;
+
+    // summed over solve, applied to object once at the end
+    FVector LinearImpulse = FVector::ZeroVector;
+    FVector AngularImpulse = FVector::ZeroVector;
+    FVector SeparationOffset = FVector::ZeroVector;
+
+public:
+    FVector GetVelocityAtPoint(const FVector& P) const {return LinearVelocity + (AngularVelocity ^ (P - Location));}
+    void ApplyImpulse(const FVector& Impulse, const FVector& P);
+};
+
+struct FContactSolverContact
+{
+    // indices in bodies array; impulse is applied to B and opposite one to A
+    int BodyA = INDEX_NONE;
+    int BodyB = INDEX_NONE;
+    
+    FVector Point = FVector::ZeroVector;
+    // from A to B
+    FVector Normal = FVector::ZeroVector;
+    FVector TangentU = FVector::ZeroVector;
+    FVector TangentV = FVector::ZeroVector;
+    float Penetration = 0.0f;
+
+    float NormalMass = 0.0f;
+    float TangentMassU = 0.0f;
+    float TangentMassV = 0.0f;
+    float Friction = 0.0f;
+    // normal velocity contact has to reach; comes from restitution
+    float TargetVelocity = 0.0f;
+
+    // accumulated over iterations
+    float NormalImpulse = 0.0f;
+    FVector2D TangentImpulse = FVector2D::ZeroVector;
+};
+
+// impulse of contact from previous substep
+struct FContactSolverCachedImpulse
+{
+    const UCustomPhysicsBaseComponent* ObjA = nullptr;
+    const UCustomPhysicsBaseComponent* ObjB = nullptr;
+    FVector Point = FVector::ZeroVector;
+    FVector Normal = FVector::ZeroVector;
+    float NormalImpulse = 0.0f;
+    FVector TangentImpulse = FVector::ZeroVector;
+};
+
+/*
+ * Resolves all contacts of a substep together instead of pair by pair, so result does not depend on their order
+ * (ball pinched between post and ground, or between two bodies).
+ * Projected Gauss-Seidel over accumulated impulses: normal impulse is kept non negative,
+ * friction impulse is kept inside Coulomb cone of current normal impulse.
+ * Iteration count is fixed; with warm start impulses of persisting contacts start from their previous substep values.
+ */
+struct PHYSICSCALCULATION_API FContactSolver
+{
+    int NumIterations = 8;
+    bool bWarmStart = true;
+    // cm/sec; slower approach does not bounce, so resting contacts stay at rest
+    float RestitutionVelocityThreshold = 20.0f;
+    // cached contact is reused only if it barely moved
+    float WarmStartMinNormalDot = 0.95f;
+    float WarmStartMaxPointShift = 5.0f;
+
+    TArray<FContactSolverBody> Bodies;
+    TArray<FContactSolverContact> Contacts;
+    TArray<FContactSolverCachedImpulse> Cache;
+
+public:
+    // separates and resolves live objects of pairs
+    void Solve(const TArray<FCollisionPair>& Pairs);
+
+    // lower level interface for bodies without objects
+    void Reset();
+    SIZE_T GetAllocatedSize() const {return Bodies.GetAllocatedSize() + Contacts.GetAllocatedSize() + Cache.GetAllocatedSize();}
+    int AddBody(const FContactSolverBody& Body) {return Bodies.Add(Body);}
+    // state of body is taken from object; same object is added once
+    int FindOrAddBody(UCustomPhysicsBaseComponent* Obj);
+    void AddContact(int BodyA, int BodyB, const FVector& Point, const FVector& Normal, float Penetration, float Friction, float Restitution);
+    // warm start, fixed number of iterations and separation offsets of bodies
+    void SolveContacts();
+
+protected:
+    void AddContact(const FCollisionPair& Pair);
+    void WarmStart();
+    void SolveVelocities();
+    void StoreImpulses();
+    void SeparateBodies();
+    
+    float GetEffectiveMass(const FContactSolverContact& C, const FVector& Direction) const;
+    float GetRelativeVelocity(const FContactSolverContact& C, const FVector& Direction) const;
+    void ApplyContactImpulse(const FContactSolverContact& C, const FVector& Impulse);
+};
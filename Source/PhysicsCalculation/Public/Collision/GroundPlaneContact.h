@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Collision/CollisionShapeSnapshot.h"
+#include "Collision/ContactSolver.h"
+#include "Collision/PredictionStep.h"
+#include "Common/PhysTransform.h"
+
+class UCustomPhysicsComponent;
+class UCustomPhysicsBaseComponent;
+
+/*
+ * Flat ground under ball in movement prediction, resolved without collision queries.
+ * Ground is a resting static body made of single box with horizontal top. Contact with its top is resolved by
+ * FPredictionStep::ResolveContacts as in UCustomPhysicsProcessorBase::PredictTransform, so result does not change.
+ * Bounds of other static bodies are kept, so caller returns to general collision once ball approaches any of them.
+ */
+struct FGroundPlaneContact
+{
+    FAnalyticCollisionShape Ground;
+    float GroundZ = 0.0f;
+
+    // with contact solver settings of processor
+    FPredictionBody Ball;
+    // ground body only
+    TArray<FPredictionCollider> GroundColliders;
+
+    // world bounds of other static bodies
+    TArray<FBox> Obstacles;
+
+    // solver of predicted sequence, so warm start carries over between this contact and general collision
+    FContactSolver* Solver = nullptr;
+
+public:
+    /*
+     * Fails if body under ball is not a flat ground, ball is higher than its radius above it, or ball is already near other body
+     */
+    static bool Make(UCustomPhysicsComponent* Obj, const TArray<UCustomPhysicsBaseComponent*>& StaticBodies, const FPhysTransform& T, float DeltaTime,
+                     FContactSolver& SequenceSolver, FGroundPlaneContact& Out);
+
+    // ball stays over ground top and does not reach bounds of other bodies during next step
+    bool CanContinue(const FPhysTransform& T, float DeltaTime) const;
+    // same as discrete detection: contact exists while sphere penetrates ground top
+    bool IsTouching(const FPhysTransform& T) const {return T.Location.Z - Ball.Radius < GroundZ;}
+    
+    // ball penetrating ground is separated and gets contact impulse
+    void Resolve(FPhysTransform& InOutT);
+
+protected:
+    bool IsOverGround(const FVector& Location) const {return IsOverBox(Ground, Location);}
+    static bool IsOverBox(const FAnalyticCollisionShape& Box, const FVector& Location);
+};
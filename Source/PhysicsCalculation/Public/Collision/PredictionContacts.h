@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Collision/ContactSolver.h"
+#include "Collision/PredictionStep.h"
+
+class UCustomPhysicsBaseComponent;
+
+/*
+ * Contacts of one predicted sequence (precise or rough prediction, movement query), owned by whoever runs it,
+ * so sequences share no state through processor.
+ */
+struct PHYSICSCALCULATION_API FPhysPredictionContacts
+{
+    // static bodies copied every predicted step but keeping their allocation
+    TArray<FPredictionCollider> Colliders;
+    // keeps impulses of predicted contacts between steps of sequence, as live contact solver does between substeps
+    FContactSolver Solver;
+
+public:
+    // sequence starts from current state of objects: LiveCache is warm start of its first step
+    void Reset(const TArray<FContactSolverCachedImpulse>& LiveCache);
+    void Reset();
+
+    void UpdateColliders(const TArray<UCustomPhysicsBaseComponent*>& StaticBodies);
+    // stays the same over steps of sequence once buffers have grown to its contacts
+    SIZE_T GetAllocatedSize() const {return Colliders.GetAllocatedSize() + Solver.GetAllocatedSize();}
+};
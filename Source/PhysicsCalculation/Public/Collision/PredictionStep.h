@@ -0,0 +1,111 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Collision/CollisionShapeSnapshot.h"
+#include "Collision/ContactSolver.h"
+#include "Common/PhysEnums.h"
+#include "Common/PhysSimParams.h"
+#include "Common/PhysTransform.h"
+#include "Common/SimpleMatrix3.h"
+#include "Libs/BallGroundMovementData.h"
+
+class UCustomPhysicsBaseComponent;
+class UCustomPhysicsComponent;
+
+/*
+ * Predicted sphere: everything a predicted step needs besides its transform
+ */
+struct FPredictionBody
+{
+    // identifies contacts of body in warm start cache; not accessed
+    UCustomPhysicsBaseComponent* Obj = nullptr;
+    
+    bool bCheckCollisions = true;
+    bool bLockX = false;
+    bool bLockY = false;
+    bool bLockZ = false;
+
+    float Radius = 0.0f;
+    float MassInv = 0.0f;
+    FSimpleMatrix3 InertiaInv;
+    float Friction = 0.0f;
+    float Restitution = 0.0f;
+    EPhysicsCombineMode FrictionCombineMode = Average;
+    EPhysicsCombineMode RestitutionCombineMode = Average;
+    
+    // settings of processor contact solver; 0 iterations - contacts are resolved one by one
+    int ContactSolverIterations = 0;
+    bool bContactSolverWarmStart = false;
+
+public:
+    // sphere and locks of object; contact solver settings are left to caller
+    void SetFromObject(UCustomPhysicsComponent* InObj);
+};
+
+/*
+ * Copy of static collider state required to resolve collision in prediction mode
+ */
+struct PHYSICSCALCULATION_API FPredictionCollider
+{
+    // identifies contacts of collider in warm start cache;
+    // queried directly only if Shape is invalid, which is allowed on game thread only
+    UCustomPhysicsBaseComponent* Obj = nullptr;
+    
+    FCollisionShapeSnapshot Shape;
+    FVector Location = FVector::ZeroVector;
+    FVector LinearVelocity = FVector::ZeroVector;
+    FVector AngularVelocity = FVector::ZeroVector;
+    FSimpleMatrix3 InertiaInv;
+    float MassInv = 0.0f;
+    float Friction = 0.0f;
+    float Restitution = 0.0f;
+    EPhysicsCombineMode RestitutionCombineMode = Average;
+
+    // rolling of body on this collider, made for combined contact values; stepped while it is not built
+    TSharedPtr<const FBallGroundMovementData, ESPMode::ThreadSafe> GroundRoll;
+
+public:
+    // current state of object; its collision snapshot is taken as is
+    void SetFromObject(UCustomPhysicsBaseComponent* InObj);
+    
+    FVector GetFullVelocityAtPoint(const FVector& P) const {return LinearVelocity + (AngularVelocity ^ (P - Location));}
+    bool IsResting() const {return LinearVelocity.IsNearlyZero() && AngularVelocity.IsNearlyZero();}
+    
+    // same contract as FCollisionShapeSnapshot::GetClosestPoint
+    float GetClosestPoint(const FVector& Point, FVector& OutPoint) const;
+    // same contract as FCollisionShapeSnapshot::SweepSphere; swept contact has to have a normal
+    bool SweepSphere(const FVector& Start, const FVector& End, float SphereRadius, float& OutAlpha, FVector& OutNormal) const;
+};
+
+/*
+ * One predicted step of sphere among static colliders: contacts at start, integration, sweep of the step.
+ * Works on copies only, so the same step runs in processor prediction and in background jobs.
+ */
+struct PHYSICSCALCULATION_API FPredictionStep
+{
+    // advances body without contacts by DeltaTime
+    using FIntegrate = TFunctionRef<void(float DeltaTime, FPhysTransform& InOutT)>;
+    
+    // Solver is caller owned and kept between steps of one predicted sequence
+    static void Simulate(const FPredictionBody& Body, const FPhysSimParams& SimParams, const TArray<FPredictionCollider>& Colliders, float DeltaTime,
+                         const FPhysTransform& T, FContactSolver& Solver, FPhysTransform& OutT);
+    static void Simulate(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, float DeltaTime, FIntegrate Integrate,
+                         const FPhysTransform& T, FContactSolver& Solver, FPhysTransform& OutT);
+
+    static bool HasContact(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, const FVector& Location, int IgnoredCollider = INDEX_NONE);
+    // contacts at T, resolved together when Body.ContactSolverIterations > 0
+    static void ResolveContacts(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, const FPhysTransform& T, FContactSolver& Solver,
+                                FPhysTransform& OutT);
+    /*
+     * Fast body hitting collider between T and InOutTNext bounces off it and moves for the rest of the step.
+     * Returns true if anything was hit.
+     */
+    static bool SweepStep(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, float DeltaTime, FIntegrate Integrate,
+                          const FPhysTransform& T, FPhysTransform& InOutTNext);
+    // collider hit first by sphere moving from Start to End; INDEX_NONE if there is none
+    static int FindFirstSweepHit(const FPredictionBody& Body, const TArray<FPredictionCollider>& Colliders, const FVector& Start, const FVector& End,
+                                 float& OutAlpha, FVector& OutNormal);
+    // single contact; only body is changed
+    static void ResolveCollision(const FPredictionBody& Body, const FPredictionCollider& C, const FPhysTransform& T,
+                                 const FVector& CP, const FVector& N, float Penetration, FPhysTransform& OutT);
+};
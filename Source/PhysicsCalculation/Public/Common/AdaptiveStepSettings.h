@@ -0,0 +1,33 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AdaptiveStepSettings.generated.h"
+
+/*
+ * Error controlled step of free flight integration (see UAdaptiveIntegrationLib).
+ * Steps are multiples of caller's output step, so samples are taken from dense output without extra integration.
+ */
+USTRUCT(BlueprintType)
+struct FAdaptiveStepSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bEnabled = false;
+
+    // allowed location error per step, cm
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0001"))
+    float Tolerance = 0.05f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0001"))
+    float InitialStep = 0.01f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0001"))
+    float MaxStep = 0.25f;
+};
+
+struct FAdaptiveStepStats
+{
+    int NumAccepted = 0;
+    int NumRejected = 0;
+};
@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Range of trajectory keys where channel value changes monotonically; neighbour segments share boundary key.
+ */
+struct FTrajectoryMonotoneSegment
+{
+    int32 First = 0;
+    int32 Last = 0;
+    bool bIncreasing = true;
+
+    FTrajectoryMonotoneSegment() {}
+    FTrajectoryMonotoneSegment(int32 InFirst, int32 InLast, bool bInIncreasing) : First(InFirst), Last(InLast), bIncreasing(bInIncreasing) {}
+};
+
+/*
+ * Scalar channel of trajectory split into monotone segments while keys are added.
+ * Positions are fractional key indices; lookups binary search only segments whose range contains the value.
+ */
+struct FTrajectoryChannelIndex
+{
+    TArray<float> Values;
+    TArray<FTrajectoryMonotoneSegment> Segments;
+
+public:
+    void Reset(int32 Slack = 0);
+    void Add(float V);
+
+    // all positions where channel equals V in ascending order
+    bool FindPositions(float V, TArray<float>& OutPositions) const;
+    bool FindFirstPosition(float V, float& OutPosition) const;
+    bool FindLastPosition(float V, float& OutPosition) const;
+
+private:
+    bool SegmentContains(const FTrajectoryMonotoneSegment& S, float V) const;
+    float FindInSegment(const FTrajectoryMonotoneSegment& S, float V) const;
+};
+
+/*
+ * Trajectory sampled with uniform time step, indexed by XY distance from start point and by Z.
+ * Replaces linear key scans of FCustomVectorCurve for "time at distance", "times at Z" and "closest point" queries.
+ */
+struct FIndexedTrajectory
+{
+    FIndexedTrajectory() {}
+    FIndexedTrajectory(const TArray<FVector>& InLocations, float InTimeStep);
+
+    void Reset(float InTimeStep, int32 Slack = 0);
+    void Add(const FVector& Location);
+    // rotates around start point; index is rebuilt
+    void RotateByQuat(const FQuat& Q);
+
+public:
+    int32 Num() const {return Locations.Num();}
+    bool IsEmpty() const {return Locations.Num() == 0;}
+    float GetTimeStep() const {return TimeStep;}
+    float GetDuration() const {return FMath::Max(Num() - 1, 0) * TimeStep;}
+    float GetMaxZTime() const {return MaxZKey * TimeStep;}
+    FVector GetStartLocation() const {return IsEmpty() ? FVector::ZeroVector : Locations[0];}
+    const TArray<FVector>& GetLocations() const {return Locations;}
+
+    FVector GetLocationAtTime(float Time) const;
+    
+    // first time when XY distance from start point equals Distance
+    bool GetTimeAtDistanceXY(float Distance, float& OutTime) const;
+    bool GetTimesAtZ(float Z, TArray<float>& OutTimes) const;
+    bool GetLastTimeAtZ(float Z, float& OutTime) const;
+
+    /*
+     * Starts from crossings of target XY distance and from ends of XY distance segments,
+     * then descends to the nearest local minimum of distance to target; best one is returned.
+     */
+    float GetClosestTime(const FVector& Target) const;
+    FVector GetClosestLocation(const FVector& Target) const {return GetLocationAtTime(GetClosestTime(Target));}
+
+private:
+    float TimeStep = 0.0f;
+    TArray<FVector> Locations;
+    FTrajectoryChannelIndex DistanceXY;
+    FTrajectoryChannelIndex Z;
+    int32 MaxZKey = 0;
+
+    FVector GetLocationAtPosition(float Position) const;
+    int32 DescendToClosestKey(const FVector& Target, int32 Key) const;
+    float GetClosestPositionNearKey(const FVector& Target, int32 Key) const;
+};
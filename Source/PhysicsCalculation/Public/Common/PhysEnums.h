@@ -13,4 +13,15 @@ enum EPhysicsCombineMode
     Multiply = 2,	
     /** Uses the maximum value of materials touching: max(a,b) */
     Max = 3
+};
+
+UENUM(BlueprintType)
+enum EPhysIntegrator
+{
+    /** v += a(v) * dt, then x += v * dt; first order, matches batched prediction */
+    SemiImplicitEuler = 0,
+    /** Position from current acceleration, velocity from average of current and predicted end acceleration; second order */
+    VelocityVerlet = 1,
+    /** Classic fourth order Runge-Kutta over location and linear velocity */
+    RungeKutta4 = 2
 };
\ No newline at end of file
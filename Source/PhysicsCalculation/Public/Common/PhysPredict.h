@@ -5,6 +5,9 @@
 
 #include "PhysTrajectory.h"
 #include "PhysTransform.h"
+#include "PhysTransformRingBuffer.h"
+#include "RoughPredictionJob.h"
+#include "Collision/PredictionContacts.h"
 #include "HMStructs/CustomVectorCurve.h"
 
 #include "PhysPredict.generated.h"
@@ -19,6 +22,27 @@
 /*
 * Prediction: Object is moved along obtained trajectory line. Location is changed every substep tick
 */
+USTRUCT(BlueprintType)
+struct FPredictionRecomputeStats
+{
+	GENERATED_BODY()
+
+	// recompute calls made by setters, impulses, collisions etc.
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumRequested = 0;
+
+	// full recomputes that were actually executed
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumPerformed = 0;
+
+	int32 GetNumAvoided() const {return NumRequested - NumPerformed;}
+	void Append(const FPredictionRecomputeStats& Other)
+	{
+		NumRequested += Other.NumRequested;
+		NumPerformed += Other.NumPerformed;
+	}
+};
+
 class UCustomPhysicsComponent;
 USTRUCT(BlueprintType)
 struct FPhysPredict
@@ -38,10 +62,25 @@ public:
 	float TimeSinceRoughPredictUpdate = 0.0f;
 	
 	UPROPERTY(BlueprintReadOnly)
-	TArray<FPhysTransform> PrecisePredictedTransforms;
+	FPhysTransformRingBuffer PrecisePredictedTransforms;
 
 	UPROPERTY(BlueprintReadOnly)
-	TArray<FPhysTransform> RoughPredictedTransforms;
+	FPhysTransformRingBuffer RoughPredictedTransforms;
+
+	// latest requested background rough prediction; results of replaced jobs are dropped
+	TSharedPtr<FRoughPredictionJob, ESPMode::ThreadSafe> RoughPredictJob;
+
+	// ground roll tables by FBallGroundMovementData::MakeSignature; tables of changed params or grounds are dropped
+	TMap<uint32, TSharedPtr<const FBallGroundMovementData, ESPMode::ThreadSafe>> GroundRollTables;
+	TMap<uint32, TSharedPtr<FGroundRollBuildJob, ESPMode::ThreadSafe>> GroundRollJobs;
+
+	// contacts at last step of precise and in place rough prediction; next steps continue them
+	FPhysPredictionContacts PreciseContacts;
+	FPhysPredictionContacts RoughContacts;
+
+	// set by RequestRecompute; cleared when recompute is flushed
+	bool bRecomputePending = false;
+	FPredictionRecomputeStats RecomputeStats;
 
 
 public:
@@ -53,18 +92,35 @@ public:
 	int GetRoughStepsCount() const;
 	void RecomputePrediction();
 
+	void RequestRecompute();
+	// returns true if pending recompute was executed
+	bool FlushRecompute();
+	bool IsRecomputePending() const {return bRecomputePending;}
+	const FPredictionRecomputeStats& GetRecomputeStats() const {return RecomputeStats;}
+
 	void EnablePrediction();
 	void DisablePrediction();
 	float GetSimulationDeltaTime() const;
 
-	bool HasTPredicted() const {return PrecisePredictedTransforms.Num() > 0;}
-	bool HasRoughPredicted() const {return RoughPredictedTransforms.Num() > 0;}
+	bool HasTPredicted() const {return !PrecisePredictedTransforms.IsEmpty();}
+	bool HasRoughPredicted() const {return !RoughPredictedTransforms.IsEmpty();}
+	TArray<FPhysTransform> GetPrecisePredictedTransforms() const {return PrecisePredictedTransforms.ToArray();}
+	TArray<FPhysTransform> GetRoughPredictedTransforms() const {return RoughPredictedTransforms.ToArray();}
 	
 	/*
 	* Should be called when unexpected forces are affected the object (collision, hit, etc)
 	*/
 	void RecomputePrecisePredict();
 	void RecomputeRoughPredict();
+	bool IsRoughPredictInProgress() const {return RoughPredictJob.IsValid();}
+	bool MakeRoughPredictionInput(FRoughPredictionInput& In);
+	// colliders get tables that are built already; missing ones are started in background, so roll is stepped meanwhile
+	void AssignGroundRollTables(FRoughPredictionInput& In);
+	void StartGroundRollJob(const FRoughPredictionInput& In, const FPhysRigidBodyParams& RbParams, float Friction, float Restitution, uint32 Signature);
+	void PollGroundRollJobs();
+	bool StartRoughPredictJob();
+	// swaps in finished background result; called from AdvanceByTime
+	void PollRoughPredictJob();
 	void AddStepsToPrecisePredictArray(const int StepsToAdd);
 	void AddStepsToRoughPredictArray(int StepsToAdd);
 	void UpdatePrecisePredictionDataBySteps(int StepsToUpdate);
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "AdaptiveStepSettings.h"
 #include "PhysPredictSettings.generated.h"
 
 USTRUCT(BlueprintType)
@@ -20,6 +21,26 @@ struct FPhysPredictSettings
     UPROPERTY(EditAnywhere, meta = (ClampMin = "1.0", ClampMax = "10.0", UIMin = "1.0", UIMax = "10.0"))
     float RoughPredictUpdateRate = 2.0f;
 
+    // compute rough prediction on worker thread; previous result is used until new one is ready
+    UPROPERTY(EditAnywhere)
+    bool bAsyncRoughPredict = true;
+
+    // free flight parts of async rough prediction use error controlled steps; contacts are still stepped one by one
+    UPROPERTY(EditAnywhere)
+    FAdaptiveStepSettings RoughAdaptiveStep;
+
+    // rolling on resting horizontal ground in rough prediction is taken from tabulated ground movement (see FBallGroundMovementData)
+    UPROPERTY(EditAnywhere)
+    bool bTabulatedGroundRoll = false;
+
+    // after bounce on flat ground, movement prediction queries resolve next bounces in closed form (see FGroundPlaneContact)
+    UPROPERTY(EditAnywhere)
+    bool bGroundPlaneBounce = false;
+
+    // recompute requests made during a frame are merged and executed once by physics processor tick
+    UPROPERTY(EditAnywhere)
+    bool bDeferredRecompute = true;
+
     //DEPRECATED (remove if old phys iteration will be removed) or make revision
     /*
      * Allowed difference between predicted transform and transform being set during movement in prediction mode.
@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "Aerodynamics/BodyAerodynamics.h"
 #include "PhysConstrains.h"
+#include "PhysEnums.h"
 #include "VelocityDamping.h"
 #include "Libs/InertiaLib.h"
 #include "PhysicsEngine/PhysicsSettings.h"
@@ -44,6 +45,13 @@ struct FPhysRigidBodyParams
 
 	UPROPERTY(BlueprintReadOnly)
 	FPhysRendering Rendering;
+
+	UPROPERTY(BlueprintReadWrite)
+	TEnumAsByte<EPhysIntegrator> Integrator = SemiImplicitEuler;
+
+	/* Rotate by exact quaternion of angular velocity over step instead of first order quaternion derivative */
+	UPROPERTY(BlueprintReadWrite)
+	bool bExponentialMapRotation = false;
 	
 	FSimpleMatrix3 GetInertiaTensorInverted() const
 	{
@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Aerodynamics/AirDrag.h"
+#include "PhysConstrains.h"
+#include "PhysEnums.h"
+#include "SimpleMatrix3.h"
+
+struct FPhysRigidBodyParams;
+
+/*
+ * Values of FPhysRigidBodyParams that integration step reads, derived once when params change.
+ * Self-contained copy: AirDrag shares only immutable coefficient table, so block may be handed to worker threads
+ * and outlive source params.
+ */
+struct PHYSICSCALCULATION_API FPhysSimParams
+{
+    // zero when gravity is disabled
+    FVector Gravity = FVector::ZeroVector;
+    float Mass = 1.0f;
+    float MassInv = 1.0f;
+    float Radius = 0.0f;
+    float CrossSectionArea = 0.0f;
+    FSimpleMatrix3 InertiaInv;
+
+    FAirDrag AirDrag;
+    bool bDrag = false;
+    bool bMagnus = false;
+    // drag force is -DragFactor * drag coefficient * |V| * V
+    float DragFactor = 0.0f;
+    // lift force is LiftFactor * lift coefficient * (V ^ W)
+    float LiftFactor = 0.0f;
+
+    bool bLinearDamping = false;
+    bool bAngularDamping = false;
+    float LinearDamping = 0.0f;
+    float AngularDamping = 0.0f;
+
+    FPhysConstrains Constrains;
+    FClampLimit MaxRenderAngularVelocity;
+    
+    EPhysIntegrator Integrator = SemiImplicitEuler;
+    bool bExponentialMapRotation = false;
+
+public:
+    FPhysSimParams() = default;
+    explicit FPhysSimParams(const FPhysRigidBodyParams& P) {Build(P);}
+    
+    void Build(const FPhysRigidBodyParams& P);
+    bool HasAerodynamics() const {return bDrag || bMagnus;}
+};
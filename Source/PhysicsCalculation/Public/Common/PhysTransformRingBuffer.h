@@ -0,0 +1,109 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "PhysTransform.h"
+#include "PhysTransformRingBuffer.generated.h"
+
+/*
+ * Fixed capacity circular storage for predicted transforms.
+ * Index 0 is the oldest transform; removing from front and adding to back never moves stored items.
+ * Capacity grows (with linearization) only if more items than reserved are added.
+ */
+USTRUCT(BlueprintType)
+struct FPhysTransformRingBuffer
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FPhysTransform> Data = {};
+
+    UPROPERTY()
+    int Head = 0;
+
+    UPROPERTY()
+    int Count = 0;
+
+public:
+    void Reset(int Capacity)
+    {
+        Capacity = FMath::Max(Capacity, 1);
+        if(Data.Num() != Capacity) Data.SetNum(Capacity);
+        Head = 0;
+        Count = 0;
+    }
+    
+    void Empty()
+    {
+        Data.Empty();
+        Head = 0;
+        Count = 0;
+    }
+
+    void Add(const FPhysTransform& T)
+    {
+        if(Count == GetCapacity()) Grow();
+        Data[GetStorageIndex(Count)] = T;
+        Count++;
+    }
+
+    void RemoveFromFront(int NumToRemove)
+    {
+        NumToRemove = FMath::Clamp(NumToRemove, 0, Count);
+        if(NumToRemove == 0) return;
+        Head = GetStorageIndex(NumToRemove);
+        Count -= NumToRemove;
+        if(Count == 0) Head = 0;
+    }
+
+public:
+    int Num() const {return Count;}
+    int GetCapacity() const {return Data.Num();}
+    bool IsEmpty() const {return Count == 0;}
+    bool IsValidIndex(int Index) const {return Index >= 0 && Index < Count;}
+
+    FPhysTransform& operator[](int Index)
+    {
+        check(IsValidIndex(Index))
+        return Data[GetStorageIndex(Index)];
+    }
+    const FPhysTransform& operator[](int Index) const
+    {
+        check(IsValidIndex(Index))
+        return Data[GetStorageIndex(Index)];
+    }
+
+    FPhysTransform* GetFirstPtr() {return IsEmpty() ? nullptr : &(*this)[0];}
+    FPhysTransform* GetLastPtr() {return IsEmpty() ? nullptr : &(*this)[Count - 1];}
+
+    // returns First if Index <= 0; Last if Index >= Num
+    FPhysTransform* GetPtrInBounds(int Index)
+    {
+        if(IsEmpty()) return nullptr;
+        return &(*this)[FMath::Clamp(Index, 0, Count - 1)];
+    }
+
+    TArray<FPhysTransform> ToArray() const
+    {
+        TArray<FPhysTransform> Out;
+        Out.Reserve(Count);
+        for (int i = 0; i < Count; ++i) Out.Add((*this)[i]);
+        return Out;
+    }
+
+private:
+    int GetStorageIndex(int Index) const
+    {
+        const int Capacity = GetCapacity();
+        const int StorageIndex = Head + Index;
+        return StorageIndex < Capacity ? StorageIndex : StorageIndex - Capacity;
+    }
+
+    void Grow()
+    {
+        TArray<FPhysTransform> NewData;
+        NewData.SetNum(FMath::Max(GetCapacity() * 2, 1));
+        for (int i = 0; i < Count; ++i) NewData[i] = (*this)[i];
+        Data = MoveTemp(NewData);
+        Head = 0;
+    }
+};
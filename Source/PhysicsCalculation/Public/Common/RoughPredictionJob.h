@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AdaptiveStepSettings.h"
+#include "PhysRigidBodyParams.h"
+#include "PhysSimParams.h"
+#include "PhysTransform.h"
+#include "PhysTransformRingBuffer.h"
+#include "Collision/ContactSolver.h"
+#include "Collision/PredictionStep.h"
+#include "HAL/ThreadSafeBool.h"
+
+/*
+ * Immutable input of rough prediction; made on game thread, contains no UObject access.
+ * Predicted body is its base, colliders all have valid snapshots.
+ */
+struct FRoughPredictionInput : FPredictionBody
+{
+    FPhysTransform StartTransform;
+    FPhysRigidBodyParams RbParams;
+    float SimStep = 0.0f;
+    int NumSteps = 0;
+    FAdaptiveStepSettings AdaptiveStep;
+
+    TArray<FPredictionCollider> Colliders;
+
+    // rolling on resting horizontal collider with GroundRoll table is sampled from table instead of stepped
+    // cm/sec; faster vertical motion on ground is bounce, which is stepped
+    float GroundRollMaxVerticalSpeed = 20.0f;
+};
+
+/*
+ * Rough prediction computed in background; Result is owned by worker until bCompleted is set
+ */
+struct PHYSICSCALCULATION_API FRoughPredictionJob
+{
+    FRoughPredictionInput Input;
+    FPhysTransformRingBuffer Result;
+    FThreadSafeBool bCompleted = false;
+    // reused by every step; keeps impulses between steps for warm start
+    FContactSolver Solver;
+
+public:
+    bool IsCompleted() const {return bCompleted;}
+    
+    void Run();
+    // result is still sampled every SimStep
+    void RunAdaptive();
+
+    /*
+     * Adds samples of rolling on ground from its GroundRoll table until MaxSamples, contact with other collider or ground edge.
+     * Returns number of added samples; zero if body is not rolling on resting horizontal collider.
+     */
+    static int AddGroundRollSamples(const FRoughPredictionInput& In, int MaxSamples, FPhysTransform& InOutT, FPhysTransformRingBuffer& Out);
+    static bool FindRollingGround(const FRoughPredictionInput& In, const FPhysTransform& T, int& OutGroundIndex, float& OutGroundZ);
+    // FPredictionStep::Simulate of In.SimStep among In.Colliders; Solver is caller owned and kept between steps of one simulation
+    static void SimulateStep(const FRoughPredictionInput& In, const FPhysSimParams& SimParams, const FPhysTransform& T, FContactSolver& Solver, FPhysTransform& OutT)
+    {
+        FPredictionStep::Simulate(In, SimParams, In.Colliders, In.SimStep, T, Solver, OutT);
+    }
+};
+
+/*
+ * Ground roll table built in background; Result is owned by worker until bCompleted is set
+ */
+struct FGroundRollBuildJob
+{
+    FPhysRigidBodyParams RbParams;
+    float SimStep = 0.0f;
+    // combined from ball and ground
+    float Friction = 0.0f;
+    float Restitution = 0.0f;
+    int ContactSolverIterations = 0;
+    bool bContactSolverWarmStart = false;
+    uint32 Signature = 0;
+
+    TSharedPtr<FBallGroundMovementData, ESPMode::ThreadSafe> Result;
+    FThreadSafeBool bCompleted = false;
+
+public:
+    bool IsCompleted() const {return bCompleted;}
+    void Run();
+};
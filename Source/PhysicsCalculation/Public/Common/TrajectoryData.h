@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "IndexedTrajectory.h"
 #include "PhysTransform.h"
 #include "HMStructs/CustomVectorCurve.h"
 #include "TrajectoryData.generated.h"
@@ -22,20 +23,24 @@ struct FTrajectoryData
     UPROPERTY(BlueprintReadOnly)
     FRuntimeFloatCurve DistanceToTarget;
 
+    // same keys as Trajectory; built only when time step of keys is known
+    FIndexedTrajectory Index;
+
 public:
-    void Init(const FPhysTransform& T, const FCustomVectorCurve& trajectory, FVector target)
+    void Init(const FPhysTransform& T, const FCustomVectorCurve& trajectory, FVector target, float TimeStep = 0.0f)
     {
         SetTransform(T);
         SetTarget(target);
-        SetTrajectory(trajectory, true);
+        SetTrajectory(trajectory, true, TimeStep);
     }
     
 public:
     void SetTarget(FVector V){Target = V;}
     void SetTransform(const FPhysTransform& T) { TOrigin = T;}
-    void SetTrajectory(const FCustomVectorCurve& T, bool bCalculateDistance)
+    void SetTrajectory(const FCustomVectorCurve& T, bool bCalculateDistance, float TimeStep = 0.0f)
     {
         Trajectory = T;
+        Index = TimeStep > 0.0f ? FIndexedTrajectory(Trajectory.GetVectorKeys(), TimeStep) : FIndexedTrajectory();
         if(bCalculateDistance)
         {
             DistanceToTarget = Trajectory.GetDistanceToVector(Target);
@@ -52,16 +57,19 @@ public:
 
     FVector GetVectorOfMinDistance() const
     {
+        if(HasIndex()) return Index.GetClosestLocation(Target);
         const float Time = GetTimeOfMinDistance();
         return Trajectory.GetVectorValue(Time);
     }
     TArray<FVector> GetTrajectoryPoints() const {return Trajectory.GetVectorKeys();}
+    bool HasIndex() const {return !Index.IsEmpty();}
     
 public:
 
     void RotateByQuat(const FQuat& QLinear, const FQuat& QAngular)
     {
         Trajectory.RotateByQuat(QLinear);
+        Index.RotateByQuat(QLinear);
         TOrigin.RotateLinearVelocity(QLinear);
         TOrigin.RotateAngularVelocity(QAngular);
         DistanceToTarget = Trajectory.GetDistanceToVector(Target);
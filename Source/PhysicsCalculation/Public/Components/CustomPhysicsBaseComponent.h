@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Collision/CollisionShapeSnapshot.h"
 #include "Common/PhysEnums.h"
 #include "Common/SimpleMatrix3.h"
 #include "Components/ActorComponent.h"
@@ -24,8 +25,11 @@ protected:
 
 	UPROPERTY()
 	UPrimitiveComponent* PrimitiveComponent;
+
+	FCollisionShapeSnapshot CollisionSnapshot;
 		
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void SetDefaultPrimitiveComponent();
 	
 public:
@@ -62,6 +66,9 @@ public:
 	UFUNCTION(BlueprintPure)
 	UPrimitiveComponent* GetPrimitiveComponent() const {return PrimitiveComponent;}
 
+	void UpdateCollisionSnapshot() {CollisionSnapshot.Update(PrimitiveComponent);}
+	const FCollisionShapeSnapshot& GetCollisionSnapshot() const {return CollisionSnapshot;}
+
 	UFUNCTION(BlueprintCallable)
 	void SetUsedForAdvancedPhysicsComputation(bool B){bUsedForAdvancedComputation = B;}
 	UFUNCTION(BlueprintPure)
@@ -4,9 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "CustomPhysicsBaseComponent.h"
+#include "Collision/PredictionContacts.h"
 #include "Common/PhysPredict.h"
 #include "Common/PhysRigidBodyParams.h"
+#include "Common/PhysSimParams.h"
 #include "HMStructs/CustomVectorCurve.h"
+#include "ImpulseDistribution/ImpulseReconstructed.h"
 #include "Kick/KickImpulseDataStruct.h"
 #include "CustomPhysicsComponent.generated.h"
 
@@ -53,6 +56,10 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	UPhysPredictSettings_DataAsset* PhysicsPredictSettings;
+
+	// kicks made by this ball so far; source of kick seeds
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumKicks = 0;
 	
 public:
 	FPhysTransform CurrentTransform;
@@ -63,9 +70,23 @@ public:
 	bool IsCustomPhysicsEnabled() const {return bSimulatePhysics;}
 	virtual void Initialize() override;
 
+	// must be called after PhysicsParams are changed directly
+	void UpdateSimParams() {SimParams.Build(PhysicsParams);}
+	// rebuilds air drag table if curve was replaced or edited in place; sim params and prediction are updated after rebuild.
+	// call after editing keys of assigned curve at runtime, table is not checked per tick
+	UFUNCTION(BlueprintCallable)
+	void UpdateAerodynamicsTables();
+	UFUNCTION(BlueprintCallable)
+	void SetAirDragCurve(UCurveVector* Curve, bool bRecomputePredict=true);
+	const FPhysSimParams& GetSimParams() const {return SimParams;}
+
 	virtual float GetMass() const override;
 	virtual FSimpleMatrix3 GetInertiaTensorInverted() override;
 	
+protected:
+	// derived from PhysicsParams; read by every integration step
+	FPhysSimParams SimParams;
+	
 protected:
 	void CompletePhysRigidBodyParams();
 	void RebuildPhysicsRepresentation();
@@ -94,6 +115,16 @@ public:
 	UFUNCTION(BlueprintPure)
 	float GetCurrentSideForceVelocityAlpha() const;
 
+	// seed of next kick made from kick counter; same for same kick order of the same ball
+	UFUNCTION(BlueprintCallable)
+	int32 MakeNextKickSeed();
+	// knuckling sequence of a kick starts from its first step
+	UFUNCTION(BlueprintCallable)
+	void StartSideforceSequence(int32 Seed, bool bRecomputePredict=true);
+	// impulse of kick with its knuckling sequence; replaying stored kick gives the same path
+	UFUNCTION(BlueprintCallable)
+	void ApplyKick(const FImpulseReconstructed& Kick, bool bRecomputePredict=true);
+
 public:
 	bool IsPredictionEnabled() const {return  PhysicsPredict.IsEnabled();}
 	bool IsPredictionRecomputeRequired(const FPhysTransform& TRequired, const FPhysTransform& TPredicted) const;
@@ -129,8 +160,17 @@ public:
 	void SetVelocity(FVector LinearVelocity=FVector::ZeroVector, FVector AngularVelocity=FVector::ZeroVector, bool bRecomputePredict=true);
 	void RemoveVelocity(bool bRecomputePredict=true);
 
+	/*
+	 * Recompute is deferred while PhysicsPredict.Settings.bDeferredRecompute is set:
+	 * all requests made within a frame are executed once by the processor tick or by the first prediction read.
+	 */
 	UFUNCTION(BlueprintCallable)
 	void RecomputePrediction(bool bRecompute=true);
+	UFUNCTION(BlueprintCallable)
+	void FlushPredictionRecompute();
+
+	UFUNCTION(BlueprintPure)
+	FPredictionRecomputeStats GetPredictionRecomputeStats() const {return PhysicsPredict.GetRecomputeStats();}
 
 	virtual void AddImpulse(FVector V, bool bRecomputePredict=true) override;
 	virtual void AddImpulseAtLocation(const FVector Impulse, const FVector ApplyLocation, bool bRecomputePredict=true) override;
@@ -145,8 +185,9 @@ public:
 
 public:
 
-	FPhysTransform CalculateNextPreciseTransform(const FPhysTransform& CurrentT, float SkipTime, bool bCheckCollisions=true);
-	FPhysTransform CalculateNextRoughTransform(const FPhysTransform& CurrentT, float SimStep, float SkipTime, bool bCheckCollisions=true);
+	// Contacts belong to predicted sequence the step is part of
+	FPhysTransform CalculateNextPreciseTransform(const FPhysTransform& CurrentT, float SkipTime, FPhysPredictionContacts& Contacts, bool bCheckCollisions=true);
+	FPhysTransform CalculateNextRoughTransform(const FPhysTransform& CurrentT, float SimStep, float SkipTime, FPhysPredictionContacts& Contacts, bool bCheckCollisions=true);
 	
 	UFUNCTION(BlueprintCallable)
 	FVector GetPredictedLocationAfterTime(float Time);
@@ -168,13 +209,23 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void SetPhysParams(FPhysRigidBodyParams P);
 
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
 	UFUNCTION(BlueprintCallable)
 	TArray<FVector> GetPredictedLocations(int SkipStep = 0);
 
 	UFUNCTION(BlueprintCallable)
-	FTrajectory GetTrajectory(){return PhysicsPredict.GetTrajectory();}
+	FTrajectory GetTrajectory(){FlushPredictionRecompute(); return PhysicsPredict.GetTrajectory();}
 	UFUNCTION(BlueprintCallable)
-	FCustomVectorCurve GetTrajectoryCurve(){return PhysicsPredict.GetTrajectoryCurve();}
+	FCustomVectorCurve GetTrajectoryCurve(){FlushPredictionRecompute(); return PhysicsPredict.GetTrajectoryCurve();}
+
+	// copies of prediction ring buffers, oldest transform first
+	UFUNCTION(BlueprintPure)
+	TArray<FPhysTransform> GetPrecisePredictedTransforms() const {return PhysicsPredict.GetPrecisePredictedTransforms();}
+	UFUNCTION(BlueprintPure)
+	TArray<FPhysTransform> GetRoughPredictedTransforms() const {return PhysicsPredict.GetRoughPredictedTransforms();}
 
 	UFUNCTION(BlueprintPure)
 	float GetRoughPredictSimStep() const;
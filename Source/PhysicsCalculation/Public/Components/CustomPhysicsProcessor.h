@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Components/CustomPhysicsProcessorBase.h"
+#include "PhysicsCache/BallLaunchCacheBuildJob.h"
+#include "PhysicsCache/BallLaunchCacheBuildProgress.h"
 #include "PhysicsCache/PhysCachedTrajectory.h"
 #include "CustomPhysicsProcessor.generated.h"
 
@@ -16,8 +18,15 @@ class PHYSICSCALCULATION_API UCustomPhysicsProcessor : public UCustomPhysicsProc
 {
 	GENERATED_BODY()
 
+protected:
+    FBallLaunchCacheBuildProgress SpinCacheBuildProgress;
+    TSharedPtr<FBallLaunchCacheBuildJob, ESPMode::ThreadSafe> SpinCacheBuildJob;
+
 protected:
     virtual void OnSecondTick() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    // saves finished spin cache build; cancelled one is dropped
+    void PollSpinMovementCacheBuild();
     TArray<UCustomPhysicsBaseComponent*> GetObjectsEnabledForCacheComputations(const TArray<UCustomPhysicsBaseComponent*>& ExcludedObjects);
         
 public:
@@ -25,7 +34,16 @@ public:
     void CalculatePhysicsCacheTrajectories(UAdvancedPhysicsComponent* Target);
     static void RecalculateParabolicMotionCache(UAdvancedPhysicsComponent* Target);
     static void RecalculateImpulseDistributionCache(UAdvancedPhysicsComponent* Target);
-    static void RecalculateSpinMovementCache(UAdvancedPhysicsComponent* Target);
+    // starts async build; ignored while previous build is running
+    void RecalculateSpinMovementCache(UAdvancedPhysicsComponent* Target);
+    bool IsSpinMovementCacheComputationInProgress() const {return SpinCacheBuildJob.IsValid();}
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    UFUNCTION(BlueprintCallable)
+    void CancelSpinMovementCacheComputation() {SpinCacheBuildProgress.Cancel();}
+    UFUNCTION(BlueprintPure)
+    float GetSpinMovementCacheComputationProgress() const {return SpinCacheBuildProgress.GetRatio();}
 
     FPhysCachedTrajectoryFull CalculateCachedTrajectory(UAdvancedPhysicsComponent* Target, const FDetailedVector& LinearVelocity,
                                                         const FDetailedVector& AngularVelocity);
@@ -4,7 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "constants.h"
+#include "Collision/CollisionBroadphase.h"
+#include "Collision/CollisionPair.h"
+#include "Collision/ContactSolver.h"
+#include "Collision/PredictionContacts.h"
 #include "Common/FirstTickCheck.h"
+#include "Common/PhysPredict.h"
 #include "Common/PhysTransform.h"
 #include "Common/PSI_Data.h"
 #include "Components/ActorComponent.h"
@@ -15,12 +20,26 @@ class UAdvancedPhysicsComponent;
 class UCustomPhysicsBaseComponent;
 class UCustomPhysicsComponent;
 
+// per substep buffers; reset every substep but keep their allocations
+struct FPhysIterationScratch
+{
+	TArray<FPhysTransform> PredictionTransforms;
+	TArray<FCollisionPair> CollisionPairs;
+	TArray<int> BroadphaseCandidates;
+	TArray<UCustomPhysicsBaseComponent*> SweepObjects;
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return PredictionTransforms.GetAllocatedSize() + CollisionPairs.GetAllocatedSize() + BroadphaseCandidates.GetAllocatedSize() +
+			SweepObjects.GetAllocatedSize();
+	}
+};
+
 /*
  * Resolves and manages custom physics interactions;
  * 
  * At this moment we don't plan to have more than one active object with custom physics and many static objects, so
- * simple collision resolving system is enough.
- * In the future quadtree system can be implemented.
+ * simple collision resolving system is enough; static objects are filtered by uniform grid broadphase.
  */
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class PHYSICSCALCULATION_API UCustomPhysicsProcessorBase : public UActorComponent
@@ -43,6 +62,31 @@ protected:
 
 protected:	
 	float SimulationDeltaTime = PHYS_SIM_DT;
+
+	FCollisionBroadphase Broadphase;
+
+	// subscribed objects split by simulation mode; rebuilt only when membership or mode of any object is changed
+	TArray<UCustomPhysicsComponent*> ActiveFullObjects;
+	TArray<UCustomPhysicsBaseComponent*> ActiveSimplifiedObjects;
+	bool bPhysObjArraysDirty = true;
+
+	FPhysIterationScratch Scratch;
+	// keeps impulses of live contacts between substeps for warm start
+	FContactSolver ContactSolver;
+	// substeps which had to grow scratch or contact solver buffers; expected to stop changing after first ticks
+	int32 NumScratchReallocations = 0;
+
+public:
+	// cm; should be comparable with size of typical static collider
+	UPROPERTY(EditAnywhere)
+	float BroadphaseCellSize = 200.0f;
+
+	// contacts of a substep are resolved together with this many solver iterations; 0 - one by one in detection order
+	UPROPERTY(EditAnywhere)
+	int ContactSolverIterations = 8;
+
+	UPROPERTY(EditAnywhere)
+	bool bContactSolverWarmStart = true;
 	
 public:	
 	float GetSimDT() const {return  SimulationDeltaTime;}
@@ -55,20 +99,26 @@ public:
 	FPSI_Data MakeDefaultDataForPhysicsIteration(UCustomPhysicsComponent* Obj) const;
 	
 protected:
-	void GetPhysObjArrays(TArray<UCustomPhysicsComponent*> &FullObjects, TArray<UCustomPhysicsBaseComponent*> &SimplifiedObjects);
+	void UpdatePhysObjArrays();
 
-	void UpdateCustomPhysics(float DeltaTime, const TArray<UCustomPhysicsComponent*> &FullObjects, const TArray<UCustomPhysicsBaseComponent*> &SimplifiedObjects) const;
+	void UpdateCustomPhysics(float DeltaTime, const TArray<UCustomPhysicsComponent*> &FullObjects, const TArray<UCustomPhysicsBaseComponent*> &SimplifiedObjects);
 	void UpdateTransformLock(const UCustomPhysicsComponent* Obj, FPhysTransform& InOutT, FVector PrevLocation, FQuat PrevOrientation) const;
-	void ProcessPhysicsIteration(const TArray<UCustomPhysicsComponent*> &FullObjects, const TArray<UCustomPhysicsBaseComponent*> &SimplifiedObjects, float DeltaTime) const;
+	void ProcessPhysicsIteration(const TArray<UCustomPhysicsComponent*> &FullObjects, const TArray<UCustomPhysicsBaseComponent*> &SimplifiedObjects, float DeltaTime);
 
 	static FPhysTransform CalculateNextTransformTimeBased(FPSI_Data& Data);
+
+	// executes prediction recomputes requested since previous call; one per object at most
+	void FlushPredictionRecomputes() const;
 	
 	float SplitTimeToSubstepsAndFraction(float Value, int& NumSteps) const;
 	float GetSimulationRationalTimeFullStep(float Time) const;
 
 public:
-	void PredictTransform(const TArray<UCustomPhysicsBaseComponent*>& StaticBodies, FPSI_Data& Data, FPhysTransform& OutT) const;
-	void PredictTransformAnyTime(FPSI_Data& Data, FPhysTransform& OutT) const;
+	// Contacts belong to predicted sequence of caller and carry its contact solver state between steps
+	void PredictTransform(const TArray<UCustomPhysicsBaseComponent*>& StaticBodies, FPSI_Data& Data, FPhysPredictionContacts& Contacts, FPhysTransform& OutT) const;
+	void PredictTransformAnyTime(FPSI_Data& Data, FPhysPredictionContacts& Contacts, FPhysTransform& OutT) const;
+	// warm start of predicted sequence which starts from current state of objects
+	const TArray<FContactSolverCachedImpulse>& GetLiveContactCache() const {return ContactSolver.Cache;}
 	
 public:	
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -83,5 +133,17 @@ public:
 
 	UFUNCTION()
 	void SubscribeNewObject(UCustomPhysicsBaseComponent* Obj);
+	UFUNCTION()
+	void UnsubscribeObject(UCustomPhysicsBaseComponent* Obj);
+
+	// should be called when object is switched between full and simplified simulation
+	void MarkPhysObjArraysDirty() {bPhysObjArraysDirty = true;}
+
+	UFUNCTION(BlueprintPure)
+	int32 GetScratchReallocationCount() const {return NumScratchReallocations;}
+
+	// summed over all registered objects
+	UFUNCTION(BlueprintPure)
+	FPredictionRecomputeStats GetPredictionRecomputeStats() const;
 
 };
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Aerodynamics/BodyAerodynamics.h"
 #include "Common/PhysConstrains.h"
+#include "Common/PhysEnums.h"
 #include "Common/VelocityDamping.h"
 #include "Engine/DataAsset.h"
 #include "Libs/InertiaLib.h"
@@ -53,6 +54,12 @@ public:
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Params)
 	FPhysRendering Rendering;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Integration)
+	TEnumAsByte<EPhysIntegrator> Integrator = SemiImplicitEuler;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Integration)
+	bool bExponentialMapRotation = false;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Override Defaults")
 	FDefaultPhysicsParams DefaultOverride;
@@ -47,6 +47,9 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly)
     float MultiplierChangeStep = 0.05f;
 
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    int MaxSolverIterations = 24;
+
 public:
     TArray<FVector> GetLaunchLocations(float OffsetZ) const;
     TArray<int> GetLaunchAngles() const;
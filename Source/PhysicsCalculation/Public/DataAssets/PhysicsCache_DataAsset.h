@@ -10,6 +10,8 @@
 #include "PhysicsCache/BallLaunchCache.h"
 #include "PhysicsCache_DataAsset.generated.h"
 
+struct FSpinMovementParams;
+
 /**
  * 
  */
@@ -36,9 +38,33 @@ public:
 
     UPROPERTY(BlueprintReadOnly)
     UBallLaunchCache* BallLaunchCache = nullptr;
+
+    /*
+     * Binary ball launch cache (see FBallLaunchCacheBinary); relative path starts from project content dir.
+     * When set, spin cache is saved there instead of BallLaunchCache_Data and loaded directly into BallLaunchCache.
+     */
+    UPROPERTY(EditAnywhere)
+    FString BallLaunchCacheFile;
+
+    // launch speeds in one independently loadable chunk of BallLaunchCacheFile; applied when file is saved
+    UPROPERTY(EditAnywhere, meta=(ClampMin=1))
+    int BallLaunchCacheSpeedsPerChunk = 1;
+
+    /*
+     * Keep only chunks used by kick queries in memory (see FBallLaunchCacheResidency).
+     * Least recently used chunks are evicted above budget; zero budget keeps every chunk that was read.
+     */
+    UPROPERTY(EditAnywhere)
+    bool bStreamBallLaunchCache = false;
+
+    UPROPERTY(EditAnywhere, meta=(ClampMin=0, EditCondition="bStreamBallLaunchCache"))
+    int BallLaunchCacheMemoryBudgetMB = 0;
     
 public:
     void Refresh();
+    bool HasBallLaunchCacheFile() const {return !BallLaunchCacheFile.IsEmpty();}
+    FString GetBallLaunchCacheFilePath() const;
+    bool SaveBallLaunchCacheFile(const FBallLaunchCache_Data& Data, const FSpinMovementParams& Params) const;
     void MakeImpulseDistributionCacheObj();
     void MakeParabolicMotionCacheObj();
     void MakeSpinMovementCacheObj();
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Common/AdaptiveStepSettings.h"
 #include "Engine/DataAsset.h"
 #include "HMStructs/FloatMinMaxDelta.h"
 #include "PhysicsCache/BallLaunchParamsItem.h"
@@ -31,6 +32,12 @@ public:
     float SimulationStep = 0.015f;
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=SimulationParams)
     float SimulationTimeSec = 20.0f;
+    // grid cells are split between worker threads; result is the same as in single thread mode
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=SimulationParams)
+    bool bParallelComputation = true;
+    // flight is integrated with error controlled steps; SimulationStep stays as trajectory sampling step
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=SimulationParams)
+    FAdaptiveStepSettings AdaptiveStep;
     
     // Speed in KMpH;
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Params)
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Stateless random numbers: value is a hash of (seed, stream, step index),
+ * so any step can be evaluated directly without generating previous ones.
+ */
+struct FCounterBasedRandom
+{
+    static uint32 GetUInt(uint32 Seed, uint32 Stream, int64 Index)
+    {
+        // splitmix64 finalizer
+        uint64 X = static_cast<uint64>(Index) + 0x9E3779B97F4A7C15ull * (static_cast<uint64>(Seed) << 32 | Stream);
+        X = (X ^ (X >> 30)) * 0xBF58476D1CE4E5B9ull;
+        X = (X ^ (X >> 27)) * 0x94D049BB133111EBull;
+        X = X ^ (X >> 31);
+        return static_cast<uint32>(X >> 32);
+    }
+
+    // [0; 1)
+    static float GetFraction(uint32 Seed, uint32 Stream, int64 Index)
+    {
+        return (GetUInt(Seed, Stream, Index) >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // [-Range; Range)
+    static float GetRangePlusMinus(float Range, uint32 Seed, uint32 Stream, int64 Index)
+    {
+        return Range * (2.0f * GetFraction(Seed, Stream, Index) - 1.0f);
+    }
+};
@@ -24,6 +24,13 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly)
     float SimulationLengthSec = 0.0f;
 
+    // same seed gives same sequence in live simulation, prediction and replay
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    int32 Seed = 0;
+
+    // number of update steps done since Init
+    UPROPERTY(BlueprintReadOnly)
+    int64 StepIndex = 0;
     
 public:
     virtual ~FGeneratorTimeBased() = default;
@@ -40,8 +47,21 @@ public:
     {
         UUtilsLib::UpdateTimeBasedGenerator(*this, DeltaTime);
     }
+
+    void SetSeed(int32 V){Seed = V;}
+    int64 GetStepIndex() const {return StepIndex;}
     
 public:
-    virtual void UpdateOneStep(){}
-    virtual void Init(){}
+    virtual void UpdateOneStep(){StepIndex++;}
+    virtual void AdvanceSteps(int NumSteps)
+    {
+        for (int i = 0; i < NumSteps; ++i) UpdateOneStep();
+    }
+    virtual void Init(){StepIndex = 0;}
+    // sequence of its own, e.g. one per kick
+    void Init(int32 InSeed)
+    {
+        SetSeed(InSeed);
+        Init();
+    }
 };
\ No newline at end of file
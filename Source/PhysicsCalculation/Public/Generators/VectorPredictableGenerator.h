@@ -2,61 +2,51 @@
 
 #include "CoreMinimal.h"
 #include "GeneratorTimeBased.h"
+#include "CounterBasedRandom.h"
 #include "HandyMathLibrary.h"
-#include "NativeLib.h"
 #include "VectorPredictableGenerator.generated.h"
 
+/*
+ * Vector for any step is computed directly from seed and step index,
+ * so there is no history to keep and skipping steps costs nothing
+ */
 USTRUCT(BlueprintType)
 struct FVectorPredictableGenerator : public FGeneratorTimeBased
 {
     GENERATED_BODY()
 
 public:
-
-    UPROPERTY(BlueprintReadOnly)
-    TArray<FVector> PredictionArray;
-
-public:
-    bool HasData() const {return PredictionArray.Num() > 0;}
-    bool HasNotLessStepsThan(int NumSteps) const {return HasData() && PredictionArray.Num() >= NumSteps;}
+    bool HasData() const {return HasValidTime();}
+    bool HasNotLessStepsThan(int NumSteps) const {return HasData() && GetSimulationStepsCount() >= NumSteps;}
     
-    virtual void Init() override
-    {
-        const int StepsCount = GetSimulationStepsCount();
-        for (int i = 0; i < StepsCount; ++i)
-        {
-            PredictionArray.Add(ProduceVector());
-        }
-    }
-
-    virtual void UpdateOneStep() override
-    {
-        PredictionArray.RemoveAt(0);
-        PredictionArray.Add(ProduceVector());
-    }
+    virtual void AdvanceSteps(int NumSteps) override {StepIndex += FMath::Max(NumSteps, 0);}
     
-    virtual FVector ProduceVector()
+    virtual FVector ProduceVector(int64 Step) const
     {
         checkNoEntry()
         return {};
     }
     
-    virtual FVector ProduceRandomVector(float x, float y, float z) const
+    /*
+     * Stream separates sequences of generators sharing the same seed
+     */
+    FVector ProduceRandomVector(float x, float y, float z, int64 Step, uint32 Stream) const
     {
-        const float X = UHM::FRandRangePlusMinus(x);
-        const float Y = UHM::FRandRangePlusMinus(y);
-        const float Z = UHM::FRandRangePlusMinus(z);
+        const uint32 S = static_cast<uint32>(Seed);
+        const float X = FCounterBasedRandom::GetRangePlusMinus(x, S, Stream * 3, Step);
+        const float Y = FCounterBasedRandom::GetRangePlusMinus(y, S, Stream * 3 + 1, Step);
+        const float Z = FCounterBasedRandom::GetRangePlusMinus(z, S, Stream * 3 + 2, Step);
         return FVector(X, Y, Z);
     }
     
     FVector GetFirstPredictedVector() const
     {
-        return HasData() ? PredictionArray[0] : FVector::ZeroVector;
+        return GetProducedVectorAfterStepCount(0);
     }
 
-    FVector GetProducedVectorAfterStepCount(int N)
+    FVector GetProducedVectorAfterStepCount(int N) const
     {
-        return *Native::ArrayGetElementInBoundsSafe(N, PredictionArray, FVector::ZeroVector);
+        return HasData() && N >= 0 ? ProduceVector(StepIndex + N) : FVector::ZeroVector;
     }
 
-};
\ No newline at end of file
+};
@@ -23,4 +23,8 @@ public:
     UPROPERTY(BlueprintReadWrite)
     FVector ApplyLocation = FVector::ZeroVector;
 
+    // knuckling of ball after this kick; stored with kick, so replay reproduces it
+    UPROPERTY(BlueprintReadWrite)
+    int32 SideforceSeed = 0;
+
 };
\ No newline at end of file
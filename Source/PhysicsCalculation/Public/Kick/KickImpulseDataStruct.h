@@ -14,4 +14,6 @@ struct FKickImpulseDataStruct
     FQuat QImpulse = FQuat::Identity;
     // applied before impulse to shift body position (mostly to detach from ground)
     FVector InitialBodyLocationOffset = FVector::ZeroVector;
+    // knuckling of ball after this kick, see FImpulseReconstructed
+    int32 SideforceSeed = 0;
 };
\ No newline at end of file
@@ -0,0 +1,101 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Common/PhysicsPredictionCurveWithMeta.h"
+#include "Common/PhysRigidBodyParams.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Kick/KickCompResultTmp.h"
+#include "PhysicsCache/BallLaunchParamsItem.h"
+#include "Structs/KickCandidates.h"
+#include "Structs/KickCompData.h"
+
+class UPhysicsComponent;
+
+enum class EKickSolveStage : uint8
+{
+    LaunchParams,
+    Impacts,
+    Trajectories,
+    Done
+};
+
+/*
+ * Candidate trajectories of kick integrated in background; Curves are owned by worker until bCompleted is set
+ */
+struct FKickTrajectoryBatchJob
+{
+    FPhysRigidBodyParams RbParams;
+    FPhysCurveSpecialPrediction PredictionData;
+    TArray<FPhysTransform> Impacts;
+    TArray<FPhysicsPredictionCurveWithMeta> Curves;
+    FThreadSafeBool bCompleted = false;
+
+public:
+    bool IsCompleted() const {return bCompleted;}
+    void Run();
+};
+
+/*
+ * Resumable UKickSystemLib::KickComputePossibleImpact.
+ * Work is split into units (launch speed of one launch angle, one launch params item, one batch of trajectories),
+ * so solve can be spread over frames with time budget. Every Step does at least one unit, so job always finishes.
+ * Spin cache and component are touched only from Step; with bAsyncTrajectories the last stage runs on thread pool
+ * with a copy of component params.
+ * OnResult receives solutions found so far whenever they change and the complete result exactly once.
+ */
+class PHYSICSCALCULATION_API FKickSolveJob
+{
+public:
+    // bComplete is set only for the last call
+    using FOnResult = TFunction<void(const FKickCompResultTmp& Result, bool bComplete)>;
+
+    FKickSolveJob(UPhysicsComponent* InPC, const FKickCompData& InData, FOnResult InOnResult = nullptr);
+
+    // returns true when job is done
+    bool Step(float BudgetMicroseconds);
+    // trajectories are integrated on calling thread in one batch
+    void RunToCompletion();
+    // solutions found so far are delivered as complete result
+    void Cancel();
+
+public:
+    bool IsDone() const {return Stage == EKickSolveStage::Done;}
+    EKickSolveStage GetStage() const {return Stage;}
+    const FKickCompResultTmp& GetResult() const {return Result;}
+    int GetNumLaunchParams() const {return LaunchParamsSet.Num();}
+    int GetNumImpacts() const {return ImpactSet.Num();}
+    const FKickCandidateStats& GetStats() const {return Stats;}
+
+private:
+    void StepLaunchParams();
+    void StepImpacts();
+    void StepTrajectories();
+    void StartTrajectoryJob();
+    void PollTrajectoryJob();
+    void BeginStage(EKickSolveStage NewStage);
+    void Finish();
+    bool CanBatch() const;
+
+private:
+    TWeakObjectPtr<UPhysicsComponent> PC;
+    FKickCompData Data;
+    FOnResult OnResult;
+    EKickSolveStage Stage = EKickSolveStage::LaunchParams;
+
+    // launch params cursor; launch speed is the next one to check for current angle
+    int LaunchAngle = 0;
+    int LaunchSpeed_KMpH = 0;
+    bool bLaunchAngleStarted = false;
+    
+    // next item of current stage in LaunchParamsSet or ImpactSet
+    int NextItem = 0;
+    int TrajectoryBatchSize = 16;
+    bool bAllowTrajectoryJob = true;
+    
+    FKickLaunchParamsSet LaunchParamsSet;
+    FKickImpactSet ImpactSet;
+    FKickCandidateStats Stats;
+    FPhysCurveSpecialPrediction PredictionData;
+    FKickCompResultTmp Result;
+    TSharedPtr<FKickTrajectoryBatchJob, ESPMode::ThreadSafe> TrajectoryJob;
+};
@@ -10,6 +10,7 @@
 #include "Kick/KickSpinRange.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "PhysicsCache/BallLaunchParamsItem.h"
+#include "Structs/KickCandidates.h"
 #include "Structs/KickCompData.h"
 #include "KickSystemLib.generated.h"
 
@@ -86,10 +87,25 @@ public:
 	                                                      const FSpecialPrediction_Limits& Limits, const FSpecialPrediction_ExtraData& ExtraData);
 	static FKickCompResultTmp GetKickComputedTrajectoriesFromImpactArray(UPhysicsComponent* PC,
 	                                                                     const FSpecialPrediction_Limits& Limits, const FSpecialPrediction_ExtraData& ExtraData, const TArray<FPhysTransform>& TArray);
+	static FKickCompResultTmp GetKickComputedTrajectoriesFromImpactArrayBatched(UPhysicsComponent* PC, const FSpecialPrediction_Limits& Limits,
+	                                                                            const FSpecialPrediction_ExtraData& ExtraData, const TArray<FPhysTransform>& ImpactArray, float ValidationTolerance = 0.0f);
+	// Curves[i] belongs to ImpactArray[i]; only curves that end in Z range of ExtraData are added
+	static void AddApplicableCurves(const FSpecialPrediction_ExtraData& ExtraData, const TArray<FPhysTransform>& ImpactArray,
+	                                const TArray<FPhysicsPredictionCurveWithMeta>& Curves, FKickCompResultTmp& Out);
 	static FKickCompResultTmp RotateImpactTransformsToKickTarget(UPhysicsComponent* PC, const FKickCompResultTmp& Data, FVector KickTarget);
 
 	static TArray<FBallLaunchParams> MakeLaunchParamsArray(UPhysicsComponent* PC, const FSpinCacheIterCheckData& Data);
+	static TArray<FBallLaunchParams> MakeLaunchParamsArray(UPhysicsComponent* PC, const FSpinCacheIterCheckData& Data, FKickCandidateStats& OutStats);
+	// lower launch speeds can't reach target even without spin
+	static int GetMinLaunchSpeedForAngle_KMpH(UPhysicsComponent* PC, const FSpinCacheIterCheckData& Data, int LaunchAngle);
+	/*
+	 * Spin combinations of one launch speed and angle that can reach target by spin cache.
+	 * Slab of launch speed and angle, then every front spin row are checked against cache first, so unreachable ranges are skipped whole
+	 */
+	static void AppendLaunchParamsForSpeed(UPhysicsComponent* PC, const FSpinCacheIterCheckData& Data, int LaunchAngle, int LaunchSpeed_KMpH,
+	                                       FKickLaunchParamsSet& Out, FKickCandidateStats& Stats);
 	static TArray<FPhysTransform> CalculateApplicableImpactDataCacheBased(UPhysicsComponent* PC, const TArray<FBallLaunchParams>& Data, FVector VToTarget);
+	static void AppendApplicableImpact(UPhysicsComponent* PC, const FBallLaunchParams& LaunchParams, FVector VToTarget, FKickImpactSet& Out, FKickCandidateStats& Stats);
 
 	UFUNCTION(BlueprintPure)
 	static FPhysTransform BallLaunchParamsToImpact(UPhysicsComponent* PC, const FBallLaunchParams& P, FVector VToTarget, bool bRemoveVelocities);
@@ -0,0 +1,118 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Common/PhysTransform.h"
+#include "PhysicsCache/BallLaunchParamsItem.h"
+#include "KickCandidates.generated.h"
+
+/*
+ * Counters of kick candidate pipeline; spin combinations are counted once per stage they leave
+ */
+USTRUCT(BlueprintType)
+struct FKickCandidateStats
+{
+    GENERATED_BODY()
+
+    // spin combinations of all checked launch speeds and angles
+    UPROPERTY(BlueprintReadOnly)
+    int NumGenerated = 0;
+    // no cell of launch speed and angle slab can reach target
+    UPROPERTY(BlueprintReadOnly)
+    int NumPrunedBySlab = 0;
+    // no cell of front spin row can reach target
+    UPROPERTY(BlueprintReadOnly)
+    int NumPrunedByFrontSpin = 0;
+    // not allowed by spin movement params
+    UPROPERTY(BlueprintReadOnly)
+    int NumRejectedByParams = 0;
+    // checked against vertical ranges of their cell
+    UPROPERTY(BlueprintReadOnly)
+    int NumEvaluated = 0;
+    UPROPERTY(BlueprintReadOnly)
+    int NumLaunchParams = 0;
+    UPROPERTY(BlueprintReadOnly)
+    int NumDuplicateLaunchParams = 0;
+    
+    UPROPERTY(BlueprintReadOnly)
+    int NumImpacts = 0;
+    UPROPERTY(BlueprintReadOnly)
+    int NumDuplicateImpacts = 0;
+    
+    UPROPERTY(BlueprintReadOnly)
+    int NumTrajectories = 0;
+    UPROPERTY(BlueprintReadOnly)
+    int NumSolutions = 0;
+
+public:
+    FString ToString() const
+    {
+        return "Generated: " + FString::FromInt(NumGenerated) + " | Pruned slab/front spin: " + FString::FromInt(NumPrunedBySlab) + "/" + FString::FromInt(NumPrunedByFrontSpin) +
+               " | Rejected: " + FString::FromInt(NumRejectedByParams) + " | Evaluated: " + FString::FromInt(NumEvaluated) +
+               " | Launch params: " + FString::FromInt(NumLaunchParams) + " (dup " + FString::FromInt(NumDuplicateLaunchParams) + ")" +
+               " | Impacts: " + FString::FromInt(NumImpacts) + " (dup " + FString::FromInt(NumDuplicateImpacts) + ")" +
+               " | Trajectories: " + FString::FromInt(NumTrajectories) + " | Solutions: " + FString::FromInt(NumSolutions);
+    }
+};
+
+/*
+ * Unique launch params in insertion order.
+ * Candidates lie on integer grid (cm/sec and degrees), so rounded values are the key.
+ */
+struct FKickLaunchParamsSet
+{
+    TArray<FBallLaunchParams> Items;
+    TSet<uint64> Keys;
+
+public:
+    int Num() const {return Items.Num();}
+    bool Add(const FBallLaunchParams& P)
+    {
+        bool bAlreadyInSet = false;
+        Keys.Add(MakeKey(P), &bAlreadyInSet);
+        if(!bAlreadyInSet) Items.Add(P);
+        return !bAlreadyInSet;
+    }
+    static uint64 MakeKey(const FBallLaunchParams& P)
+    {
+        const uint64 Speed = static_cast<uint16>(FMath::RoundToInt(P.LaunchSpeed));
+        const uint64 Angle = static_cast<uint16>(FMath::RoundToInt(P.LaunchAngle));
+        const uint64 FrontSpin = static_cast<uint16>(FMath::RoundToInt(P.FrontSpinAngle));
+        const uint64 SideSpin = static_cast<uint16>(FMath::RoundToInt(P.SideSpinAngle));
+        return Speed << 48 | Angle << 32 | FrontSpin << 16 | SideSpin;
+    }
+};
+
+/*
+ * Unique impact transforms in insertion order.
+ * Quantized transform selects bucket and == resolves it; nearly equal transforms on bucket border are kept both.
+ */
+struct FKickImpactSet
+{
+    TArray<FPhysTransform> Items;
+    TMultiMap<uint32, int> Buckets;
+
+public:
+    int Num() const {return Items.Num();}
+    bool Add(const FPhysTransform& T)
+    {
+        const uint32 Hash = GetQuantizedHash(T);
+        for (auto It = Buckets.CreateConstKeyIterator(Hash); It; ++It)
+        {
+            if(Items[It.Value()] == T) return false;
+        }
+        Buckets.Add(Hash, Items.Add(T));
+        return true;
+    }
+    static uint32 GetQuantizedHash(const FPhysTransform& T)
+    {
+        constexpr float Scale = 100.0f;
+        uint32 Hash = 0;
+        for (const FVector& V : {T.Location, T.LinearVelocity, T.AngularVelocity})
+        {
+            Hash = HashCombine(Hash, GetTypeHash(FMath::RoundToInt(V.X * Scale)));
+            Hash = HashCombine(Hash, GetTypeHash(FMath::RoundToInt(V.Y * Scale)));
+            Hash = HashCombine(Hash, GetTypeHash(FMath::RoundToInt(V.Z * Scale)));
+        }
+        return Hash;
+    }
+};
@@ -90,6 +90,28 @@ struct FKickCompData
 
 	UPROPERTY(BlueprintReadWrite)
 	int LaunchSpeedDelta_Multiplier = 12;
+
+	/*
+	 * Opt-in: candidate trajectories are integrated together (see UBatchPredictionLib).
+	 * Batch path mirrors semi-implicit Euler only (it is skipped for other integrators) and its curves are not bit-identical
+	 * to scalar prediction, so found impacts may differ. Use BatchValidationTolerance to measure deviation
+	 */
+	UPROPERTY(BlueprintReadWrite)
+	bool bBatchPrediction = false;
+
+	/*
+	 * If positive - batched results are compared with scalar prediction; mismatches are logged
+	 * cm
+	 */
+	UPROPERTY(BlueprintReadWrite)
+	float BatchValidationTolerance = 0.0f;
+
+	/*
+	 * FKickSolveJob integrates candidate trajectories on thread pool instead of budgeted steps on game thread
+	 * Applies to batch prediction only; batch validation is skipped
+	 */
+	UPROPERTY(BlueprintReadWrite)
+	bool bAsyncTrajectories = false;
 	
 public:
 	UPROPERTY(BlueprintReadWrite)
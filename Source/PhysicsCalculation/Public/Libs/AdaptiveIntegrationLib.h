@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Common/AdaptiveStepSettings.h"
+#include "Common/PhysTransform.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "AdaptiveIntegrationLib.generated.h"
+
+struct FPhysSimParams;
+
+/*
+ * One accepted step of adaptive integration. Any moment inside is restored by cubic Hermite interpolation
+ * of location (by velocities) and velocity (by accelerations) - dense output.
+ */
+struct FAdaptiveFlightSegment
+{
+    float Duration = 0.0f;
+    FPhysTransform Start;
+    FPhysTransform End;
+    FVector StartAcceleration = FVector::ZeroVector;
+    FVector EndAcceleration = FVector::ZeroVector;
+
+public:
+    FPhysTransform Sample(float Time) const;
+};
+
+/**
+ * Dormand-Prince 5(4) integration of free flight (gravity, aerodynamics, damping; no collisions and extra forces).
+ * Spin is taken constant inside of step, which is true for flight without torques except damping.
+ */
+UCLASS()
+class PHYSICSCALCULATION_API UAdaptiveIntegrationLib : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	// acceleration used as derivative of velocity; includes linear damping
+	static FVector GetAcceleration(const FPhysSimParams& SimParams, const FVector& LinearVelocity, const FVector& AngularVelocity);
+	
+	// returns estimated location error of step; OutAcceleration is acceleration at the end of step
+	static float StepDormandPrince(const FPhysSimParams& SimParams, const FPhysTransform& T, const FVector& Acceleration, float DeltaTime,
+	                               FPhysTransform& OutT, FVector& OutAcceleration);
+
+	/*
+	 * Takes one step of length N * Quantum, N in [1, MaxQuanta]. Step is retried shorter while error is over tolerance;
+	 * step of single quantum is always accepted. InOutStep is proposed length of next step.
+	 * Returns N.
+	 */
+	static int AdvanceSegment(const FPhysSimParams& SimParams, const FAdaptiveStepSettings& Settings, const FPhysTransform& T, const FVector& Acceleration,
+	                          float Quantum, int MaxQuanta, float& InOutStep, FAdaptiveFlightSegment& Out, FAdaptiveStepStats* Stats = nullptr);
+
+	/*
+	 * Same layout as UCustomPhysicsComponent::PredictMovementFromTransformAnyTimeStep without collisions:
+	 * first item is T, next ones are taken every OutputStep.
+	 */
+	static TArray<FPhysTransform> SimulateWithFixedOutput(const FPhysSimParams& SimParams, const FAdaptiveStepSettings& Settings, const FPhysTransform& T,
+	                                                      float OutputStep, int NumSteps, bool bLimitZ, float LimitZ, FAdaptiveStepStats* Stats = nullptr);
+};
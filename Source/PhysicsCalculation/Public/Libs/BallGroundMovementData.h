@@ -2,12 +2,22 @@
 
 #include "CoreMinimal.h"
 #include "Common/PhysRigidBodyParams.h"
+#include "Common/PhysTransform.h"
+#include "Common/SimpleMatrix3.h"
 #include "BallGroundMovementData.generated.h"
 
+struct FRoughPredictionInput;
+
 static float ONE_FRAME_SEC_48_FPS = 1.0f/48.0f;
 
+/*
+ * Ground phase of ball on static horizontal ground without stepping.
+ * Rolling is tabulated once by the stepped model (see MakeGroundContactInput) from StartVelocity until stop or MaxTime;
+ * any rolling speed is a point of this table, so state after any time or distance is found by lookup.
+ * Sliding is closed form: contact point slip decreases linearly under kinetic friction until ball rolls.
+ */
 USTRUCT(BlueprintType)
-struct FBallGroundMovementData
+struct PHYSICSCALCULATION_API FBallGroundMovementData
 {
 	GENERATED_BODY()
 
@@ -19,20 +29,106 @@ struct FBallGroundMovementData
 	float AbsToleranceVelocitySel = 5;
 	float AbsToleranceDistanceSel = 5;
 
+	// cm/sec; rolling speeds above are clamped to it
+	UPROPERTY(BlueprintReadWrite)
+	float StartVelocity = 5000.0f;
+
+	// cm/sec; ball rolling slower is stopped
+	UPROPERTY(BlueprintReadWrite)
+	float MinVelocity = 10.0f;
+
+	// rolling after table end keeps last speed
+	UPROPERTY(BlueprintReadWrite)
+	float MaxTime = 30.0f;
+
+	// values of contact, already combined from ball and ground; stepped model gives them to both bodies
+	UPROPERTY(BlueprintReadWrite)
+	float GroundFriction = 0.5f;
+
+	UPROPERTY(BlueprintReadWrite)
+	float GroundRestitution = 0.3f;
+
+	// contact solver of stepped model, as set in physics processor; 0 iterations - contact is resolved alone
+	int ContactSolverIterations = 0;
+	bool bContactSolverWarmStart = false;
+
 	UPROPERTY(BlueprintReadOnly)
-	TArray<float> LinVelXY;
+	float Radius = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float Mass = 1.0f;
 
-	// debug
+	// absolute value
 	UPROPERTY(BlueprintReadOnly)
-	TArray<FVector> VelocityArr;
+	float Gravity = 0.0f;
+
+	// contact point slip decreases by Friction * Gravity * SlipDecelerationMul per second
+	UPROPERTY(BlueprintReadOnly)
+	float SlipDecelerationMul = 1.0f;
+
+	FSimpleMatrix3 InertiaInv;
+
+	// MakeSignature of values table was built for; zero if unknown
+	uint32 Signature = 0;
 
+	// speed at every TimeStep of table, cm/sec
+	UPROPERTY(BlueprintReadOnly)
+	TArray<float> LinVelXY;
+
+	// distance passed between neighbour items of LinVelXY
 	UPROPERTY(BlueprintReadOnly)
 	TArray<float> DistanceDeltaArr;
 
+	// distance passed from table start to every item of LinVelXY
+	UPROPERTY(BlueprintReadOnly)
+	TArray<float> DistanceArr;
+
+public:
 	float GetInitialVelocityFromEndVelocity(float EndVelocity, float Time);
 	float GetInitialVelocityDistancePassedVelocity(float DistanceToPass, float Time);
 	float GetNumSteps(float Time) const;
 
 	void Simulate(FPhysRigidBodyParams P, float Time_Step);
 	void Simulate(FPhysRigidBodyParams P);
-};
\ No newline at end of file
+
+public:
+	bool IsValid() const {return LinVelXY.Num() > 1;}
+	bool IsStopReached() const {return IsValid() && LinVelXY.Last() <= 0.0f;}
+
+	// rolling without slip
+	float GetRollSpeedAfterTime(float StartSpeed, float Time) const;
+	float GetRollDistanceAfterTime(float StartSpeed, float Time) const;
+	// negative if ball stops before distance is passed
+	float GetRollTimeToDistance(float StartSpeed, float Distance) const;
+	// distance passed until table end if ball does not stop in table
+	float GetRollStopDistance(float StartSpeed) const;
+
+	// horizontal velocity of contact point on ground
+	FVector GetContactSlip(const FPhysTransform& T) const;
+	float GetSlideTime(float SlipSpeed, float Friction) const;
+
+	/*
+	 * Ball touching horizontal ground is moved by Time: sliding while contact point slips, then rolling by table.
+	 * Aerodynamic forces are neglected while sliding. Spin around vertical axis is kept; vertical velocity is zeroed.
+	 */
+	void AdvanceOnGround(const FPhysTransform& T, float Time, float Friction, FPhysTransform& OutT) const;
+
+	/*
+	 * Table depends on params of body, step and contact solver of stepped model and contact values only;
+	 * params signature reads air drag curve keys, so it is made on game thread.
+	 */
+	static uint32 MakeParamsSignature(const FPhysRigidBodyParams& P, float DeltaTime, int ContactSolverIterations = 0, bool bContactSolverWarmStart = false);
+	static uint32 MakeSignature(uint32 ParamsSignature, float Friction, float Restitution);
+
+	// stepped model of table: body of P on static ground, which top is at Z = 0
+	static void MakeGroundContactInput(const FPhysRigidBodyParams& P, float Friction, float Restitution, float DeltaTime, FRoughPredictionInput& Out);
+
+private:
+	void AdvanceRolling(float Time, FPhysTransform& InOutT) const;
+	
+	// fractional index of table item
+	float GetIndexOfSpeed(float Speed) const;
+	float GetIndexOfDistance(float Distance) const;
+	float GetSpeedAtIndex(float Index) const;
+	float GetDistanceAtIndex(float Index) const;
+};
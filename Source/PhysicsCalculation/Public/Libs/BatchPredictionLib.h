@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Common/PhysicsPredictionCurveWithMeta.h"
+#include "Common/PhysTransform.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "BatchPredictionLib.generated.h"
+
+class UCustomPhysicsComponent;
+struct FPhysRigidBodyParams;
+
+/*
+ * Structure of arrays state of trajectories advanced in lockstep.
+ * Lanes [0, NumActive) are still simulated; retired lane is swapped behind them,
+ * so every step works on contiguous arrays.
+ */
+struct FPredictionBatchLanes
+{
+    TArray<float> PX, PY, PZ;
+    TArray<float> VX, VY, VZ;
+    TArray<float> WX, WY, WZ;
+    TArray<float> PrevX, PrevY, PrevZ;
+    TArray<float> StartX, StartY;
+    TArray<float> DragMul, MagnusMul;
+    TArray<bool> bNeedStoreOnDistance;
+    TArray<int> LaneId;
+    int NumActive = 0;
+
+public:
+    void Init(const TArray<FPhysTransform>& Transforms, bool bStoreOnDistance);
+    void Retire(int Lane);
+    FVector GetLocation(int Lane) const {return FVector(PX[Lane], PY[Lane], PZ[Lane]);}
+    FVector GetPrevLocation(int Lane) const {return FVector(PrevX[Lane], PrevY[Lane], PrevZ[Lane]);}
+    float GetDistanceFromStartXY(int Lane) const {return FMath::Sqrt(FMath::Square(PX[Lane] - StartX[Lane]) + FMath::Square(PY[Lane] - StartY[Lane]));}
+    float GetPrevDistanceFromStartXY(int Lane) const {return FMath::Sqrt(FMath::Square(PrevX[Lane] - StartX[Lane]) + FMath::Square(PrevY[Lane] - StartY[Lane]));}
+};
+
+/**
+ * Batched version of UPhysicsSimulation::CalculatePredictionCurveWithMeta.
+ * Integrates same physics as PhysicsSimulateDelta without extra forces (which is what special prediction uses).
+ * Only SemiImplicitEuler integrator is mirrored.
+ */
+UCLASS()
+class PHYSICSCALCULATION_API UBatchPredictionLib : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+    /*
+     * All transforms share time step, limits and extra data of Data; Data.T is ignored.
+     * Out[i] corresponds to Transforms[i]
+     */
+    static void CalculatePredictionCurvesWithMeta(UCustomPhysicsComponent* Obj, const FPhysCurveSpecialPrediction& Data,
+                                                  const TArray<FPhysTransform>& Transforms, TArray<FPhysicsPredictionCurveWithMeta>& Out);
+    // params are only read, so it may run on worker thread with a copy of component params
+    static void CalculatePredictionCurvesWithMeta(const FPhysRigidBodyParams& RbParams, const FPhysCurveSpecialPrediction& Data,
+                                                  const TArray<FPhysTransform>& Transforms, TArray<FPhysicsPredictionCurveWithMeta>& Out);
+
+    /*
+     * Compares batched results with scalar path; Tolerance is max allowed distance between cached locations [cm]
+     */
+    static bool ValidateAgainstScalar(UCustomPhysicsComponent* Obj, const FPhysCurveSpecialPrediction& Data, const TArray<FPhysTransform>& Transforms,
+                                      const TArray<FPhysicsPredictionCurveWithMeta>& BatchResults, float Tolerance);
+
+protected:
+    static void UpdateAerodynamicCoefficients(const FPhysRigidBodyParams& RbParams, FPredictionBatchLanes& L);
+    static void IntegrateStep(const FPhysRigidBodyParams& RbParams, float DeltaTime, FPredictionBatchLanes& L);
+};
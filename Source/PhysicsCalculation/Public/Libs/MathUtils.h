@@ -38,6 +38,8 @@ public:
     static FQuat GetDeltaRotation(const FQuat& Target, const FQuat& Initial);
 
     static void ApplyAngularVelocityToRotation(const FVector& AngularVelocity, const float DeltaTime, FQuat& InOutOrientation);
+    // exact rotation by angle |w| * dt around w; no drift in rotation speed for big steps
+    static void ApplyAngularVelocityToRotationExpMap(const FVector& AngularVelocity, const float DeltaTime, FQuat& InOutOrientation);
 
     UFUNCTION(BlueprintPure)
     static FQuat AngularVelocityToSpinFromRotator(const FRotator& Orientation, const FVector AngularVelocity);
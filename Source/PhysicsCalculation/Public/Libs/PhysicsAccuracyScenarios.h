@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "Common/PhysRigidBodyParams.h"
+#include "Common/PhysTransform.h"
+#include "Collision/ContactSolver.h"
+#include "Structs/PhysicsBenchmarkData.h"
+
+struct FAnalyticCollisionShape;
+
+/*
+ * Reference scenarios of integration, ground roll, sweep and contact solver with their accuracy measurement.
+ * Development only: used by UPhysicsBenchmarkLib and automation tests, not compiled into shipping builds.
+ */
+struct PHYSICSCALCULATION_API FPhysicsAccuracyScenarios
+{
+    /*
+     * Accuracy vs step size table: every integrator is compared with RK4 at quarter of base step.
+     * Flight is computed with given params, so all forces including magnus participate.
+     */
+    static TArray<FPhysicsIntegratorAccuracy> MeasureIntegratorAccuracy(const FPhysRigidBodyParams& RbParams, const FPhysTransform& T, float BaseDeltaTime, float Time,
+                                                                        const TArray<int>& StepMultipliers);
+    static FVector SimulateFlightLocation(const FPhysRigidBodyParams& RbParams, const FPhysTransform& T, float DeltaTime, float Time);
+
+    /*
+     * Tabulated ground movement against stepped ground contact it is built from.
+     * Reference is stepped with the same step as table, so error comes from lookup and closed form sliding only.
+     */
+    static TArray<FPhysicsGroundRollAccuracy> MeasureGroundRollAccuracy(const FPhysRigidBodyParams& RbParams, float Friction, float Restitution, float DeltaTime, float Time,
+                                                                        const TArray<float>& StartSpeeds);
+
+    /*
+     * Analytic sphere sweep against reference found by sampling closest point along the move.
+     * Cases cover face, edge and corner contacts, grazing passes and moves through thin objects at high speed.
+     */
+    static TArray<FPhysicsSweepAccuracy> MeasureSweepAccuracy(float Radius, float HighSpeedDistance, int NumReferenceSteps);
+    static bool FindReferenceTimeOfImpact(const FAnalyticCollisionShape& Shape, const FVector& Start, const FVector& Delta, float Radius, int NumSteps, float& OutAlpha);
+
+    /*
+     * Contact solver on ball pinched between post and ground, between two heavy bodies and in two ball stack resting on ground.
+     * Every scenario is solved with contacts in given and reversed order; solver state is compared after the last step.
+     */
+    static TArray<FPhysicsContactSolverAccuracy> MeasureContactSolverAccuracy(const FContactSolverBody& Ball, float Radius, float Friction, float Restitution, float DeltaTime,
+                                                                              const TArray<int>& Iterations, int NumStackSteps);
+    // contacts are used as description: bodies, point, normal and penetration
+    static void SolveContactScenario(const TArray<FContactSolverBody>& Bodies, const TArray<FContactSolverContact>& Contacts, float Friction, float Restitution,
+                                     float GravityDeltaVelocity, int NumSteps, bool bReverseOrder, FContactSolver& Solver);
+};
+
+#endif
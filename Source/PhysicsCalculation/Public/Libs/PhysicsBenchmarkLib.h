@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Common/PhysRigidBodyParams.h"
+#include "Common/PhysTransform.h"
+#include "Structs/PhysicsBenchmarkData.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "PhysicsBenchmarkLib.generated.h"
+
+class UPhysicsComponent;
+
+/**
+ * Times hot paths of simulation on object's current params; results are printed to log.
+ * Integration and prediction are measured through component free functions, so numbers are not affected by component state.
+ * Accuracy tables come from FPhysicsAccuracyScenarios and are left empty in shipping builds.
+ */
+UCLASS()
+class PHYSICSCALCULATION_API UPhysicsBenchmarkLib : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable)
+	static FPhysicsBenchmarkResult RunPhysicsBenchmark(UPhysicsComponent* PC, const FPhysicsBenchmarkSettings& Settings);
+
+	// bDeriveParamsEveryStep - step through FPhysRigidBodyParams, deriving FPhysSimParams each time (cost of not caching them)
+	static float MeasureSingleStepNs(const FPhysRigidBodyParams& RbParams, const FPhysTransform& T, float DeltaTime, int NumSteps, bool bDeriveParamsEveryStep);
+	static float MeasurePrecisePredictionMs(const FPhysRigidBodyParams& RbParams, const FPhysTransform& T, float DeltaTime, float Time, int NumRuns);
+	static float MeasureKickSolveMs(UPhysicsComponent* PC, const FKickCompData& Data, int NumRuns, FKickCandidateStats& OutStats);
+	static float MeasureCacheCellMs(UPhysicsComponent* PC, int NumCells, int& OutNumCells);
+};
@@ -38,6 +38,7 @@
 struct FPhysConstrains;
 class UCustomPhysicsBaseComponent;
 struct FPhysRigidBodyParams;
+struct FPhysSimParams;
 
 UCLASS()
 class PHYSICSCALCULATION_API UPhysicsSimulation : public UBlueprintFunctionLibrary
@@ -61,9 +62,20 @@ public:
 	static FVector DeltaLocationToForce(FVector DeltaLocation, float Mass, float DeltaTime);
 	static FPhysTransform PhysicsSimulateDelta(FPSI_Data& Data);
 	static void PhysicsSimulateDelta(FPSI_Data& Data, FPhysTransform& OutT);
-	static void UpdateTransformOrientation(const FPhysRigidBodyParams& RbParams, float DeltaTime, FPhysTransform& InOutT);
+	// no extra forces, no component access; safe to call from worker threads. Build SimParams once per prediction run
+	static void PhysicsSimulateDelta(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& InOutT);
+	static void UpdateTransformOrientation(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& InOutT);
+
+	/*
+	 * Gravity and aerodynamic forces over one step by RbParams.Integrator, followed by damping and constrains.
+	 * AngularVelocityDelta is added after forces are sampled (sideforce impact), as it was applied before integrators existed.
+	 */
+	static void IntegrateLinearMotion(const FPhysSimParams& SimParams, float DeltaTime, const FVector& AngularVelocityDelta, FPhysTransform& InOutT);
+	static FVector GetLinearAcceleration(const FPhysSimParams& SimParams, const FVector& LinearVelocity, const FVector& AngularVelocity);
+	static void IntegrateVelocityVerlet(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& InOutT);
+	static void IntegrateRungeKutta4(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& InOutT);
 	static void ApplyConstrains(const FPhysConstrains& Constrains, FPhysTransform& InOutT);
-	static void ApplyVelocityDamping(const FPhysRigidBodyParams& RbParams, float DeltaTime, FPhysTransform& OutT);
+	static void ApplyVelocityDamping(const FPhysSimParams& SimParams, float DeltaTime, FPhysTransform& OutT);
 
 	static void SimulateAddImpulseFromForce(FVector &InOutLinearVelocity, const FVector &Force, float DeltaTime, float Mass);
 	static void SimulateAddTorqueFromForce(FVector &InOutAngularVelocity, const FVector &Force, float DeltaTime, float Mass);
@@ -51,7 +51,7 @@ public:
     static FPhysTransform TLerp(const FPhysTransform& A, const FPhysTransform& B, float Alpha);
 
     UFUNCTION(BlueprintCallable)
-    static FBallGroundMovementData ComputeBallGroundMovementData(const FPhysRigidBodyParams& P, float Time_Step);
+    static FBallGroundMovementData ComputeBallGroundMovementData(const FPhysRigidBodyParams& P, float Time_Step, float GroundFriction = 0.5f, float GroundRestitution = 0.3f);
 
     static float GetBallInitialVelocityFromEndVelocity(FBallGroundMovementData P, float EndVelocity, float Time);
     // static float GetInitialVelocityDistancePassedVelocity2(FPhysRigidBodyParams P, float DistanceToPass, float Time);
@@ -3,14 +3,28 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Common/IndexedTrajectory.h"
+#include "Common/PhysSimParams.h"
 #include "Common/PhysTransform.h"
 #include "HMStructs/CustomVectorCurve.h"
 #include "ImpulseDistribution/ImpulseReconstructed.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "PhysicsCache/BallLaunchCache.h"
+#include "PhysicsCache/BallLaunchCacheBuildProgress.h"
 #include "SpinMovementLib.generated.h"
 
 class UAdvancedPhysicsComponent;
+
+/*
+ * Ball copied on game thread for launch cache build; workers launch it instead of reading component state
+ */
+struct FBallLaunchCacheBody
+{
+	FPhysSimParams SimParams;
+	// ball at rest; only orientation is taken from component
+	FPhysTransform TRest;
+};
+
 /**
  * 
  */
@@ -20,13 +34,27 @@ class PHYSICSCALCULATION_API USpinMovementLib : public UBlueprintFunctionLibrary
 	GENERATED_BODY()
 
 public:
-	static FBallLaunchCache_Data CalculateBallLaunchCache(UAdvancedPhysicsComponent* PC);
-	static void CalculateDataFromLaunchParams(UAdvancedPhysicsComponent* PC, const FBallLaunchParams& LaunchParams, FBallLaunchCache_Data& OutData);
+	static FBallLaunchCache_Data CalculateBallLaunchCache(UAdvancedPhysicsComponent* PC, FBallLaunchCacheBuildProgress* Progress=nullptr);
+	// empty cache with axes and grid set up from spin movement params
+	static FBallLaunchCache_Data MakeBallLaunchCacheGrid(UAdvancedPhysicsComponent* PC);
+	static TArray<FBallLaunchParams> MakeBallLaunchCacheCells(UAdvancedPhysicsComponent* PC);
+	// game thread
+	static FBallLaunchCacheBody MakeBallLaunchCacheBody(UAdvancedPhysicsComponent* PC);
+	/*
+	 * Fills grid made by MakeBallLaunchCacheGrid; cells are computed on worker threads, so it may be called off game thread as well.
+	 * Ball state is read from Body only; PC provides spin movement params and impulse distribution cache, which must not change during build.
+	 */
+	static void ComputeBallLaunchCacheCells(UAdvancedPhysicsComponent* PC, const FBallLaunchCacheBody& Body, const TArray<FBallLaunchParams>& Cells,
+	                                        FBallLaunchCache_Data& OutData, FBallLaunchCacheBuildProgress& Progress);
+	static void CalculateDataFromLaunchParams(UAdvancedPhysicsComponent* PC, const FBallLaunchCacheBody& Body, const FBallLaunchParams& LaunchParams,
+	                                          FBallLaunchCache_Data& OutData);
 	static FImpulseReconstructed GetImpulseFromBallLaunchParams(UAdvancedPhysicsComponent* PC, const FBallLaunchParams& P, FVector COM, FVector BaseVector=FVector::ForwardVector);
-	static FCustomVectorCurve CalculateSpinTrajectory(UAdvancedPhysicsComponent* Obj, const FImpulseReconstructed& ImpulseData, FVector COM, float TimeStep, int NumSteps, FPhysTransform& TLaunch);
+	// Body is launched from rest at COM; no collisions, stops below zero Z
+	static FCustomVectorCurve CalculateSpinTrajectory(UAdvancedPhysicsComponent* Obj, const FBallLaunchCacheBody& Body, const FImpulseReconstructed& ImpulseData, FVector COM,
+	                                                  float TimeStep, int NumSteps, FPhysTransform& TLaunch);
 
 	UFUNCTION(BlueprintCallable)
-	static FBallLaunchVerticalDistribution CalculateVerticalDistributionFromTrajectory(UAdvancedPhysicsComponent* PC, const FCustomVectorCurve& Curve);
+	static FBallLaunchVerticalDistribution CalculateVerticalDistributionFromTrajectory(UAdvancedPhysicsComponent* PC, const FIndexedTrajectory& Trajectory);
 	
 	UFUNCTION(BlueprintCallable)
 	static FCustomVectorCurve CalculateSpinTrajectory(UAdvancedPhysicsComponent* Obj, const FBallLaunchParams& P, FVector COM, float TimeStep, int NumSteps, FPhysTransform& TLaunch);
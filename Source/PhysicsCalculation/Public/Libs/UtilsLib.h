@@ -22,6 +22,7 @@ class PHYSICSCALCULATION_API UUtilsLib : public UBlueprintFunctionLibrary
 public:
 	static UCustomPhysicsProcessor* GetPhysicsProcessor();
 	static void SubscribeToPhysicsProcessor(UCustomPhysicsBaseComponent* Obj);
+	static void UnsubscribeFromPhysicsProcessor(UCustomPhysicsBaseComponent* Obj);
 
 	static void UpdateTimeBasedGenerator(FGeneratorTimeBased& G, float DeltaTime);
 
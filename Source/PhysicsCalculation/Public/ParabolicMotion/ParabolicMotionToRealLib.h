@@ -4,8 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "ParabolicMotionCurve.h"
+#include "Common/IndexedTrajectory.h"
 #include "Common/PhysTransform.h"
-#include "Common/TrajectoryStepComparison.h"
 #include "HMStructs/CustomVectorCurve.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "ParabolicMotionToRealLib.generated.h"
@@ -38,6 +38,12 @@ public:
     float LocationTolerance = 1.0f;
     UPROPERTY(BlueprintReadWrite)
     float MultiplierChangeStep = 0.05f;
+    // solver budget: each iteration costs exactly one trajectory simulation
+    UPROPERTY(BlueprintReadWrite)
+    int MaxSolverIterations = 24;
+    // bracket narrower than this is treated as converged even if location tolerance is not met
+    UPROPERTY(BlueprintReadWrite)
+    float MultiplierTolerance = 0.0001f;
     
 public:
     FVector GetVectorToTargetRelative() const {return TargetLocation - LaunchLocation;}
@@ -57,6 +63,49 @@ public:
     }
 };
 
+/**
+ * One simulated trajectory for a given multiplier. Residual is signed: negative means the ball falls short of the target,
+ * positive means it passes above. When target X is not reached at all, residual is measured along X instead of Z.
+ */
+struct FPMSolverSample
+{
+    float Multiplier = 1.0f;
+    float Residual = 0.0f;
+    float GroundDistance = 0.0f;
+    bool bReachX = false;
+    bool bGroundHit = false;
+};
+
+USTRUCT(BlueprintType)
+struct FPMSolverResult
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(BlueprintReadOnly)
+    float Multiplier = 1.0f;
+    UPROPERTY(BlueprintReadOnly)
+    float Residual = 0.0f;
+    // distance from launch location to ground contact for found multiplier
+    UPROPERTY(BlueprintReadOnly)
+    float GroundDistance = 0.0f;
+    UPROPERTY(BlueprintReadOnly)
+    int NumSimulations = 0;
+    UPROPERTY(BlueprintReadOnly)
+    bool bConverged = false;
+    UPROPERTY(BlueprintReadOnly)
+    bool bGroundHit = false;
+
+public:
+    void ApplySample(const FPMSolverSample& S)
+    {
+        Multiplier = S.Multiplier;
+        Residual = S.Residual;
+        GroundDistance = S.GroundDistance;
+        bGroundHit = S.bGroundHit;
+    }
+};
+
 UCLASS()
 class PHYSICSCALCULATION_API UParabolicMotionToRealLib : public UBlueprintFunctionLibrary
 {
@@ -74,12 +123,15 @@ public:
 
     static FPMCompData CreateParabolicCompParams(UAdvancedPhysicsComponent* Obj, FVector TargetLocation, FVector LaunchLocation, float LaunchAngle); 
 
+    /*
+     * Returns false if target can't be reached with launch angle or simulated trajectory never lands;
+     * Multiplier is 1 then
+     */
     UFUNCTION(BlueprintCallable)
-    static float GetParabolicMultiplier(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, float& LaunchSpeed, float& MaxDistance);
-    static float GetParabolicMultiplier_Body(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, const FPhysTransform& T_Base, float BaseMultiplier = 1.0f);
-    static float ComputeMultiplierChangeValue(float DistanceDelta, float StepDelta, float MulIncreaseStep);
-
-    static FTrajectoryStepComparison GetComparisonBaseToOneStep(UAdvancedPhysicsComponent* Obj, const FPhysTransform& T_Base, float TimeStep, int NumSteps, float BaseMultiplier, float MultiplierStep);
+    static bool GetParabolicMultiplier(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, float& Multiplier, float& LaunchSpeed, float& MaxDistance);
+    /** Bracketed Illinois (modified regula falsi) search for multiplier. Terminates within CompData.MaxSolverIterations simulations. */
+    static FPMSolverResult SolveParabolicMultiplier(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, const FPhysTransform& T_Base, float InitialMultiplier = 1.0f);
+    static FPMSolverSample EvaluateParabolicMultiplier(UAdvancedPhysicsComponent* Obj, const FPMCompData& CompData, const FPhysTransform& T_Base, float Multiplier);
     static void DrawCurveTrajectory(UObject* Obj, FCustomVectorCurve Curve,  FLinearColor Color);
 
     UFUNCTION(BlueprintCallable)
@@ -100,4 +152,5 @@ public:
                                        NumAngleIterations, TArray<FVector>& Out);
 
     static  bool GetTrajectoryGroundLocation(const FCustomVectorCurve& Trajectory, FVector& OutLocation, bool bCheckForTrue);
+    static  bool GetTrajectoryGroundLocation(const FIndexedTrajectory& Trajectory, FVector& OutLocation, bool bCheckForTrue);
 };
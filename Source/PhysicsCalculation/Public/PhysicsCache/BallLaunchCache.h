@@ -3,9 +3,12 @@
 #include "CoreMinimal.h"
 #include "BallLaunchParamsItem.h"
 #include "BallLaunchVerticalDistribution.h"
+#include "BallLaunchCacheResidencyStats.h"
 #include "HMStructs/HashVector.h"
 #include "BallLaunchCache.generated.h"
 
+class FBallLaunchCacheResidency;
+
 USTRUCT()
 struct FBallLaunchCache_Data
 {
@@ -23,17 +26,48 @@ public:
     FHashVector SideSpinAngleHV;
     UPROPERTY()
     float VerticalLevelWidth = 0.0f;
+
+    /*
+     * hashes of grid values per axis; position in array is grid coordinate
+     * launch speed is the slowest axis, side spin is the fastest (same as computation order)
+     */
+    UPROPERTY()
+    TArray<int> LaunchSpeedHashes = {};
+    UPROPERTY()
+    TArray<int> LaunchAngleHashes = {};
+    UPROPERTY()
+    TArray<int> FrontSpinAngleHashes = {};
+    UPROPERTY()
+    TArray<int> SideSpinAngleHashes = {};
+
+    /*
+     * max distance on XY plane for every grid cell; negative value marks cell that was not computed
+     */
+    UPROPERTY()
+    TArray<float> MaxDistanceGrid = {};
+
+    // first packed range and number of ranges for every grid cell; cell holds at most MaxRangesPerCell ranges (one byte in binary file)
+    UPROPERTY()
+    TArray<int> VerticalRangeStart = {};
+    UPROPERTY()
+    TArray<uint8> VerticalRangeNum = {};
+    UPROPERTY()
+    TArray<FBallLaunchVerticalRange> VerticalRanges = {};
+
+    UPROPERTY()
+    int NumItems = 0;
     
     /*
-     * launch params item contains hashes instead of values itself
-     * value is max distance on XY plane
-     * this data can be generated from vertical distribution (if such will be implemented)
+     * legacy storage; kept only to convert previously saved caches to grid
      */
     UPROPERTY()
     TMap<FBallLaunchParamsHashed, float> Map = {};
 
     UPROPERTY()
     TMap<FBallLaunchParamsHashed, FBallLaunchVerticalDistribution> VerticalDistribution = {};
+
+    // grid cell of MaxDistanceGrid[0]; non zero only for shards
+    int GridCellOffset = 0;
     
 public:
     void SetLaunchSpeedVector(const TArray<float>& LaunchSpeedData);
@@ -41,14 +75,42 @@ public:
     void SetFrontSpinAngleVector(const TArray<float>& Data);
     void SetSideSpinAngleVector(const TArray<float>& Data);
     void Validate() const;
+    void InitGrid();
+    void ConvertLegacyStorage();
+
+public:
+    // shard covers range of grid cells and shares axes with this data; used for partitioned computation
+    FBallLaunchCache_Data MakeShard(int FirstCellIndex, int NumCells) const;
+    void AppendShard(const FBallLaunchCache_Data& Shard);
+
+public:
+    int GetNumGridCells() const {return LaunchSpeedHashes.Num() * LaunchAngleHashes.Num() * FrontSpinAngleHashes.Num() * SideSpinAngleHashes.Num();}
+    int GetGridCellIndex(const FBallLaunchParamsHashed& Hash) const;
+    int GetGridCellIndex(const FBallLaunchParams& Input) const {return GetGridCellIndex(HashRealValuesToClosest(Input));}
+    int GetLaunchSpeedIndex(int LaunchSpeedHash) const {return GetAxisIndex(LaunchSpeedHashes, LaunchSpeedHash);}
+    // returns index in grid arrays of cell that has data
+    int FindComputedCell(const FBallLaunchParamsHashed& Hash) const;
+    const float* FindDistance(const FBallLaunchParamsHashed& Hash) const;
+    bool FindVerticalDistribution(const FBallLaunchParamsHashed& Hash, FBallLaunchVerticalDistribution& Out) const;
+    bool CanCellReachTarget(int Cell, uint8 LevelIndex, float DistanceXY, float MulDistanceXY) const;
+    // checks every computed cell that shares first NumFixedAxes axes with Hash (launch speed, angle, front spin)
+    bool CanSlabReachTarget(const FBallLaunchParamsHashed& Hash, int NumFixedAxes, uint8 LevelIndex, float DistanceXY, float MulDistanceXY) const;
+    TMap<FBallLaunchParamsHashed, float> MakeDistanceMap() const;
     
 public:
     void SetVerticalLevelWidth(float V){VerticalLevelWidth = V;}
-    void AddVerticalDistribution(const FBallLaunchParams& Input, const FBallLaunchVerticalDistribution& S);
+    static constexpr int MaxRangesPerCell = MAX_uint8;
+    // false when distribution has more than MaxRangesPerCell ranges; cell is left without ranges then
+    bool AddVerticalDistribution(const FBallLaunchParams& Input, const FBallLaunchVerticalDistribution& S);
+    bool AddVerticalDistribution(const FBallLaunchParamsHashed& Hash, const FBallLaunchVerticalDistribution& S);
     void AddDistanceValue(const FBallLaunchParams& Input, float Distance);
+    void AddDistanceValue(const FBallLaunchParamsHashed& Hash, float Distance);
     TArray<float> SelectDistancesFromHashArray(const TArray<FBallLaunchParamsHashed>& Data);
     FBallLaunchParamsHashSelection SelectHashedLaunchParams(const FBallLaunchParams& Input);
     FBallLaunchParamsHashSelectionSimple SelectHashedLaunchParamsWithLaunchSpeedRequiredDistanceCheck(const FBallLaunchParams& Input, float MinDistance);
+    // distances of every launch speed are taken from data returned by GetSpeedData (e.g. chunk of that speed)
+    FBallLaunchParamsHashSelectionSimple SelectHashedLaunchParamsWithLaunchSpeedRequiredDistanceCheck(const FBallLaunchParams& Input, float MinDistance,
+        TFunctionRef<const FBallLaunchCache_Data&(int LaunchSpeedHash)> GetSpeedData) const;
     FBallLaunchParamsHashed HashRealValuesToClosest(const FBallLaunchParams& Input) const;
     FBallLaunchParamsHashed HashRealValuesToClosest(const FBallLaunchParams& Input, bool bFixSideSpin) const;
     FBallLaunchParams GetLaunchParamsFromHash(const FBallLaunchParamsHashed& Hash) const;
@@ -58,6 +120,13 @@ public:
     static void SortHashDistanceArrays(FBallLaunchParamsHashSelectionSimple& InOutData);
     uint8 GetVerticalLevelIndex(float DistanceZ) const;
     bool IsLaunchParamsPureHashed(const FBallLaunchParams& Input) const;
+
+private:
+    static int GetAxisIndex(const TArray<int>& AxisHashes, int Hash);
+    static TArray<int> MakeAxisHashes(const FHashVector& HV, const TArray<float>& Values);
+    int GetLocalCellIndex(int CellIndex) const;
+    // slab cells are contiguous since fixed axes are the slowest ones
+    bool GetSlabCells(const FBallLaunchParamsHashed& Hash, int NumFixedAxes, int& OutFirstCell, int& OutNumCells) const;
 };
 
 UCLASS()
@@ -69,13 +138,34 @@ public:
     UPROPERTY()
     FBallLaunchCache_Data Data;
 
+private:
+    // set when cache is read from chunked file on demand; Data holds axes only then
+    TSharedPtr<FBallLaunchCacheResidency> Residency;
+    // keeps chunk of the current query alive until the next one
+    TSharedPtr<const FBallLaunchCache_Data> QueryChunk;
+    // built on the first GetMap call; NumItems of Data it was built for
+    TMap<FBallLaunchParamsHashed, float> DistanceMap;
+    int DistanceMapNumItems = INDEX_NONE;
+
 public:
+    bool OpenChunkedFile(const FString& Path, int64 MemoryBudget);
+    bool IsChunked() const {return Residency.IsValid();}
+
+    // starts background reading of chunks that queries in launch speed range will need
+    UFUNCTION(BlueprintCallable)
+    void PrefetchLaunchSpeedRange(float MinLaunchSpeed, float MaxLaunchSpeed);
 
     UFUNCTION(BlueprintPure)
-    int GetNumItems() const {return Data.Map.Num();}
+    FBallLaunchCacheResidencyStats GetResidencyStats() const;
+
+public:
 
     UFUNCTION(BlueprintPure)
-    TMap<FBallLaunchParamsHashed, float> GetMap(){return Data.Map;}
+    int GetNumItems() const {return Data.NumItems;}
+
+    // cached; rebuilt only when number of items changes or another file is opened
+    UFUNCTION(BlueprintPure)
+    TMap<FBallLaunchParamsHashed, float> GetMap();
     
     UFUNCTION(BlueprintCallable)
     float GetDistanceFromInput(FBallLaunchParams Input);
@@ -86,11 +176,26 @@ public:
     UFUNCTION(BlueprintCallable)
     bool CanInputReachTarget(FBallLaunchParams Input, float DistanceXY, float DistanceZ, float AbsDerivationZ=0.0f, float MulDistanceXY=1.0f);
 
+    /*
+     * Same check for all spin combinations at once: false means no input of slab can reach target.
+     * NumFixedAxes = 2 - launch speed and angle of Input are fixed; 3 - front spin too
+     */
+    bool CanSlabReachTarget(const FBallLaunchParams& Input, int NumFixedAxes, float DistanceXY, float DistanceZ, float AbsDerivationZ=0.0f, float MulDistanceXY=1.0f);
+
     UFUNCTION(BlueprintPure)
-    bool IsLaunchParamsPureHashed(const FBallLaunchParams& Input) const;
+    bool IsLaunchParamsPureHashed(const FBallLaunchParams& Input);
 
     UFUNCTION(BlueprintPure)
     bool GetVDistributionForLaunchParams(const FBallLaunchParams& Input, TMap<int, FVerticalDistributionDistanceItem>& Out);
     
     bool ComputeLaunchParamsLaunchSpeedAdjust(FBallLaunchParams InitialParams, float DistanceToTarget, float PosTolerance, FBallLaunchParams& OutParams);
+
+private:
+    /*
+     * Data that holds cells of launch speed; in chunked mode may read chunk from disk and replaces QueryChunk,
+     * so returned reference is valid until the next call. Not thread safe: queries are made from game thread only.
+     */
+    const FBallLaunchCache_Data& GetSpeedData(int LaunchSpeedHash);
+    // precise level first, then levels of derivation bounds
+    void GetTargetLevelIndices(float DistanceZ, float AbsDerivationZ, uint8 (&OutLevels)[3]) const;
 };
@@ -0,0 +1,97 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "BallLaunchCache.h"
+
+struct FSpinMovementParams;
+
+/*
+ * Entry of chunk table; chunk holds all grid cells of consecutive launch speeds
+ */
+struct PHYSICSCALCULATION_API FBallLaunchCacheChunkInfo
+{
+    int32 FirstCell = 0;
+    int32 NumCells = 0;
+    int32 NumRanges = 0;
+    int32 NumItems = 0;
+    // counted from the end of chunk table
+    int64 Offset = 0;
+    uint32 Crc = 0;
+
+public:
+    int64 GetNumBytes() const {return static_cast<int64>(NumCells) * 3 + static_cast<int64>(NumRanges) * 9;}
+    // memory taken by chunk unpacked into FBallLaunchCache_Data
+    int64 GetResidentSize() const;
+    friend FArchive& operator<<(FArchive& Ar, FBallLaunchCacheChunkInfo& Info);
+};
+
+struct PHYSICSCALCULATION_API FBallLaunchCacheFileHeader
+{
+    // axes and item count only; grid arrays are not initialized
+    FBallLaunchCache_Data Grid;
+    float Quantum = 0.0f;
+    int32 SpeedsPerChunk = 0;
+    // archive position of the first chunk
+    int64 PayloadStart = 0;
+    TArray<FBallLaunchCacheChunkInfo> Chunks;
+
+public:
+    int32 GetChunkIndex(int32 LaunchSpeedIndex) const {return LaunchSpeedIndex / SpeedsPerChunk;}
+    int64 GetResidentSize() const;
+};
+
+/*
+ * Binary file format of ball launch cache; replaces UObject serialization of FBallLaunchCache_Data.
+ *
+ * Layout (little endian):
+ *   header   - magic, version, size of header body, header body and its CRC32;
+ *              body is vertical level width, distance quantum, number of items,
+ *              four grid axes (values taken from FSpinMovementParams and their hashes), number of cells,
+ *              launch speeds per chunk and chunk table;
+ *   chunks   - one per band of launch speeds: max distance per cell as uint16 fixed point
+ *              (NoDistance marks cell that was not computed), number of vertical ranges per cell,
+ *              then range levels, min and max distances (float) as separate blocks.
+ *
+ * Launch speed is the slowest grid axis, so every chunk is a contiguous range of cells and is loaded as shard.
+ * Every chunk has its own CRC32 and can be read alone (see FBallLaunchCacheResidency).
+ * Files are written to temporary file first, so failed save never damages previous cache.
+ * Range start indices are not stored: ranges are written in cell order and restored as prefix sum.
+ */
+struct PHYSICSCALCULATION_API FBallLaunchCacheBinary
+{
+    static constexpr uint32 Magic = 0x4C424350; // PCBL
+    static constexpr uint32 Version = 4;
+    static constexpr uint16 NoDistance = MAX_uint16;
+    // cm per unit of packed max distance; covers about 327 m
+    static constexpr float DistanceQuantum = 0.5f;
+    // guards against allocation from corrupted header
+    static constexpr int32 MaxAxisSize = 4096;
+    static constexpr int32 MaxHeaderSize = 4 * 1024 * 1024;
+
+public:
+    static bool Save(FArchive& Ar, const FBallLaunchCache_Data& Data, const FSpinMovementParams& Params, int32 SpeedsPerChunk = 1);
+    // OutData is reset when file is invalid
+    static bool Load(FArchive& Ar, FBallLaunchCache_Data& OutData);
+    static bool LoadHeader(FArchive& Ar, FBallLaunchCacheFileHeader& OutHeader);
+    // OutShard covers cells of chunk only
+    static bool LoadChunk(FArchive& Ar, const FBallLaunchCacheFileHeader& Header, int32 ChunkIndex, FBallLaunchCache_Data& OutShard);
+
+    static bool SaveToFile(const FString& Path, const FBallLaunchCache_Data& Data, const FSpinMovementParams& Params, int32 SpeedsPerChunk = 1);
+    static bool LoadFromFile(const FString& Path, FBallLaunchCache_Data& OutData);
+    static bool LoadHeaderFromFile(const FString& Path, FBallLaunchCacheFileHeader& OutHeader);
+
+    static uint16 PackDistance(float Distance);
+    static float UnpackDistance(uint16 Packed, float Quantum = DistanceQuantum);
+
+private:
+    static void PackChunk(const FBallLaunchCache_Data& Data, FBallLaunchCacheChunkInfo& InOutInfo, TArray<uint8>& OutBytes);
+    static bool UnpackChunk(const TArray<uint8>& Bytes, const FBallLaunchCacheChunkInfo& Info, float Quantum, FBallLaunchCache_Data& InOutShard);
+    static void SaveAxis(FArchive& Ar, const TArray<float>& Values, const TArray<int>& Hashes);
+    static bool LoadAxis(FArchive& Ar, TArray<float>& OutValues, TArray<int>& OutHashes);
+    // every hash of Data must stand for value of the same grid position taken from params
+    static bool DoAxesMatch(const FBallLaunchCache_Data& Data, const TArray<float> (&Axes)[4]);
+    static bool LoadHeaderBody(FArchive& Ar, FBallLaunchCacheFileHeader& OutHeader);
+    static void SerializeBlock(FArchive& Ar, void* Data, int64 NumBytes);
+    static bool LoadFailed(FBallLaunchCache_Data& OutData);
+    static bool LoadFailed(FBallLaunchCacheFileHeader& OutHeader);
+};
@@ -0,0 +1,33 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "PhysicsCache/BallLaunchCache.h"
+#include "PhysicsCache/BallLaunchCacheBuildProgress.h"
+#include "Libs/SpinMovementLib.h"
+
+class UAdvancedPhysicsComponent;
+
+/*
+ * Launch cache build on thread pool. Grid and cells are prepared on game thread (limit curves are UObjects),
+ * owner polls IsCompleted and saves Data there. Owner must keep Target and Progress alive until the job is completed.
+ */
+struct FBallLaunchCacheBuildJob
+{
+    UAdvancedPhysicsComponent* Target = nullptr;
+    FBallLaunchCacheBuildProgress* Progress = nullptr;
+    TArray<FBallLaunchParams> Cells;
+    FBallLaunchCacheBody Body;
+    FBallLaunchCache_Data Data;
+
+    FThreadSafeBool bCompleted = false;
+
+public:
+    // game thread
+    void Init(UAdvancedPhysicsComponent* InTarget, FBallLaunchCacheBuildProgress* InProgress);
+    // any thread
+    void Run();
+    bool IsCompleted() const {return bCompleted;}
+    // blocks until worker is done; cancelled job finishes after its current cells
+    void Wait() const;
+};
@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+
+/*
+ * Shared state of launch cache build: workers report finished grid cells here,
+ * any thread may request cancellation; cancelled build must not be saved.
+ * Cancel requested before build starts applies to that build; owner clears it once build is finished.
+ */
+struct PHYSICSCALCULATION_API FBallLaunchCacheBuildProgress
+{
+    FThreadSafeCounter NumCellsTotal;
+    FThreadSafeCounter NumCellsDone;
+    FThreadSafeBool bCancelRequested = false;
+
+public:
+    void Reset(int NumTotal)
+    {
+        NumCellsTotal.Set(NumTotal);
+        NumCellsDone.Reset();
+    }
+    void Cancel() {bCancelRequested = true;}
+    void ClearCancel() {bCancelRequested = false;}
+    void MarkCellDone() {NumCellsDone.Increment();}
+
+public:
+    bool IsCancelled() const {return bCancelRequested;}
+    int GetNumCellsTotal() const {return NumCellsTotal.GetValue();}
+    int GetNumCellsDone() const {return NumCellsDone.GetValue();}
+    float GetRatio() const
+    {
+        const int Total = GetNumCellsTotal();
+        return Total > 0 ? static_cast<float>(GetNumCellsDone()) / Total : 1.0f;
+    }
+};
@@ -0,0 +1,77 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "BallLaunchCacheBinary.h"
+#include "BallLaunchCacheResidencyStats.h"
+#include "HAL/ThreadSafeBool.h"
+
+/*
+ * Chunk of ball launch cache file read on thread pool; Result is owned by worker until bCompleted is set
+ */
+struct FBallLaunchCacheChunkLoadJob
+{
+    TSharedPtr<const FBallLaunchCacheFileHeader, ESPMode::ThreadSafe> Header;
+    FString Path;
+    int ChunkIndex = INDEX_NONE;
+    FBallLaunchCache_Data Result;
+    bool bSucceeded = false;
+    FThreadSafeBool bCompleted = false;
+
+public:
+    bool IsCompleted() const {return bCompleted;}
+    void Run();
+};
+
+/*
+ * Keeps only part of ball launch cache file in memory.
+ * Chunk (band of launch speeds, see FBallLaunchCacheBinary) is read on first query and least recently used chunks
+ * are evicted when memory budget is exceeded. Prefetched chunks are read on thread pool and become resident
+ * on the next call from game thread, so residency is never changed concurrently.
+ */
+class PHYSICSCALCULATION_API FBallLaunchCacheResidency
+{
+public:
+    // zero budget keeps every chunk that was read
+    bool Open(const FString& InPath, int64 InMemoryBudget);
+    void Close();
+    void SetMemoryBudget(int64 Bytes);
+
+public:
+    bool IsOpen() const {return Header.IsValid();}
+    // axes and item count only; cells are found in chunks
+    const FBallLaunchCache_Data& GetGrid() const {return Header->Grid;}
+    int GetNumChunks() const {return Slots.Num();}
+    int GetChunkIndexForSpeed(int LaunchSpeedHash) const;
+    // resident chunk or chunk read synchronously; null when file can't be read
+    TSharedPtr<const FBallLaunchCache_Data> GetChunk(int ChunkIndex);
+    // starts background reading of missing chunks of launch speed band; requests no more than memory budget
+    void Prefetch(int FirstSpeedIndex, int LastSpeedIndex);
+    FBallLaunchCacheResidencyStats GetStats() const;
+
+private:
+    struct FChunkSlot
+    {
+        TSharedPtr<const FBallLaunchCache_Data> Data;
+        TSharedPtr<FBallLaunchCacheChunkLoadJob, ESPMode::ThreadSafe> PrefetchJob;
+        uint64 LastUse = 0;
+    };
+
+    void CollectPrefetched();
+    void MakeResident(int ChunkIndex, FBallLaunchCache_Data&& Data);
+    void TrimToBudget(int KeepChunkIndex);
+    void Evict(int ChunkIndex);
+    int64 GetChunkSize(int ChunkIndex) const {return Header->Chunks[ChunkIndex].GetResidentSize();}
+
+private:
+    FString Path;
+    TSharedPtr<const FBallLaunchCacheFileHeader, ESPMode::ThreadSafe> Header;
+    // used by synchronous reads only; every prefetch job opens its own
+    TUniquePtr<FArchive> Reader;
+    TArray<FChunkSlot> Slots;
+    int64 MemoryBudget = 0;
+    int64 ResidentBytes = 0;
+    int64 TotalBytes = 0;
+    uint64 UseCounter = 0;
+    int NumPendingJobs = 0;
+    FBallLaunchCacheResidencyStats Stats;
+};
@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "BallLaunchCacheResidencyStats.generated.h"
+
+USTRUCT(BlueprintType)
+struct FBallLaunchCacheResidencyStats
+{
+    GENERATED_BODY()
+
+    // query found chunk resident
+    UPROPERTY(BlueprintReadOnly)
+    int NumHits = 0;
+    // query had to read chunk synchronously
+    UPROPERTY(BlueprintReadOnly)
+    int NumMisses = 0;
+    // chunks made resident by background prefetch
+    UPROPERTY(BlueprintReadOnly)
+    int NumPrefetched = 0;
+    UPROPERTY(BlueprintReadOnly)
+    int NumEvictions = 0;
+    UPROPERTY(BlueprintReadOnly)
+    int NumResidentChunks = 0;
+    UPROPERTY(BlueprintReadOnly)
+    int NumChunks = 0;
+    UPROPERTY(BlueprintReadOnly)
+    float ResidentMB = 0.0f;
+    // size of the whole cache if it was resident
+    UPROPERTY(BlueprintReadOnly)
+    float TotalMB = 0.0f;
+
+public:
+    float GetResidentRatio() const {return TotalMB > 0.0f ? ResidentMB / TotalMB : 0.0f;}
+    float GetHitRatio() const
+    {
+        const int NumQueries = NumHits + NumMisses;
+        return NumQueries > 0 ? static_cast<float>(NumHits) / NumQueries : 1.0f;
+    }
+};
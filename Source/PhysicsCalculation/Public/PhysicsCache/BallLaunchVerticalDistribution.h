@@ -32,6 +32,41 @@ public:
     }
 };
 
+/*
+ * Packed vertical distribution entry; distances keep computed values exactly,
+ * so reach checks give the same results as nested map they replace
+ */
+USTRUCT()
+struct FBallLaunchVerticalRange
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    uint8 LevelIndex = 0;
+    UPROPERTY()
+    float MinDistanceXY = 0.0f;
+    UPROPERTY()
+    float MaxDistanceXY = 0.0f;
+
+public:
+    FBallLaunchVerticalRange(){}
+    FBallLaunchVerticalRange(uint8 Level, float MinXY, float MaxXY)
+    {
+        LevelIndex = Level;
+        MinDistanceXY = MinXY;
+        MaxDistanceXY = MaxXY;
+    }
+
+public:
+    FFloatMinMax GetDistanceXY() const {return FFloatMinMax(MinDistanceXY, MaxDistanceXY);}
+    bool IsValueInRange(float DistanceXY, float MulCorrection) const
+    {
+        const float Min = MinDistanceXY / MulCorrection;
+        const float Max = MaxDistanceXY * MulCorrection;
+        return FMath::IsWithinInclusive(DistanceXY, Min, Max);
+    }
+};
+
 USTRUCT(BlueprintType)
 struct FBallLaunchVerticalDistribution
 {
@@ -75,6 +110,28 @@ public:
         
         return Out;
     }
+
+    void AppendPacked(TArray<FBallLaunchVerticalRange>& Out) const
+    {
+        for (const auto& Item : Map)
+        {
+            for (const auto& Range : Item.Value.Data)
+            {
+                Out.Add(FBallLaunchVerticalRange(Item.Key, Range.Min, Range.Max));
+            }
+        }
+    }
+
+    static FBallLaunchVerticalDistribution FromPacked(const FBallLaunchVerticalRange* Ranges, int Num)
+    {
+        FBallLaunchVerticalDistribution Out;
+        for (int i = 0; i < Num; ++i)
+        {
+            const auto Range = Ranges[i].GetDistanceXY();
+            Out.AddItem(Ranges[i].LevelIndex, Range.Min, Range.Max);
+        }
+        return Out;
+    }
     
 public:
     bool CanReachTarget(uint8 LevelIndex, float DistanceXY, float MulDistanceXY)
@@ -0,0 +1,222 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Common/PhysEnums.h"
+#include "KickCalculationSystem/Structs/KickCandidates.h"
+#include "KickCalculationSystem/Structs/KickCompData.h"
+#include "PhysicsBenchmarkData.generated.h"
+
+USTRUCT(BlueprintType)
+struct FPhysicsBenchmarkSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadWrite)
+    int NumSingleSteps = 100000;
+
+    UPROPERTY(BlueprintReadWrite)
+    int NumPrecisePredictions = 100;
+
+    // sec
+    UPROPERTY(BlueprintReadWrite)
+    float PrecisePredictionTime = 0.5f;
+
+    // 0 - skip
+    UPROPERTY(BlueprintReadWrite)
+    int NumKickSolves = 10;
+
+    UPROPERTY(BlueprintReadWrite)
+    FKickCompData KickData;
+
+    // first cells of launch cache grid; 0 - skip
+    UPROPERTY(BlueprintReadWrite)
+    int NumCacheCells = 64;
+
+    // flight time for integrator accuracy table; 0 - skip
+    UPROPERTY(BlueprintReadWrite)
+    float IntegratorAccuracyTime = 2.0f;
+
+    // each integrator runs with precise step multiplied by these values
+    UPROPERTY(BlueprintReadWrite)
+    TArray<int> IntegratorStepMultipliers = {1, 2, 5, 10};
+
+    // roll time for ground movement accuracy table; 0 - skip
+    UPROPERTY(BlueprintReadWrite)
+    float GroundRollTime = 2.0f;
+
+    // cm/sec; each speed starts once rolling and once sliding without spin
+    UPROPERTY(BlueprintReadWrite)
+    TArray<float> GroundRollSpeeds = {300.0f, 1000.0f, 3000.0f};
+
+    // samples along the move for reference time of impact in sweep accuracy table; 0 - skip
+    UPROPERTY(BlueprintReadWrite)
+    int NumSweepReferenceSteps = 10000;
+
+    // cm/sec; high speed sweeps move this far during one precise step
+    UPROPERTY(BlueprintReadWrite)
+    float SweepSpeed = 20000.0f;
+
+    // each pinching and stacking scenario runs with these solver iteration counts; empty - skip
+    UPROPERTY(BlueprintReadWrite)
+    TArray<int> ContactSolverIterations = {1, 4, 8};
+
+    // resting stack is pushed by gravity for this many precise steps
+    UPROPERTY(BlueprintReadWrite)
+    int ContactStackSteps = 120;
+};
+
+USTRUCT(BlueprintType)
+struct FPhysicsIntegratorAccuracy
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    TEnumAsByte<EPhysIntegrator> Integrator = SemiImplicitEuler;
+
+    UPROPERTY(BlueprintReadOnly)
+    float DeltaTime = 0.0f;
+
+    // location error at the end of flight against reference solution, cm
+    UPROPERTY(BlueprintReadOnly)
+    float LocationError = 0.0f;
+
+public:
+    FString ToString() const
+    {
+        return FString::FromInt(Integrator) + " | dt " + FString::SanitizeFloat(DeltaTime) + " | error " + FString::SanitizeFloat(LocationError) + " cm";
+    }
+};
+
+USTRUCT(BlueprintType)
+struct FPhysicsGroundRollAccuracy
+{
+    GENERATED_BODY()
+
+    // cm/sec
+    UPROPERTY(BlueprintReadOnly)
+    float StartSpeed = 0.0f;
+
+    // ball started without spin, so it slides before rolling
+    UPROPERTY(BlueprintReadOnly)
+    bool bSliding = false;
+
+    // tabulated ground movement against stepped ground contact at the end of roll, cm
+    UPROPERTY(BlueprintReadOnly)
+    float LocationError = 0.0f;
+
+    // cm/sec
+    UPROPERTY(BlueprintReadOnly)
+    float SpeedError = 0.0f;
+
+public:
+    FString ToString() const
+    {
+        return FString::SanitizeFloat(StartSpeed) + (bSliding ? " cm/sec sliding" : " cm/sec rolling") + " | error " + FString::SanitizeFloat(LocationError) + " cm, " +
+               FString::SanitizeFloat(SpeedError) + " cm/sec";
+    }
+};
+
+USTRUCT(BlueprintType)
+struct FPhysicsSweepAccuracy
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    FString Name;
+
+    // analytic time of impact
+    UPROPERTY(BlueprintReadOnly)
+    bool bHit = false;
+
+    // dense sampling of closest point along the move
+    UPROPERTY(BlueprintReadOnly)
+    bool bReferenceHit = false;
+
+    // difference of contact location along the move when both hit, cm
+    UPROPERTY(BlueprintReadOnly)
+    float LocationError = 0.0f;
+
+public:
+    bool IsMatching() const {return bHit == bReferenceHit;}
+    
+    FString ToString() const
+    {
+        return Name + (bHit ? " | hit" : " | miss") + (IsMatching() ? "" : " | MISMATCH") + " | error " + FString::SanitizeFloat(LocationError) + " cm";
+    }
+};
+
+USTRUCT(BlueprintType)
+struct FPhysicsContactSolverAccuracy
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    FString Name;
+
+    UPROPERTY(BlueprintReadOnly)
+    int NumIterations = 0;
+
+    // largest approaching normal velocity left at any contact after solve, cm/sec
+    UPROPERTY(BlueprintReadOnly)
+    float PenetratingVelocity = 0.0f;
+
+    // largest difference of body velocity when contacts are solved in reversed order, cm/sec
+    UPROPERTY(BlueprintReadOnly)
+    float OrderDifference = 0.0f;
+
+public:
+    FString ToString() const
+    {
+        return Name + " | " + FString::FromInt(NumIterations) + " iterations | penetrating " + FString::SanitizeFloat(PenetratingVelocity) + " cm/sec | order " +
+               FString::SanitizeFloat(OrderDifference) + " cm/sec";
+    }
+};
+
+USTRUCT(BlueprintType)
+struct FPhysicsBenchmarkResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    float SingleStepNs = 0.0f;
+
+    // same step when sim params are derived from rigid body params every time
+    UPROPERTY(BlueprintReadOnly)
+    float SingleStepDerivedParamsNs = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly)
+    float PrecisePredictionMs = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly)
+    float KickSolveMs = 0.0f;
+
+    // candidate counters of the last kick solve run
+    UPROPERTY(BlueprintReadOnly)
+    FKickCandidateStats KickCandidates;
+
+    UPROPERTY(BlueprintReadOnly)
+    float CacheCellMs = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly)
+    int NumCacheCells = 0;
+
+    UPROPERTY(BlueprintReadOnly)
+    TArray<FPhysicsIntegratorAccuracy> IntegratorAccuracy;
+
+    UPROPERTY(BlueprintReadOnly)
+    TArray<FPhysicsGroundRollAccuracy> GroundRollAccuracy;
+
+    UPROPERTY(BlueprintReadOnly)
+    TArray<FPhysicsSweepAccuracy> SweepAccuracy;
+
+    UPROPERTY(BlueprintReadOnly)
+    TArray<FPhysicsContactSolverAccuracy> ContactSolverAccuracy;
+
+public:
+    FString ToString() const
+    {
+        return "Step: " + FString::SanitizeFloat(SingleStepNs) + " ns (derived params: " + FString::SanitizeFloat(SingleStepDerivedParamsNs) + " ns) | Precise prediction: " + FString::SanitizeFloat(PrecisePredictionMs) +
+               " ms | Kick solve: " + FString::SanitizeFloat(KickSolveMs) + " ms | Cache cell: " + FString::SanitizeFloat(CacheCellMs) +
+               " ms (" + FString::FromInt(NumCacheCells) + " cells)";
+    }
+};
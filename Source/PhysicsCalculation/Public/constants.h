@@ -13,4 +13,5 @@ static float PHYS_PRECISION_SCALE = 0.1f; // decrease simulation step to increas
 static float PHYS_SIM_DT = PHYS_FPS * PHYS_PRECISION_SCALE;
 static  float SeparationSphereMultiplier = 1.05f;
 static  float TunnelingDetectionSphereRadiusMul = 0.48f; //0.48;
+static  int MaxSweepContactsPerStep = 4; // rest of the step after the last one is dropped
 
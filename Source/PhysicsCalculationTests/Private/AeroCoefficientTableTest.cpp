@@ -0,0 +1,110 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Aerodynamics/AirDrag.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AeroCoefficientTableTest
+{
+    // drag and lift coefficients of ball shaped like measured ones: drag crisis around 1000 cm/s
+    UCurveVector* MakeCurve()
+    {
+        UCurveVector* Curve = NewObject<UCurveVector>();
+        const float Speeds[] = {0.0f, 500.0f, 900.0f, 1100.0f, 1500.0f, 3000.0f, 5000.0f};
+        const float Drag[] = {0.5f, 0.48f, 0.42f, 0.18f, 0.12f, 0.16f, 0.2f};
+        const float Lift[] = {0.0f, 0.05f, 0.1f, 0.15f, 0.2f, 0.25f, 0.25f};
+        for (int i = 0; i < UE_ARRAY_COUNT(Speeds); ++i)
+        {
+            Curve->FloatCurves[0].UpdateOrAddKey(Speeds[i], Drag[i]);
+            Curve->FloatCurves[1].UpdateOrAddKey(Speeds[i], Lift[i]);
+        }
+        for (auto& FloatCurve : Curve->FloatCurves)
+        {
+            for (auto It = FloatCurve.GetKeyHandleIterator(); It; ++It)
+            {
+                FloatCurve.SetKeyInterpMode(*It, RCIM_Cubic);
+            }
+        }
+        return Curve;
+    }
+
+    float GetDeviation(const FAirDrag& AirDrag, float Speed)
+    {
+        const FVector Table = AirDrag.GetAirDragVector(Speed);
+        const FVector Curve = AirDrag.AirDragCurve->GetVectorValue(Speed);
+        return FMath::Max(FMath::Abs(Table.X - Curve.X), FMath::Abs(Table.Y - Curve.Y));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAeroCoefficientTableErrorTest, "PhysicsCalculation.Aerodynamics.CoefficientTable.ErrorBound",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAeroCoefficientTableErrorTest::RunTest(const FString& Parameters)
+{
+    using namespace AeroCoefficientTableTest;
+    
+    FAirDrag AirDrag;
+    AirDrag.AirDragCurve = MakeCurve();
+    TestTrue(TEXT("Table is built"), AirDrag.UpdateCoefficientTable());
+    TestFalse(TEXT("Unchanged curve does not rebuild table"), AirDrag.UpdateCoefficientTable());
+
+    const float MaxError = AirDrag.CoefficientTable->GetMaxError();
+    TestTrue(TEXT("Error bound is small"), MaxError < 1e-3f);
+
+    // dense sampling including points between table samples; measured bound must hold everywhere
+    float MaxDeviation = 0.0f;
+    for (int i = 0; i <= 100000; ++i)
+    {
+        MaxDeviation = FMath::Max(MaxDeviation, GetDeviation(AirDrag, 5000.0f * i / 100000));
+    }
+    AddInfo(FString::Printf(TEXT("Max error: %f, measured deviation: %f"), MaxError, MaxDeviation));
+    TestTrue(TEXT("Deviation is within error bound"), MaxDeviation <= MaxError * 1.1f + 1e-5f);
+
+    // copies share table instead of copying samples
+    const FAirDrag Copy = AirDrag;
+    TestTrue(TEXT("Copy shares table"), Copy.CoefficientTable == AirDrag.CoefficientTable);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAeroCoefficientTableExtrapolationTest, "PhysicsCalculation.Aerodynamics.CoefficientTable.Extrapolation",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAeroCoefficientTableExtrapolationTest::RunTest(const FString& Parameters)
+{
+    using namespace AeroCoefficientTableTest;
+    
+    FAirDrag AirDrag;
+    AirDrag.AirDragCurve = MakeCurve();
+    AirDrag.UpdateCoefficientTable();
+    TestTrue(TEXT("Constant extrapolation is clamped"), GetDeviation(AirDrag, 8000.0f) <= KINDA_SMALL_NUMBER);
+
+    for (auto& FloatCurve : AirDrag.AirDragCurve->FloatCurves)
+    {
+        FloatCurve.PostInfinityExtrap = RCCE_Linear;
+    }
+    TestTrue(TEXT("Changed extrapolation rebuilds table"), AirDrag.UpdateCoefficientTable());
+    TestTrue(TEXT("Linear extrapolation follows curve"), GetDeviation(AirDrag, 8000.0f) <= KINDA_SMALL_NUMBER);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAeroCoefficientTableEditTest, "PhysicsCalculation.Aerodynamics.CoefficientTable.InPlaceEdit",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAeroCoefficientTableEditTest::RunTest(const FString& Parameters)
+{
+    using namespace AeroCoefficientTableTest;
+    
+    FAirDrag AirDrag;
+    AirDrag.AirDragCurve = MakeCurve();
+    AirDrag.UpdateCoefficientTable();
+    const auto OldTable = AirDrag.CoefficientTable;
+
+    AirDrag.AirDragCurve->FloatCurves[0].UpdateOrAddKey(1100.0f, 0.3f);
+    TestTrue(TEXT("Edited key rebuilds table"), AirDrag.UpdateCoefficientTable());
+    TestTrue(TEXT("Rebuild replaces shared table"), OldTable != AirDrag.CoefficientTable);
+    TestTrue(TEXT("Old table is left untouched"), OldTable->IsBuiltFor(AirDrag.AirDragCurve) && !OldTable->IsUpToDate(AirDrag.AirDragCurve));
+    TestTrue(TEXT("Edited value is used"), GetDeviation(AirDrag, 1100.0f) <= KINDA_SMALL_NUMBER);
+    return true;
+}
+
+#endif
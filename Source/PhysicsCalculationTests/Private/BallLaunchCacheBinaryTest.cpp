@@ -0,0 +1,184 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "DataAssets/SpinMovementParams_DataAsset.h"
+#include "PhysicsCache/BallLaunchCacheBinary.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BallLaunchCacheBinaryTest
+{
+    FSpinMovementParams MakeParams()
+    {
+        FSpinMovementParams Params;
+        Params.LaunchSpeed.SetMinMaxDelta(40.0f, 90.0f, 10.0f);
+        Params.LaunchAngle.SetMinMaxDelta(0.0f, 6.0f, 1.0f);
+        Params.FrontSpinAngle.SetMinMaxDelta(-2.0f, 2.0f, 1.0f);
+        Params.SideSpinAngle.SetMinMaxDelta(0.0f, 3.0f, 1.0f);
+        Params.TargetParams.SetMinMaxDelta(10.0f, 230.0f, 20.0f);
+        return Params;
+    }
+
+    // grid with random distances and ranges; some cells are left not computed
+    FBallLaunchCache_Data MakeData(const FSpinMovementParams& Params)
+    {
+        FBallLaunchCache_Data Data;
+        Data.SetLaunchSpeedVector(Params.GetLaunchSpeedCmSec());
+        Data.SetLaunchAngleVector(Params.LaunchAngle.GetValueArrayFullRange());
+        Data.SetFrontSpinAngleVector(Params.FrontSpinAngle.GetValueArrayFullRange());
+        Data.SetSideSpinAngleVector(Params.SideSpinAngle.GetValueArrayFullRange());
+        Data.SetVerticalLevelWidth(Params.GetVerticalLevelWidth());
+        Data.InitGrid();
+
+        FRandomStream Random(18);
+        for (int Cell = 0; Cell < Data.GetNumGridCells(); ++Cell)
+        {
+            Data.VerticalRangeStart[Cell] = Data.VerticalRanges.Num();
+            if(Random.FRand() < 0.2f) continue;
+            
+            Data.MaxDistanceGrid[Cell] = Random.FRandRange(0.0f, 10000.0f);
+            Data.NumItems++;
+            Data.VerticalRangeNum[Cell] = Random.RandRange(0, 5);
+            for (int i = 0; i < Data.VerticalRangeNum[Cell]; ++i)
+            {
+                const float Min = Random.FRandRange(0.0f, 5000.0f);
+                Data.VerticalRanges.Add(FBallLaunchVerticalRange(Random.RandRange(0, 11), Min, Min + Random.FRandRange(0.0f, 3000.0f)));
+            }
+        }
+        return Data;
+    }
+
+    bool IsSame(FAutomationTestBase& Test, const FBallLaunchCache_Data& A, const FBallLaunchCache_Data& B)
+    {
+        bool bSame = A.LaunchSpeedHashes == B.LaunchSpeedHashes && A.LaunchAngleHashes == B.LaunchAngleHashes;
+        bSame &= A.FrontSpinAngleHashes == B.FrontSpinAngleHashes && A.SideSpinAngleHashes == B.SideSpinAngleHashes;
+        bSame &= A.NumItems == B.NumItems && A.VerticalLevelWidth == B.VerticalLevelWidth;
+        bSame &= A.VerticalRangeStart == B.VerticalRangeStart && A.VerticalRangeNum == B.VerticalRangeNum;
+        if(!Test.TestTrue(TEXT("Axes and range layout are restored"), bSame)) return false;
+
+        // distances are stored as fixed point, ranges exactly
+        bool bSameDistances = A.MaxDistanceGrid.Num() == B.MaxDistanceGrid.Num();
+        for (int i = 0; bSameDistances && i < A.MaxDistanceGrid.Num(); ++i)
+        {
+            const bool bComputed = A.MaxDistanceGrid[i] >= 0.0f;
+            bSameDistances = bComputed == (B.MaxDistanceGrid[i] >= 0.0f);
+            if(bComputed) bSameDistances &= FMath::Abs(A.MaxDistanceGrid[i] - B.MaxDistanceGrid[i]) <= 0.5f * FBallLaunchCacheBinary::DistanceQuantum;
+        }
+        bool bSameRanges = A.VerticalRanges.Num() == B.VerticalRanges.Num();
+        for (int i = 0; bSameRanges && i < A.VerticalRanges.Num(); ++i)
+        {
+            const auto& RA = A.VerticalRanges[i];
+            const auto& RB = B.VerticalRanges[i];
+            bSameRanges = RA.LevelIndex == RB.LevelIndex && RA.MinDistanceXY == RB.MinDistanceXY && RA.MaxDistanceXY == RB.MaxDistanceXY;
+        }
+        return Test.TestTrue(TEXT("Distances are restored"), bSameDistances) && Test.TestTrue(TEXT("Vertical ranges are restored exactly"), bSameRanges);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBallLaunchCacheBinaryRoundTripTest, "PhysicsCalculation.PhysicsCache.BallLaunchCacheBinary.RoundTrip",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FBallLaunchCacheBinaryRoundTripTest::RunTest(const FString& Parameters)
+{
+    using namespace BallLaunchCacheBinaryTest;
+
+    const FSpinMovementParams Params = MakeParams();
+    const FBallLaunchCache_Data Data = MakeData(Params);
+
+    // memory archive, every chunk size including one that does not divide number of speeds
+    for (int SpeedsPerChunk = 1; SpeedsPerChunk <= Data.LaunchSpeedHashes.Num(); ++SpeedsPerChunk)
+    {
+        TArray<uint8> Bytes;
+        FMemoryWriter Writer(Bytes);
+        TestTrue(TEXT("Saved to memory"), FBallLaunchCacheBinary::Save(Writer, Data, Params, SpeedsPerChunk));
+
+        FBallLaunchCache_Data Loaded;
+        FMemoryReader Reader(Bytes);
+        TestTrue(TEXT("Loaded from memory"), FBallLaunchCacheBinary::Load(Reader, Loaded));
+        IsSame(*this, Data, Loaded);
+    }
+
+    // file is written through temporary one which does not stay after save
+    const FString Path = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("BallLaunchCacheRoundTrip.bin"));
+    TestTrue(TEXT("Saved to file"), FBallLaunchCacheBinary::SaveToFile(Path, Data, Params, 2));
+    TestFalse(TEXT("Temporary file is removed"), IFileManager::Get().FileExists(*(Path + TEXT(".tmp"))));
+
+    FBallLaunchCache_Data Loaded;
+    TestTrue(TEXT("Loaded from file"), FBallLaunchCacheBinary::LoadFromFile(Path, Loaded));
+    IsSame(*this, Data, Loaded);
+    IFileManager::Get().Delete(*Path);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBallLaunchCacheBinaryValidationTest, "PhysicsCalculation.PhysicsCache.BallLaunchCacheBinary.Validation",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FBallLaunchCacheBinaryValidationTest::RunTest(const FString& Parameters)
+{
+    using namespace BallLaunchCacheBinaryTest;
+
+    const FSpinMovementParams Params = MakeParams();
+    const FBallLaunchCache_Data Data = MakeData(Params);
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    FBallLaunchCacheBinary::Save(Writer, Data, Params, 2);
+
+    // any damaged byte of header (past magic, version and size) or chunks fails load
+    constexpr int64 HeaderBodyStart = 3 * sizeof(uint32);
+    bool bAllDetected = true;
+    for (int64 i = HeaderBodyStart; i < Bytes.Num(); i += 7)
+    {
+        TArray<uint8> Damaged = Bytes;
+        Damaged[i] ^= 0x10;
+        FBallLaunchCache_Data Loaded;
+        FMemoryReader Reader(Damaged);
+        bAllDetected &= !FBallLaunchCacheBinary::Load(Reader, Loaded);
+    }
+    TestTrue(TEXT("Damaged file is rejected"), bAllDetected);
+
+    // same number of values, different values: data was computed for other params
+    FSpinMovementParams ChangedParams = Params;
+    ChangedParams.LaunchAngle.SetMinMaxDelta(1.0f, 7.0f, 1.0f);
+    TArray<uint8> ChangedBytes;
+    FMemoryWriter ChangedWriter(ChangedBytes);
+    TestFalse(TEXT("Params which do not match data are rejected"), FBallLaunchCacheBinary::Save(ChangedWriter, Data, ChangedParams, 2));
+
+    // failed save keeps previous file
+    const FString Path = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("BallLaunchCacheValidation.bin"));
+    TestTrue(TEXT("Saved to file"), FBallLaunchCacheBinary::SaveToFile(Path, Data, Params));
+    TestFalse(TEXT("Save with changed params fails"), FBallLaunchCacheBinary::SaveToFile(Path, Data, ChangedParams));
+    FBallLaunchCache_Data Loaded;
+    TestTrue(TEXT("Previous file is intact"), FBallLaunchCacheBinary::LoadFromFile(Path, Loaded));
+    IFileManager::Get().Delete(*Path);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBallLaunchCacheRangeLimitTest, "PhysicsCalculation.PhysicsCache.BallLaunchCacheBinary.RangeLimit",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FBallLaunchCacheRangeLimitTest::RunTest(const FString& Parameters)
+{
+    using namespace BallLaunchCacheBinaryTest;
+
+    FBallLaunchCache_Data Data = MakeData(MakeParams());
+    const FBallLaunchParamsHashed Hash(Data.LaunchSpeedHashes[0], Data.LaunchAngleHashes[0], Data.FrontSpinAngleHashes[0], Data.SideSpinAngleHashes[0]);
+    const int Cell = Data.GetGridCellIndex(Hash);
+    Data.VerticalRangeNum[Cell] = 0;
+    const int NumRanges = Data.VerticalRanges.Num();
+
+    FBallLaunchVerticalDistribution Distribution;
+    for (int i = 0; i <= FBallLaunchCache_Data::MaxRangesPerCell; ++i) Distribution.AddItem(0, i, i + 1.0f);
+    TestFalse(TEXT("Distribution over range limit is rejected"), Data.AddVerticalDistribution(Hash, Distribution));
+    TestEqual(TEXT("Rejected distribution adds no ranges"), Data.VerticalRanges.Num(), NumRanges);
+    TestEqual(TEXT("Cell is left without ranges"), static_cast<int>(Data.VerticalRangeNum[Cell]), 0);
+
+    Distribution.Map[0].Data.SetNum(FBallLaunchCache_Data::MaxRangesPerCell);
+    TestTrue(TEXT("Distribution at range limit is added"), Data.AddVerticalDistribution(Hash, Distribution));
+    TestEqual(TEXT("Cell holds all ranges"), static_cast<int>(Data.VerticalRangeNum[Cell]), FBallLaunchCache_Data::MaxRangesPerCell);
+    return true;
+}
+
+#endif
@@ -0,0 +1,86 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Collision/CollisionBroadphase.h"
+#include "Components/CustomPhysicsBaseComponent.h"
+#include "Components/SphereComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CollisionBroadphaseTest
+{
+    // static object with bounds set directly; it is neither registered nor placed into world
+    UCustomPhysicsBaseComponent* MakeObject(const FVector& Location, float Radius)
+    {
+        USphereComponent* Sphere = NewObject<USphereComponent>();
+        Sphere->Bounds = FBoxSphereBounds(Location, FVector(Radius), Radius);
+        UCustomPhysicsBaseComponent* Obj = NewObject<UCustomPhysicsBaseComponent>();
+        Obj->SetPrimitiveComponent(Sphere);
+        return Obj;
+    }
+
+    void BruteForceQuery(const TArray<UCustomPhysicsBaseComponent*>& Objects, const FBox& Box, TArray<int>& OutIndices)
+    {
+        OutIndices.Reset();
+        for (int i = 0; i < Objects.Num(); ++i)
+        {
+            if(Objects[i]->GetPrimitiveComponent()->Bounds.GetBox().Intersect(Box)) OutIndices.Add(i);
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCollisionBroadphaseReuseTest, "PhysicsCalculation.Collision.Broadphase.Reuse",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCollisionBroadphaseReuseTest::RunTest(const FString& Parameters)
+{
+    using namespace CollisionBroadphaseTest;
+
+    FRandomStream Random(16);
+    TArray<UCustomPhysicsBaseComponent*> Objects;
+    for (int i = 0; i < 200; ++i)
+    {
+        Objects.Add(MakeObject(Random.GetUnitVector() * Random.FRandRange(0.0f, 3000.0f), Random.FRandRange(10.0f, 150.0f)));
+    }
+    // ground like object which always goes to oversized list
+    Objects.Add(MakeObject(FVector::ZeroVector, 10000.0f));
+
+    // same set and cell size in steady state; values below clamp limit must not rebuild either
+    FCollisionBroadphase Broadphase;
+    Broadphase.Update(Objects, 200.0f);
+    Broadphase.Update(Objects, 200.0f);
+    TestEqual(TEXT("Unchanged objects keep grid"), Broadphase.NumRebuilds, 1);
+    Broadphase.Update(Objects, 0.5f);
+    Broadphase.Update(Objects, 0.5f);
+    TestEqual(TEXT("Clamped cell size keeps grid"), Broadphase.NumRebuilds, 2);
+    Broadphase.Update(Objects, 200.0f);
+
+    TArray<FBox> Boxes;
+    for (int i = 0; i < 1000; ++i)
+    {
+        Boxes.Add(FBox::BuildAABB(Random.GetUnitVector() * Random.FRandRange(0.0f, 3000.0f), FVector(Random.FRandRange(10.0f, 300.0f))));
+    }
+
+    // first pass grows caller owned buffer up to largest query
+    TArray<int> Candidates;
+    TArray<int> Expected;
+    bool bSameResults = true;
+    for (const auto& Box : Boxes)
+    {
+        Broadphase.Query(Box, Candidates);
+        BruteForceQuery(Objects, Box, Expected);
+        bSameResults &= Candidates == Expected;
+    }
+    TestTrue(TEXT("Query matches brute force"), bSameResults);
+
+    // steady state: same queries run without any allocation
+    const int* CandidatesData = Candidates.GetData();
+    const SIZE_T CandidatesSize = Candidates.GetAllocatedSize();
+    for (const auto& Box : Boxes)
+    {
+        Broadphase.Query(Box, Candidates);
+    }
+    TestTrue(TEXT("Query does not reallocate candidates"), Candidates.GetData() == CandidatesData && Candidates.GetAllocatedSize() == CandidatesSize);
+    return true;
+}
+
+#endif
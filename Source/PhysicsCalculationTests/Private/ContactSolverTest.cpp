@@ -0,0 +1,118 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Collision/ContactSolver.h"
+#include "Libs/PhysicsAccuracyScenarios.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ContactSolverTest
+{
+    constexpr float Radius = 11.0f;
+    constexpr float Mass = 0.45f;
+    constexpr float Friction = 0.5f;
+    constexpr float Restitution = 0.3f;
+    constexpr float DeltaTime = 1.0f / 120.0f;
+    constexpr float Gravity = 980.0f;
+
+    FContactSolverBody MakeBall()
+    {
+        // solid sphere
+        const float InertiaInv = 1.0f / (0.4f * Mass * Radius * Radius);
+        
+        FContactSolverBody Ball;
+        Ball.MassInv = 1.0f / Mass;
+        Ball.InertiaInv = FSimpleMatrix3(FVector(InertiaInv, 0, 0), FVector(0, InertiaInv, 0), FVector(0, 0, InertiaInv));
+        return Ball;
+    }
+
+    FContactSolverContact MakeContact(int BodyA, int BodyB, const FVector& Point, const FVector& Normal)
+    {
+        FContactSolverContact C;
+        C.BodyA = BodyA;
+        C.BodyB = BodyB;
+        C.Point = Point;
+        C.Normal = Normal;
+        C.Penetration = 0.5f;
+        return C;
+    }
+
+    // largest approaching normal velocity left at contacts
+    float GetPenetratingVelocity(const FContactSolver& Solver, const TArray<FContactSolverContact>& Contacts)
+    {
+        float Out = 0.0f;
+        for (const auto& C : Contacts)
+        {
+            const FVector RelativeVelocity = Solver.Bodies[C.BodyB].GetVelocityAtPoint(C.Point) - Solver.Bodies[C.BodyA].GetVelocityAtPoint(C.Point);
+            Out = FMath::Max(Out, -(RelativeVelocity | C.Normal));
+        }
+        return Out;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FContactSolverPinchTest, "PhysicsCalculation.Collision.ContactSolver.Pinch",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FContactSolverPinchTest::RunTest(const FString& Parameters)
+{
+    using namespace ContactSolverTest;
+
+    constexpr int NumIterations = 32;
+    const auto Rows = FPhysicsAccuracyScenarios::MeasureContactSolverAccuracy(MakeBall(), Radius, Friction, Restitution, DeltaTime, {NumIterations}, 0);
+    
+    int NumPinches = 0;
+    for (const auto& Row : Rows)
+    {
+        if(!Row.Name.StartsWith(TEXT("pinch"))) continue;
+        
+        NumPinches++;
+        AddInfo(Row.ToString());
+        // ball does not keep moving into post, ground or bodies, and result does not depend on contact order
+        TestTrue(Row.Name + TEXT(": no penetrating velocity"), Row.PenetratingVelocity < 0.5f);
+        TestTrue(Row.Name + TEXT(": order independent"), Row.OrderDifference < 5.0f);
+    }
+    TestEqual(TEXT("Both pinch scenarios are measured"), NumPinches, 2);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FContactSolverStackTest, "PhysicsCalculation.Collision.ContactSolver.Stack",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FContactSolverStackTest::RunTest(const FString& Parameters)
+{
+    using namespace ContactSolverTest;
+
+    // two balls resting on each other on ground; few iterations do not hold the stack without warm start
+    constexpr int NumIterations = 4;
+    constexpr int NumSteps = 120;
+
+    FContactSolverBody Bottom = MakeBall();
+    Bottom.Location = FVector(0, 0, Radius);
+    FContactSolverBody Top = MakeBall();
+    Top.Location = FVector(0, 0, 3.0f * Radius);
+    
+    const TArray<FContactSolverBody> Bodies = {FContactSolverBody(), Bottom, Top};
+    const TArray<FContactSolverContact> Contacts = {MakeContact(0, 1, FVector::ZeroVector, FVector::UpVector),
+                                                    MakeContact(1, 2, FVector(0, 0, 2.0f * Radius), FVector::UpVector)};
+
+    FContactSolver Warm;
+    Warm.NumIterations = NumIterations;
+    Warm.bWarmStart = true;
+    FPhysicsAccuracyScenarios::SolveContactScenario(Bodies, Contacts, Friction, Restitution, Gravity * DeltaTime, NumSteps, false, Warm);
+
+    FContactSolver Cold;
+    Cold.NumIterations = NumIterations;
+    Cold.bWarmStart = false;
+    FPhysicsAccuracyScenarios::SolveContactScenario(Bodies, Contacts, Friction, Restitution, Gravity * DeltaTime, NumSteps, false, Cold);
+
+    const float WarmVelocity = GetPenetratingVelocity(Warm, Contacts);
+    const float ColdVelocity = GetPenetratingVelocity(Cold, Contacts);
+    AddInfo(FString::Printf(TEXT("penetrating velocity: warm start %f, cold start %f cm/sec"), WarmVelocity, ColdVelocity));
+    
+    TestTrue(TEXT("Warm started stack is at rest"), WarmVelocity < 0.01f);
+    TestTrue(TEXT("Warm start is not worse than cold start"), WarmVelocity <= ColdVelocity);
+    TestEqual(TEXT("Impulses of both contacts are kept"), Warm.Cache.Num(), Contacts.Num());
+    TestEqual(TEXT("Cold start keeps no impulses"), Cold.Cache.Num(), 0);
+    return true;
+}
+
+#endif
@@ -0,0 +1,125 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Common/PhysSimParams.h"
+#include "Common/RoughPredictionJob.h"
+#include "Libs/BallGroundMovementData.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GroundRollTest
+{
+    constexpr float Radius = 11.0f;
+    constexpr float Friction = 0.5f;
+    constexpr float Restitution = 0.3f;
+    constexpr float DeltaTime = 1.0f / 120.0f;
+    constexpr int NumSteps = 120;
+
+    // damping makes rolling speed decrease, so table lookup by speed is well defined
+    FPhysRigidBodyParams MakeParams()
+    {
+        FPhysRigidBodyParams P;
+        P.Radius = Radius;
+        P.Mass = 0.45f;
+        P.Shape = Sphere;
+        P.GravityZ = -980.0f;
+        P.bGravityEnabled = true;
+        P.LinearDamping.bEnabled = true;
+        P.LinearDamping.Value = 0.3f;
+        P.AngularDamping.bEnabled = true;
+        P.AngularDamping.Value = 0.3f;
+        P.Aerodynamics.AirDragImpact.bEnabled = false;
+        P.Aerodynamics.MagnusImpact.bEnabled = false;
+        return P;
+    }
+
+    // horizontal distance and speed of stepped and tabulated movement after NumSteps
+    void Compare(const FBallGroundMovementData& Table, const FPhysRigidBodyParams& P, float Speed, bool bSliding,
+                 float& OutSteppedDistance, float& OutLocationError, float& OutSpeedError)
+    {
+        FRoughPredictionInput In;
+        FBallGroundMovementData::MakeGroundContactInput(P, Friction, Restitution, DeltaTime, In);
+        const FPhysSimParams SimParams(In.RbParams);
+        FContactSolver Solver;
+
+        const FVector AngularVelocity = bSliding ? FVector::ZeroVector : FVector(0, Speed / Radius, 0);
+        const FPhysTransform Start = FPhysTransform(FVector(0, 0, Radius), FQuat::Identity, FVector(Speed, 0, 0), AngularVelocity);
+        
+        FPhysTransform Stepped = Start;
+        for (int i = 0; i < NumSteps; ++i)
+        {
+            FPhysTransform NewT;
+            FRoughPredictionJob::SimulateStep(In, SimParams, Stepped, Solver, NewT);
+            Stepped = NewT;
+        }
+
+        FPhysTransform Tabulated;
+        Table.AdvanceOnGround(Start, NumSteps * DeltaTime, Friction, Tabulated);
+
+        OutSteppedDistance = Stepped.Location.X;
+        OutLocationError = FVector::Dist2D(Stepped.Location, Tabulated.Location);
+        OutSpeedError = FMath::Abs(Stepped.LinearVelocity.Size2D() - Tabulated.LinearVelocity.Size2D());
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGroundRollAccuracyTest, "PhysicsCalculation.Prediction.GroundRoll.Accuracy",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGroundRollAccuracyTest::RunTest(const FString& Parameters)
+{
+    using namespace GroundRollTest;
+
+    const FPhysRigidBodyParams P = MakeParams();
+    FBallGroundMovementData Table;
+    Table.GroundFriction = Friction;
+    Table.GroundRestitution = Restitution;
+    Table.Simulate(P, DeltaTime);
+    if(!TestTrue(TEXT("Table is built"), Table.IsValid())) return false;
+
+    for (const float Speed : {300.0f, 1000.0f, 3000.0f})
+    {
+        for (const bool bSliding : {false, true})
+        {
+            float Distance, LocationError, SpeedError;
+            Compare(Table, P, Speed, bSliding, Distance, LocationError, SpeedError);
+            AddInfo(FString::Printf(TEXT("Speed %f, sliding %d: distance %f, location error %f, speed error %f"),
+                                    Speed, bSliding, Distance, LocationError, SpeedError));
+
+            // sliding is closed form, which neglects stepping of friction impulses
+            const float Tolerance = bSliding ? 0.05f : 0.01f;
+            TestTrue(TEXT("Location matches stepped model"), LocationError <= Distance * Tolerance + 1.0f);
+            TestTrue(TEXT("Speed matches stepped model"), SpeedError <= Speed * Tolerance + 2.0f);
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGroundRollSignatureTest, "PhysicsCalculation.Prediction.GroundRoll.Signature",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGroundRollSignatureTest::RunTest(const FString& Parameters)
+{
+    using namespace GroundRollTest;
+
+    const FPhysRigidBodyParams P = MakeParams();
+    const uint32 ParamsSignature = FBallGroundMovementData::MakeParamsSignature(P, DeltaTime);
+    const uint32 Signature = FBallGroundMovementData::MakeSignature(ParamsSignature, Friction, Restitution);
+    TestEqual(TEXT("Same values give same signature"), FBallGroundMovementData::MakeSignature(FBallGroundMovementData::MakeParamsSignature(P, DeltaTime), Friction, Restitution), Signature);
+    
+    TestNotEqual(TEXT("Ground friction changes signature"), FBallGroundMovementData::MakeSignature(ParamsSignature, 0.2f, Restitution), Signature);
+    TestNotEqual(TEXT("Ground restitution changes signature"), FBallGroundMovementData::MakeSignature(ParamsSignature, Friction, 0.6f), Signature);
+    TestNotEqual(TEXT("Step changes signature"), FBallGroundMovementData::MakeParamsSignature(P, DeltaTime * 0.5f), ParamsSignature);
+    TestNotEqual(TEXT("Contact solver changes signature"), FBallGroundMovementData::MakeParamsSignature(P, DeltaTime, 8, false), ParamsSignature);
+    TestNotEqual(TEXT("Warm start changes signature"), FBallGroundMovementData::MakeParamsSignature(P, DeltaTime, 8, true),
+                 FBallGroundMovementData::MakeParamsSignature(P, DeltaTime, 8, false));
+
+    FPhysRigidBodyParams Heavier = P;
+    Heavier.Mass *= 2.0f;
+    TestNotEqual(TEXT("Mass changes signature"), FBallGroundMovementData::MakeParamsSignature(Heavier, DeltaTime), ParamsSignature);
+
+    FPhysRigidBodyParams Damped = P;
+    Damped.LinearDamping.Value *= 2.0f;
+    TestNotEqual(TEXT("Damping changes signature"), FBallGroundMovementData::MakeParamsSignature(Damped, DeltaTime), ParamsSignature);
+    return true;
+}
+
+#endif
@@ -0,0 +1,174 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Common/IndexedTrajectory.h"
+#include "Common/TrajectoryData.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace IndexedTrajectoryTest
+{
+    constexpr float PolylineStep = 0.1f;
+    
+    // goes away from start, reaches apex at key 2, then comes back towards start to the ground
+    FIndexedTrajectory MakePolyline()
+    {
+        return FIndexedTrajectory({FVector(0, 0, 0), FVector(100, 0, 50), FVector(200, 0, 80), FVector(300, 0, 50), FVector(200, 0, 0)}, PolylineStep);
+    }
+
+    // ball flight without drag, sampled like prediction: stops at the first key below ground
+    TArray<FVector> MakeParabola(float TimeStep)
+    {
+        const FVector Velocity(1000.0f, 300.0f, 1000.0f);
+        const FVector Gravity(0.0f, 0.0f, -980.0f);
+        TArray<FVector> Out;
+        for (int i = 0;; ++i)
+        {
+            const float Time = i * TimeStep;
+            Out.Add(Velocity * Time + 0.5f * Gravity * Time * Time);
+            if(Out.Last().Z < 0.0f) break;
+        }
+        return Out;
+    }
+
+    bool AreTimesNear(const TArray<float>& A, const TArray<float>& B, float Tolerance)
+    {
+        if(A.Num() != B.Num()) return false;
+        for (int i = 0; i < A.Num(); ++i)
+        {
+            if(!FMath::IsNearlyEqual(A[i], B[i], Tolerance)) return false;
+        }
+        return true;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FIndexedTrajectoryBoundaryTest, "PhysicsCalculation.Prediction.IndexedTrajectory.Boundaries",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FIndexedTrajectoryBoundaryTest::RunTest(const FString& Parameters)
+{
+    using namespace IndexedTrajectoryTest;
+    constexpr float Tolerance = 1e-3f;
+
+    const FIndexedTrajectory Empty;
+    float Time;
+    TestTrue(TEXT("Empty trajectory returns zero location"), Empty.GetLocationAtTime(1.0f).IsZero());
+    TestFalse(TEXT("Empty trajectory has no time at distance"), Empty.GetTimeAtDistanceXY(0.0f, Time));
+    TestEqual(TEXT("Empty trajectory closest time"), Empty.GetClosestTime(FVector::OneVector), 0.0f);
+
+    const FIndexedTrajectory Trajectory = MakePolyline();
+    const auto& Keys = Trajectory.GetLocations();
+    TestEqual(TEXT("Duration"), Trajectory.GetDuration(), 4 * PolylineStep, Tolerance);
+    TestEqual(TEXT("Max Z time"), Trajectory.GetMaxZTime(), 2 * PolylineStep, Tolerance);
+
+    // location: clamped outside of samples, exact on samples, linear between them
+    TestTrue(TEXT("Before the first sample"), Trajectory.GetLocationAtTime(-PolylineStep).Equals(Keys[0], Tolerance));
+    TestTrue(TEXT("After the last sample"), Trajectory.GetLocationAtTime(10.0f).Equals(Keys.Last(), Tolerance));
+    bool bOnSamples = true;
+    for (int i = 0; i < Keys.Num(); ++i)
+    {
+        bOnSamples &= Trajectory.GetLocationAtTime(i * PolylineStep).Equals(Keys[i], Tolerance);
+    }
+    TestTrue(TEXT("Exactly on samples"), bOnSamples);
+    TestTrue(TEXT("Between samples"), Trajectory.GetLocationAtTime(1.5f * PolylineStep).Equals(FVector(150, 0, 65), Tolerance));
+
+    // XY distance: 0, 100, 200, 300, 200
+    TestTrue(TEXT("Distance of the first sample"), Trajectory.GetTimeAtDistanceXY(0.0f, Time) && FMath::IsNearlyEqual(Time, 0.0f, Tolerance));
+    TestTrue(TEXT("Distance of sample is found at its first crossing"), Trajectory.GetTimeAtDistanceXY(200.0f, Time) && FMath::IsNearlyEqual(Time, 2 * PolylineStep, Tolerance));
+    TestTrue(TEXT("Max distance is found at turn"), Trajectory.GetTimeAtDistanceXY(300.0f, Time) && FMath::IsNearlyEqual(Time, 3 * PolylineStep, Tolerance));
+    TestTrue(TEXT("Distance between samples"), Trajectory.GetTimeAtDistanceXY(250.0f, Time) && FMath::IsNearlyEqual(Time, 2.5f * PolylineStep, Tolerance));
+    TestFalse(TEXT("Distance beyond trajectory"), Trajectory.GetTimeAtDistanceXY(300.5f, Time));
+    TestFalse(TEXT("Negative distance"), Trajectory.GetTimeAtDistanceXY(-1.0f, Time));
+
+    // Z: 0, 50, 80, 50, 0
+    TArray<float> Times;
+    TestTrue(TEXT("Apex is found once"), Trajectory.GetTimesAtZ(80.0f, Times) && AreTimesNear(Times, {2 * PolylineStep}, Tolerance));
+    TestTrue(TEXT("Z of samples on both sides"), Trajectory.GetTimesAtZ(50.0f, Times) && AreTimesNear(Times, {PolylineStep, 3 * PolylineStep}, Tolerance));
+    TestTrue(TEXT("Z of the first and the last sample"), Trajectory.GetTimesAtZ(0.0f, Times) && AreTimesNear(Times, {0.0f, 4 * PolylineStep}, Tolerance));
+    TestFalse(TEXT("Z above apex"), Trajectory.GetTimesAtZ(80.5f, Times));
+    TestTrue(TEXT("Last time at ground is the last sample"), Trajectory.GetLastTimeAtZ(0.0f, Time) && FMath::IsNearlyEqual(Time, 4 * PolylineStep, Tolerance));
+    TestTrue(TEXT("Last time between samples"), Trajectory.GetLastTimeAtZ(25.0f, Time) && FMath::IsNearlyEqual(Time, 3.5f * PolylineStep, Tolerance));
+
+    // closest point: on sample, on chord and beyond both ends
+    TestEqual(TEXT("Closest to sample"), Trajectory.GetClosestTime(FVector(300, 100, 50)), 3 * PolylineStep, Tolerance);
+    TestTrue(TEXT("Closest on chord"), Trajectory.GetClosestLocation(FVector(50, 0, 100)).Equals(FVector(80, 0, 40), Tolerance));
+    TestEqual(TEXT("Closest before start"), Trajectory.GetClosestTime(FVector(-100, -100, -10)), 0.0f, Tolerance);
+    TestEqual(TEXT("Closest past end"), Trajectory.GetClosestTime(FVector(200, 0, -100)), 4 * PolylineStep, Tolerance);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FIndexedTrajectoryCurveAgreementTest, "PhysicsCalculation.Prediction.IndexedTrajectory.CurveAgreement",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FIndexedTrajectoryCurveAgreementTest::RunTest(const FString& Parameters)
+{
+    using namespace IndexedTrajectoryTest;
+    
+    constexpr float TimeStep = 0.01f;
+    const TArray<FVector> Keys = MakeParabola(TimeStep);
+    const FCustomVectorCurve Curve(Keys, TimeStep);
+    const FIndexedTrajectory Trajectory(Keys, TimeStep);
+
+    // curve interpolation may differ from chords; deviation of parabola from chord is below 0.02 cm at this step
+    constexpr float LocationTolerance = 0.05f;
+    float MaxLocationError = 0.0f;
+    for (int i = 0; i < 2 * Keys.Num() - 1; ++i)
+    {
+        const float Time = 0.5f * i * TimeStep;
+        MaxLocationError = FMath::Max(MaxLocationError, (Trajectory.GetLocationAtTime(Time) - Curve.GetVectorValue(Time)).Size());
+    }
+    AddInfo(FString::Printf(TEXT("Max location error: %f"), MaxLocationError));
+    TestTrue(TEXT("Locations on samples and between them agree"), MaxLocationError <= LocationTolerance);
+    TestTrue(TEXT("Start location agrees"), Trajectory.GetStartLocation().Equals(Curve.GetValueAtZero(), LocationTolerance));
+    TestEqual(TEXT("Max Z time agrees"), Trajectory.GetMaxZTime(), Curve.GetMaxZTime(), TimeStep);
+
+    // crossings are interpolated by both, so times agree within fraction of step
+    constexpr float TimeTolerance = 0.5f * TimeStep;
+    const float MaxZ = Keys[FMath::RoundToInt(Trajectory.GetMaxZTime() / TimeStep)].Z;
+    bool bTimesAgree = true;
+    for (const float Z : {1.0f, 100.0f, 0.5f * MaxZ, MaxZ - 1.0f})
+    {
+        TArray<float> IndexTimes, CurveTimes;
+        const bool bIndex = Trajectory.GetTimesAtZ(Z, IndexTimes);
+        const bool bCurve = Curve.GetTimesWhenZEquals(Z, CurveTimes);
+        bTimesAgree &= bIndex == bCurve && AreTimesNear(IndexTimes, CurveTimes, TimeTolerance);
+    }
+    TestTrue(TEXT("Times at Z agree"), bTimesAgree);
+
+    float IndexGroundTime, CurveGroundTime;
+    const bool bIndexGround = Trajectory.GetLastTimeAtZ(0.0f, IndexGroundTime);
+    const bool bCurveGround = Curve.GetLastTimeWhenZEquals(CurveGroundTime, 0.0f);
+    TestTrue(TEXT("Ground is found by both"), bIndexGround && bCurveGround);
+    TestEqual(TEXT("Ground time agrees"), IndexGroundTime, CurveGroundTime, TimeTolerance);
+
+    // curve lookup takes the closest key, index projects on chords: index is never farther and stays within one step of travel
+    bool bClosestAgree = true;
+    for (const FVector& Target : {FVector(500, 100, 600), FVector(1500, 450, 0), FVector(2100, 0, 200), FVector(-100, 0, 0)})
+    {
+        FTrajectoryData CurveData;
+        CurveData.Init(FPhysTransform(), Curve, Target);
+        FTrajectoryData IndexData;
+        IndexData.Init(FPhysTransform(), Curve, Target, TimeStep);
+
+        const FVector CurveClosest = CurveData.GetVectorOfMinDistance();
+        const FVector IndexClosest = IndexData.GetVectorOfMinDistance();
+        const float StepTravel = 2000.0f * TimeStep;
+        bClosestAgree &= FVector::Dist(IndexClosest, Target) <= FVector::Dist(CurveClosest, Target) + LocationTolerance;
+        bClosestAgree &= FVector::Dist(IndexClosest, CurveClosest) <= StepTravel;
+    }
+    TestTrue(TEXT("Closest points agree"), bClosestAgree);
+
+    // lookups of rotated trajectory match rotated curve
+    FIndexedTrajectory Rotated = Trajectory;
+    FCustomVectorCurve RotatedCurve = Curve;
+    const FQuat Q(FVector::UpVector, PI / 3.0f);
+    Rotated.RotateByQuat(Q);
+    RotatedCurve.RotateByQuat(Q);
+    const float Time = 0.37f;
+    TestTrue(TEXT("Rotated locations agree"), Rotated.GetLocationAtTime(Time).Equals(RotatedCurve.GetVectorValue(Time), LocationTolerance));
+    float RotatedDistanceTime, DistanceTime;
+    TestTrue(TEXT("Rotation keeps distance lookups"), Rotated.GetTimeAtDistanceXY(800.0f, RotatedDistanceTime) && Trajectory.GetTimeAtDistanceXY(800.0f, DistanceTime)
+             && FMath::IsNearlyEqual(RotatedDistanceTime, DistanceTime, 1e-3f));
+    return true;
+}
+
+#endif
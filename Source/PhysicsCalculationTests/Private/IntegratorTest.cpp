@@ -0,0 +1,108 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Aerodynamics/AirDrag.h"
+#include "Common/PhysSimParams.h"
+#include "Libs/PhysicsSimulation.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace IntegratorTest
+{
+    constexpr float Gravity = 980.0f;
+    constexpr float TerminalSpeed = 3000.0f;
+    constexpr float SimTime = 2.0f;
+    constexpr int NumSteps = 120;
+
+    /*
+     * Ball falling from rest with quadratic drag: a = g - K * v^2, K = g / TerminalSpeed^2.
+     * Analytic solution: v = Vt * tanh(g * t / Vt), distance = Vt^2 / g * ln(cosh(g * t / Vt))
+     */
+    void SimulateFall(EPhysIntegrator Integrator, const FAirDrag& AirDrag, float& OutDistanceError, float& OutSpeedError)
+    {
+        FPhysSimParams SimParams;
+        SimParams.Gravity = FVector(0.0f, 0.0f, -Gravity);
+        SimParams.AirDrag = AirDrag;
+        SimParams.bDrag = true;
+        SimParams.DragFactor = Gravity / (TerminalSpeed * TerminalSpeed);
+        SimParams.Integrator = Integrator;
+
+        FPhysTransform T;
+        const float DeltaTime = SimTime / NumSteps;
+        for (int i = 0; i < NumSteps; ++i)
+        {
+            UPhysicsSimulation::PhysicsSimulateDelta(SimParams, DeltaTime, T);
+        }
+
+        const float X = Gravity * SimTime / TerminalSpeed;
+        const float Distance = TerminalSpeed * TerminalSpeed / Gravity * FMath::Loge(0.5f * (FMath::Exp(X) + FMath::Exp(-X)));
+        const float Speed = TerminalSpeed * (FMath::Exp(X) - FMath::Exp(-X)) / (FMath::Exp(X) + FMath::Exp(-X));
+        OutDistanceError = FMath::Abs(-T.Location.Z - Distance);
+        OutSpeedError = FMath::Abs(-T.LinearVelocity.Z - Speed);
+    }
+
+    float GetRotationError(bool bExponentialMap)
+    {
+        FPhysSimParams SimParams;
+        SimParams.bExponentialMapRotation = bExponentialMap;
+
+        // one full turn and a quarter about tilted axis
+        const FVector Axis = FVector(1.0f, 2.0f, 3.0f).GetSafeNormal();
+        const float Angle = 2.5f * PI;
+        FPhysTransform T;
+        T.AngularVelocity = Axis * (Angle / SimTime);
+        for (int i = 0; i < NumSteps; ++i)
+        {
+            UPhysicsSimulation::UpdateTransformOrientation(SimParams, SimTime / NumSteps, T);
+        }
+        return T.Orientation.AngularDistance(FQuat(Axis, Angle));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FIntegratorAccuracyTest, "PhysicsCalculation.Simulation.Integrator.Accuracy",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FIntegratorAccuracyTest::RunTest(const FString& Parameters)
+{
+    using namespace IntegratorTest;
+
+    // unit drag coefficient at any speed
+    FAirDrag AirDrag;
+    AirDrag.AirDragCurve = NewObject<UCurveVector>();
+    AirDrag.AirDragCurve->FloatCurves[0].AddKey(0.0f, 1.0f);
+    AirDrag.UpdateCoefficientTable();
+
+    float EulerDistance, EulerSpeed, VerletDistance, VerletSpeed, RK4Distance, RK4Speed;
+    SimulateFall(SemiImplicitEuler, AirDrag, EulerDistance, EulerSpeed);
+    SimulateFall(VelocityVerlet, AirDrag, VerletDistance, VerletSpeed);
+    SimulateFall(RungeKutta4, AirDrag, RK4Distance, RK4Speed);
+    AddInfo(FString::Printf(TEXT("Distance error (cm): Euler %f, Verlet %f, RK4 %f"), EulerDistance, VerletDistance, RK4Distance));
+    AddInfo(FString::Printf(TEXT("Speed error (cm/s): Euler %f, Verlet %f, RK4 %f"), EulerSpeed, VerletSpeed, RK4Speed));
+
+    // first order: error of semi-implicit Euler is about g * dt * t / 2
+    TestTrue(TEXT("Euler error has expected order"), EulerDistance > 5.0f && EulerDistance < 30.0f);
+    TestTrue(TEXT("Verlet is more accurate than Euler"), VerletDistance * 10.0f < EulerDistance);
+    TestTrue(TEXT("Verlet distance error is small"), VerletDistance < 0.5f);
+    TestTrue(TEXT("RK4 distance error is small"), RK4Distance < 0.1f);
+    TestTrue(TEXT("Verlet speed error is small"), VerletSpeed < 0.5f);
+    TestTrue(TEXT("RK4 speed error is small"), RK4Speed < 0.1f);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FIntegratorRotationTest, "PhysicsCalculation.Simulation.Integrator.Rotation",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FIntegratorRotationTest::RunTest(const FString& Parameters)
+{
+    using namespace IntegratorTest;
+
+    const float DerivativeError = GetRotationError(false);
+    const float ExpMapError = GetRotationError(true);
+    AddInfo(FString::Printf(TEXT("Rotation error (rad): derivative %f, exponential map %f"), DerivativeError, ExpMapError));
+
+    TestTrue(TEXT("Exponential map follows constant angular velocity"), ExpMapError < 1e-3f);
+    TestTrue(TEXT("Exponential map is more accurate than derivative"), ExpMapError < DerivativeError);
+    TestTrue(TEXT("Default rotation is derivative based"), !FPhysSimParams().bExponentialMapRotation);
+    return true;
+}
+
+#endif
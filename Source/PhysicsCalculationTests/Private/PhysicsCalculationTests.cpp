@@ -0,0 +1,7 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+// automation tests of PhysicsCalculation; module has no runtime code
+IMPLEMENT_MODULE(FDefaultModuleImpl, PhysicsCalculationTests)
@@ -0,0 +1,183 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Collision/PredictionContacts.h"
+#include "Components/BoxComponent.h"
+#include "Components/CustomPhysicsComponent.h"
+#include "Components/CustomPhysicsProcessor.h"
+#include "Components/StaticMeshComponent.h"
+#include "DataAssets/CustomPhysicsParamsDataAsset.h"
+#include "DataAssets/PhysPredictSettings_DataAsset.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ProcessorScratchTest
+{
+    constexpr float Radius = 11.0f;
+    constexpr int NumWarmUpTicks = 8;
+    constexpr int NumSteadyTicks = 64;
+
+    // ball resting on ground with a bit of penetration, so every substep has a contact
+    const FVector RestingLocation = FVector(0.0f, 0.0f, Radius - 0.5f);
+    // ball flying into wall fast enough to be swept every substep
+    const FVector WallLocation = FVector(1000.0f, 0.0f, 500.0f);
+    const FVector WallExtent = FVector(10.0f, 500.0f, 500.0f);
+    const FVector SweptLocation = WallLocation - FVector(WallExtent.X + Radius + 60.0f, 0.0f, 0.0f);
+    const FVector SweptVelocity = FVector(3000.0f, 0.0f, 0.0f);
+
+    /*
+     * Processor with two balls and two static boxes in a transient game world;
+     * objects are subscribed directly, so test does not depend on lookup of processor in playable worlds
+     */
+    struct FScene
+    {
+        UWorld* World = nullptr;
+        UCustomPhysicsProcessor* Processor = nullptr;
+        UCustomPhysicsComponent* RestingBall = nullptr;
+        UCustomPhysicsComponent* SweptBall = nullptr;
+
+        FScene()
+        {
+            World = UWorld::CreateWorld(EWorldType::Game, false);
+            FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+            Context.SetCurrentWorld(World);
+
+            AActor* ProcessorActor = World->SpawnActor<AActor>();
+            Processor = NewObject<UCustomPhysicsProcessor>(ProcessorActor);
+            Processor->RegisterComponent();
+
+            AddStaticBox(FVector(0.0f, 0.0f, -10.0f), FVector(2000.0f, 2000.0f, 10.0f));
+            AddStaticBox(WallLocation, WallExtent);
+            RestingBall = AddBall(RestingLocation);
+            SweptBall = AddBall(SweptLocation);
+        }
+
+        ~FScene()
+        {
+            GEngine->DestroyWorldContext(World);
+            World->DestroyWorld(false);
+        }
+
+        void AddStaticBox(const FVector& Location, const FVector& Extent)
+        {
+            AActor* Actor = World->SpawnActor<AActor>();
+            UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+            Box->SetBoxExtent(Extent);
+            Actor->SetRootComponent(Box);
+            Box->RegisterComponent();
+            Actor->SetActorLocation(Location);
+
+            UCustomPhysicsBaseComponent* Obj = NewObject<UCustomPhysicsBaseComponent>(Actor);
+            Obj->SetPrimitiveComponent(Box);
+            Processor->SubscribeNewObject(Obj);
+        }
+
+        UCustomPhysicsComponent* AddBall(const FVector& Location)
+        {
+            AActor* Actor = World->SpawnActor<AActor>();
+            UStaticMeshComponent* Mesh = NewObject<UStaticMeshComponent>(Actor);
+            Mesh->SetMobility(EComponentMobility::Movable);
+            Actor->SetRootComponent(Mesh);
+            Mesh->RegisterComponent();
+            Actor->SetActorLocation(Location);
+            // radius of ball is taken from scale of its owner
+            Actor->SetActorScale3D(FVector(Radius / 50.0f));
+
+            UCustomPhysicsParamsDataAsset* Params = NewObject<UCustomPhysicsParamsDataAsset>();
+            Params->DefaultOverride.bOverride = true;
+            Params->DefaultOverride.MassInKg = 0.45f;
+
+            // without prediction every substep runs discrete detection and sweep
+            UCustomPhysicsComponent* Ball = NewObject<UCustomPhysicsComponent>(Actor);
+            Ball->bEnablePredictionOnStart = false;
+            Ball->PhysicsData = Params;
+            Ball->PhysicsPredictSettings = NewObject<UPhysPredictSettings_DataAsset>();
+            Ball->RegisterComponent();
+            Actor->DispatchBeginPlay();
+
+            Ball->PhysicsProcessor = Processor;
+            Processor->SubscribeNewObject(Ball);
+            return Ball;
+        }
+
+        // both balls start each tick from the same state, so every tick is the same steady workload
+        void Tick()
+        {
+            RestingBall->SetCurrentTransform(FPhysTransform(RestingLocation, FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), false);
+            SweptBall->SetCurrentTransform(FPhysTransform(SweptLocation, FQuat::Identity, SweptVelocity, FVector::ZeroVector), false);
+            Processor->TickComponent(4.0f * Processor->GetSimDT(), LEVELTICK_All, nullptr);
+        }
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProcessorScratchSteadyStateTest, "PhysicsCalculation.Collision.Scratch.ProcessorSteadyState",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FProcessorScratchSteadyStateTest::RunTest(const FString& Parameters)
+{
+    using namespace ProcessorScratchTest;
+
+    FScene Scene;
+    for (int i = 0; i < NumWarmUpTicks; ++i)
+    {
+        Scene.Tick();
+    }
+
+    // prediction transforms, collision pairs, broadphase candidates, sweep objects and live contact solver
+    const int32 NumReallocations = Scene.Processor->GetScratchReallocationCount();
+    bool bContacts = true;
+    bool bSweepHits = true;
+    for (int i = 0; i < NumSteadyTicks; ++i)
+    {
+        Scene.Tick();
+        bContacts &= Scene.Processor->GetLiveContactCache().Num() > 0;
+        bSweepHits &= Scene.SweptBall->GetCurrentLinearVelocity().X < 0.0f;
+    }
+    TestTrue(TEXT("Resting ball is in contact every tick"), bContacts);
+    TestTrue(TEXT("Fast ball is swept into wall every tick"), bSweepHits);
+    TestEqual(TEXT("Steady substeps do not reallocate"), Scene.Processor->GetScratchReallocationCount(), NumReallocations);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProcessorScratchPredictionTest, "PhysicsCalculation.Collision.Scratch.PredictionSequence",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FProcessorScratchPredictionTest::RunTest(const FString& Parameters)
+{
+    using namespace ProcessorScratchTest;
+
+    FScene Scene;
+    Scene.Tick();
+
+    // predicted sequence of resting ball: colliders are copied and contact is solved every step
+    FPhysPredictionContacts Contacts;
+    Contacts.Reset(Scene.Processor->GetLiveContactCache());
+    FPSI_Data Data = Scene.Processor->MakeDefaultDataForPhysicsIteration(Scene.RestingBall);
+    FPhysTransform T = FPhysTransform(RestingLocation, FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+    auto Step = [&]()
+    {
+        Data.SetTransform(T);
+        Scene.Processor->PredictTransformAnyTime(Data, Contacts, T);
+    };
+    
+    for (int i = 0; i < NumWarmUpTicks; ++i)
+    {
+        Step();
+    }
+    TestTrue(TEXT("Static bodies are copied"), Contacts.Colliders.Num() == 2);
+
+    const FPredictionCollider* CollidersData = Contacts.Colliders.GetData();
+    const SIZE_T ContactsSize = Contacts.GetAllocatedSize();
+    bool bContacts = true;
+    for (int i = 0; i < NumSteadyTicks; ++i)
+    {
+        Step();
+        bContacts &= Contacts.Solver.Cache.Num() > 0;
+    }
+    TestTrue(TEXT("Predicted ball is in contact every step"), bContacts);
+    TestTrue(TEXT("Steady steps do not reallocate"), Contacts.Colliders.GetData() == CollidersData && Contacts.GetAllocatedSize() == ContactsSize);
+    return true;
+}
+
+#endif
@@ -0,0 +1,85 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Aerodynamics/SideforceGenerator.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SideforceGeneratorTest
+{
+    constexpr int NumSteps = 64;
+    
+    FAngularVelocityGenerator MakeGenerator(int32 Seed)
+    {
+        FAngularVelocityGenerator G;
+        G.bEnabled = true;
+        G.MaxAxisValue = 10.0f;
+        G.UpdateTimeInterval = 0.05f;
+        G.SimulationLengthSec = 10.0f;
+        G.Init(Seed);
+        return G;
+    }
+
+    TArray<FVector> MakeSequence(const FAngularVelocityGenerator& G)
+    {
+        TArray<FVector> Out;
+        for (int i = 0; i < NumSteps; ++i)
+        {
+            Out.Add(G.GetProducedVectorAfterStepCount(i));
+        }
+        return Out;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSideforceGeneratorSeedTest, "PhysicsCalculation.Aerodynamics.SideforceGenerator.Seed",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSideforceGeneratorSeedTest::RunTest(const FString& Parameters)
+{
+    using namespace SideforceGeneratorTest;
+
+    const auto Sequence = MakeSequence(MakeGenerator(7));
+    TestTrue(TEXT("Same seed gives same sequence"), Sequence == MakeSequence(MakeGenerator(7)));
+    TestTrue(TEXT("Other seed gives other sequence"), Sequence != MakeSequence(MakeGenerator(8)));
+
+    // kick started on advanced generator begins from the first step again
+    auto G = MakeGenerator(3);
+    G.AdvanceSteps(NumSteps);
+    G.Init(7);
+    TestEqual(TEXT("Init restarts sequence"), G.GetStepIndex(), static_cast<int64>(0));
+    TestTrue(TEXT("Restarted sequence matches"), Sequence == MakeSequence(G));
+
+    bool bInRange = true;
+    for (const auto& V : Sequence)
+    {
+        bInRange &= V.GetAbsMax() <= G.MaxAxisValue;
+    }
+    TestTrue(TEXT("Values are within range"), bInRange);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSideforceGeneratorAdvanceTest, "PhysicsCalculation.Aerodynamics.SideforceGenerator.AdvanceSteps",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSideforceGeneratorAdvanceTest::RunTest(const FString& Parameters)
+{
+    using namespace SideforceGeneratorTest;
+
+    for (const int N : {0, 1, 5, NumSteps})
+    {
+        auto Skipped = MakeGenerator(11);
+        Skipped.AdvanceSteps(N);
+        
+        auto Stepped = MakeGenerator(11);
+        for (int i = 0; i < N; ++i)
+        {
+            Stepped.UpdateOneStep();
+        }
+
+        const FString Name = FString::Printf(TEXT("%d steps"), N);
+        TestEqual(Name + TEXT(": step index"), Skipped.GetStepIndex(), Stepped.GetStepIndex());
+        TestTrue(Name + TEXT(": sequence"), MakeSequence(Skipped) == MakeSequence(Stepped));
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,87 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Collision/CollisionShapeSnapshot.h"
+#include "Libs/PhysicsAccuracyScenarios.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SweepTest
+{
+    constexpr float Radius = 10.0f;
+    constexpr float AlphaTolerance = 1e-4f;
+    constexpr float NormalTolerance = 1e-3f;
+
+    FAnalyticCollisionShape MakeBox(const FVector& Extent)
+    {
+        FAnalyticCollisionShape Box;
+        Box.Type = EAnalyticShapeType::Box;
+        Box.Extent = Extent;
+        return Box;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSweepTimeOfImpactTest, "PhysicsCalculation.Collision.Sweep.TimeOfImpact",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSweepTimeOfImpactTest::RunTest(const FString& Parameters)
+{
+    using namespace SweepTest;
+
+    const FAnalyticCollisionShape Box = MakeBox(FVector(50.0f));
+    float Alpha;
+    FVector Normal;
+
+    // face: contact when center is radius away from face
+    TestTrue(TEXT("Face is hit"), Box.SweepSphere(FVector(-200.0f, 0.0f, 0.0f), FVector(400.0f, 0.0f, 0.0f), Radius, Alpha, Normal));
+    TestEqual(TEXT("Face time of impact"), Alpha, 140.0f / 400.0f, AlphaTolerance);
+    TestTrue(TEXT("Face normal"), Normal.Equals(FVector(-1.0f, 0.0f, 0.0f), NormalTolerance));
+
+    // almost grazing: center passes 9 cm above top face, so sphere touches its edge
+    const float EdgeX = -50.0f - FMath::Sqrt(Radius * Radius - 81.0f);
+    TestTrue(TEXT("Edge is hit"), Box.SweepSphere(FVector(-200.0f, 0.0f, 59.0f), FVector(400.0f, 0.0f, 0.0f), Radius, Alpha, Normal));
+    TestEqual(TEXT("Edge time of impact"), Alpha, (EdgeX + 200.0f) / 400.0f, AlphaTolerance);
+    TestTrue(TEXT("Edge normal"), Normal.Equals(FVector(EdgeX + 50.0f, 0.0f, 9.0f) / Radius, NormalTolerance));
+
+    TestFalse(TEXT("Grazing sphere misses"), Box.SweepSphere(FVector(-200.0f, 0.0f, 60.1f), FVector(400.0f, 0.0f, 0.0f), Radius, Alpha, Normal));
+
+    // corner: contact point is corner itself
+    const FVector Diagonal = FVector(1.0f).GetSafeNormal();
+    const float CornerCenter = 50.0f + Radius * Diagonal.X;
+    TestTrue(TEXT("Corner is hit"), Box.SweepSphere(FVector(150.0f), FVector(-300.0f), Radius, Alpha, Normal));
+    TestEqual(TEXT("Corner time of impact"), Alpha, (150.0f - CornerCenter) / 300.0f, AlphaTolerance);
+    TestTrue(TEXT("Corner normal"), Normal.Equals(Diagonal, NormalTolerance));
+
+    TestFalse(TEXT("Overlap at start is left to discrete detection"), Box.SweepSphere(FVector(-55.0f, 0.0f, 0.0f), FVector(400.0f, 0.0f, 0.0f), Radius, Alpha, Normal));
+
+    // high speed: thin plate is between discrete checks at both ends of the move
+    const FAnalyticCollisionShape Plate = MakeBox(FVector(500.0f, 500.0f, 1.0f));
+    const FVector Start = FVector(0.0f, 0.0f, 2500.0f);
+    const FVector Delta = FVector(0.0f, 0.0f, -5000.0f);
+    FVector Point;
+    TestTrue(TEXT("Plate is not touched at start and end"), Plate.GetClosestPoint(Start, Point) > Radius && Plate.GetClosestPoint(Start + Delta, Point) > Radius);
+    TestTrue(TEXT("Plate is hit at high speed"), Plate.SweepSphere(Start, Delta, Radius, Alpha, Normal));
+    TestEqual(TEXT("Plate time of impact"), Alpha, (2500.0f - 1.0f - Radius) / 5000.0f, AlphaTolerance);
+    TestTrue(TEXT("Plate normal"), Normal.Equals(FVector::UpVector, NormalTolerance));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSweepReferenceTest, "PhysicsCalculation.Collision.Sweep.Reference",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSweepReferenceTest::RunTest(const FString& Parameters)
+{
+    using namespace SweepTest;
+
+    // analytic sweeps against densely sampled reference over shapes, grazing, corners and high speed moves
+    const TArray<FPhysicsSweepAccuracy> Rows = FPhysicsAccuracyScenarios::MeasureSweepAccuracy(Radius, 5000.0f, 2000);
+    TestTrue(TEXT("Cases are measured"), Rows.Num() > 0);
+    for (const auto& Row : Rows)
+    {
+        AddInfo(FString::Printf(TEXT("%s: hit %d, reference hit %d, location error %f"), *Row.Name, Row.bHit, Row.bReferenceHit, Row.LocationError));
+        TestEqual(*FString::Printf(TEXT("%s hit matches reference"), *Row.Name), Row.bHit, Row.bReferenceHit);
+        TestTrue(*FString::Printf(TEXT("%s location matches reference"), *Row.Name), Row.LocationError < 0.05f);
+    }
+    return true;
+}
+
+#endif